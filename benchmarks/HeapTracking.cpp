@@ -0,0 +1,134 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "HeapTracking.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace llvm {
+
+namespace anderson {
+
+namespace benchmarks {
+
+namespace {
+
+std::atomic<int64_t> HeapUsage { 0 };
+std::atomic<int64_t> PeakHeapUsage { 0 };
+
+} // namespace <anonymous>
+
+#ifdef __GLIBC__
+
+namespace {
+
+void* Allocate(size_t size) noexcept {
+  auto block = std::malloc(size ? size : 1);
+  if (!block) {
+    return nullptr;
+  }
+
+  auto blockSize = static_cast<int64_t>(malloc_usable_size(block));
+  auto usage = HeapUsage.fetch_add(blockSize, std::memory_order_relaxed) + blockSize;
+  auto peak = PeakHeapUsage.load(std::memory_order_relaxed);
+  while (usage > peak && !PeakHeapUsage.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) { }
+  return block;
+}
+
+void Deallocate(void *block) noexcept {
+  if (!block) {
+    return;
+  }
+  HeapUsage.fetch_sub(static_cast<int64_t>(malloc_usable_size(block)), std::memory_order_relaxed);
+  std::free(block);
+}
+
+} // namespace <anonymous>
+
+bool IsHeapTracked() noexcept {
+  return true;
+}
+
+#else
+
+bool IsHeapTracked() noexcept {
+  return false;
+}
+
+#endif
+
+int64_t GetTrackedHeapUsage() noexcept {
+  return HeapUsage.load(std::memory_order_relaxed);
+}
+
+int64_t GetPeakHeapUsage() noexcept {
+  return PeakHeapUsage.load(std::memory_order_relaxed);
+}
+
+void ResetPeakHeapUsage() noexcept {
+  PeakHeapUsage.store(HeapUsage.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+} // namespace benchmarks
+
+} // namespace anderson
+
+} // namespace llvm
+
+#ifdef __GLIBC__
+
+// The over-aligned forms are left alone; they allocate and free their blocks among themselves.
+
+void* operator new(size_t size) {
+  auto block = llvm::anderson::benchmarks::Allocate(size);
+  if (!block) {
+    throw std::bad_alloc { };
+  }
+  return block;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t &) noexcept {
+  return llvm::anderson::benchmarks::Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return llvm::anderson::benchmarks::Allocate(size);
+}
+
+void operator delete(void *block) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+void operator delete[](void *block) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+void operator delete(void *block, size_t) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+void operator delete[](void *block, size_t) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+void operator delete(void *block, const std::nothrow_t &) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+void operator delete[](void *block, const std::nothrow_t &) noexcept {
+  llvm::anderson::benchmarks::Deallocate(block);
+}
+
+#endif
@@ -0,0 +1,53 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_BENCHMARKS_HEAP_TRACKING_H
+#define LLVM_ANDERSON_BENCHMARKS_HEAP_TRACKING_H
+
+#include <cstdint>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace benchmarks {
+
+/**
+ * Determine whether the heap usage of the benchmarks is tracked.
+ *
+ * The global `operator new` and `operator delete` of the benchmark binary are replaced by ones that count the usable
+ * size of every block, which needs `malloc_usable_size` and is thus only done with glibc. Memory allocated by `malloc`
+ * directly, e.g. by `llvm::SmallVector`, is not tracked.
+ *
+ * @return whether the heap usage is tracked.
+ */
+bool IsHeapTracked() noexcept;
+
+/**
+ * Get the number of bytes currently allocated through `operator new`.
+ *
+ * @return the number of bytes currently allocated through `operator new`, or 0 if the heap usage is not tracked.
+ */
+int64_t GetTrackedHeapUsage() noexcept;
+
+/**
+ * Get the largest number of bytes allocated through `operator new` at any time since the last call to
+ * `ResetPeakHeapUsage`.
+ *
+ * @return the peak heap usage, or 0 if the heap usage is not tracked.
+ */
+int64_t GetPeakHeapUsage() noexcept;
+
+/**
+ * Reset the peak heap usage to the current heap usage.
+ */
+void ResetPeakHeapUsage() noexcept;
+
+} // namespace benchmarks
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_BENCHMARKS_HEAP_TRACKING_H
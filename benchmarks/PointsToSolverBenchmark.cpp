@@ -0,0 +1,198 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Process.h>
+
+#include "HeapTracking.h"
+#include "PointsToSolver.h"
+#include "SyntheticModules.h"
+
+namespace {
+
+using llvm::anderson::benchmarks::GetPeakHeapUsage;
+using llvm::anderson::benchmarks::GetTrackedHeapUsage;
+using llvm::anderson::benchmarks::ModuleGenerator;
+using llvm::anderson::benchmarks::ResetPeakHeapUsage;
+
+int64_t GetHeapUsage() noexcept {
+  return static_cast<int64_t>(llvm::sys::Process::GetMallocUsage());
+}
+
+void SetHeapCounter(benchmark::State &state, int64_t heapDelta) noexcept {
+  state.counters["heap"] = benchmark::Counter(
+      static_cast<double>(heapDelta), benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024);
+}
+
+/**
+ * Report the largest growth of the tracked heap usage within the timed region of any iteration.
+ */
+void SetPeakHeapCounter(benchmark::State &state, int64_t peakHeap) noexcept {
+  if (llvm::anderson::benchmarks::IsHeapTracked()) {
+    state.counters["peak_heap"] = benchmark::Counter(
+        static_cast<double>(peakHeap), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+  }
+}
+
+/**
+ * Create a solver with the constraints of every instruction in the specified module. `PointsToSolver::Solve` adds the
+ * trivial pointer assignments itself, so that they are timed as part of solving.
+ */
+std::unique_ptr<llvm::anderson::PointsToSolver> CreateSolver(const llvm::Module &module) noexcept {
+  auto solver = std::make_unique<llvm::anderson::PointsToSolver>(
+      module, std::make_unique<llvm::anderson::ValueTree>(module));
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        llvm::anderson::UpdateAndersonSolverOnInst(*solver, inst);
+      }
+    }
+  }
+  return solver;
+}
+
+size_t CountPointsToFacts(llvm::anderson::ValueTree &valueTree) noexcept {
+  size_t numPointsToFacts = 0;
+  valueTree.Visit([&numPointsToFacts](llvm::anderson::ValueTreeNode &node) noexcept -> bool {
+    if (node.isPointer()) {
+      numPointsToFacts += node.pointer()->GetPointeeSet().size();
+    }
+    return true;
+  });
+  return numPointsToFacts;
+}
+
+void BM_ValueTree(benchmark::State &state, ModuleGenerator generator) {
+  llvm::LLVMContext context;
+  auto module = generator(context, static_cast<size_t>(state.range(0)));
+
+  size_t numPointers = 0;
+  int64_t heapDelta = 0;
+  int64_t peakHeap = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto heap = GetHeapUsage();
+    auto trackedHeap = GetTrackedHeapUsage();
+    ResetPeakHeapUsage();
+    state.ResumeTiming();
+
+    auto valueTree = std::make_unique<llvm::anderson::ValueTree>(*module);
+
+    // Only the construction is timed, not the teardown.
+    state.PauseTiming();
+    heapDelta += GetHeapUsage() - heap;
+    peakHeap = std::max(peakHeap, GetPeakHeapUsage() - trackedHeap);
+    numPointers = valueTree->GetNumPointers();
+    valueTree.reset();
+    state.ResumeTiming();
+  }
+
+  state.counters["pointers"] = static_cast<double>(numPointers);
+  SetHeapCounter(state, heapDelta);
+  SetPeakHeapCounter(state, peakHeap);
+}
+
+void BM_Constraints(benchmark::State &state, ModuleGenerator generator) {
+  llvm::LLVMContext context;
+  auto module = generator(context, static_cast<size_t>(state.range(0)));
+
+  int64_t heapDelta = 0;
+  int64_t peakHeap = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto solver = std::make_unique<llvm::anderson::PointsToSolver>(
+        *module, std::make_unique<llvm::anderson::ValueTree>(*module));
+    auto heap = GetHeapUsage();
+    auto trackedHeap = GetTrackedHeapUsage();
+    ResetPeakHeapUsage();
+    state.ResumeTiming();
+
+    solver->AddTrivialPointerAssignments();
+    for (const auto &function : *module) {
+      for (const auto &bb : function) {
+        for (const auto &inst : bb) {
+          llvm::anderson::UpdateAndersonSolverOnInst(*solver, inst);
+        }
+      }
+    }
+
+    state.PauseTiming();
+    heapDelta += GetHeapUsage() - heap;
+    peakHeap = std::max(peakHeap, GetPeakHeapUsage() - trackedHeap);
+    solver.reset();
+    state.ResumeTiming();
+  }
+
+  SetHeapCounter(state, heapDelta);
+  SetPeakHeapCounter(state, peakHeap);
+}
+
+void BM_Solve(benchmark::State &state, ModuleGenerator generator, llvm::anderson::SolverMode mode,
+              llvm::anderson::WorklistOrder order) {
+  llvm::LLVMContext context;
+  auto module = generator(context, static_cast<size_t>(state.range(0)));
+
+  size_t numPointsToFacts = 0;
+  int64_t heapDelta = 0;
+  int64_t peakHeap = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto solver = CreateSolver(*module);
+    solver->SetWorklistOrder(order);
+    auto heap = GetHeapUsage();
+    auto trackedHeap = GetTrackedHeapUsage();
+    ResetPeakHeapUsage();
+    state.ResumeTiming();
+
+    solver->Solve(mode);
+
+    state.PauseTiming();
+    heapDelta += GetHeapUsage() - heap;
+    peakHeap = std::max(peakHeap, GetPeakHeapUsage() - trackedHeap);
+    numPointsToFacts = CountPointsToFacts(*solver->GetValueTree());
+    solver.reset();
+    state.ResumeTiming();
+  }
+
+  state.counters["facts"] = static_cast<double>(numPointsToFacts);
+  SetHeapCounter(state, heapDelta);
+  SetPeakHeapCounter(state, peakHeap);
+}
+
+// The exhaustive solver has no worklist, so its order is ignored.
+#define ANDERSON_BENCHMARK_SOLVE(name, generator, maxSize, mode, order)                                                \
+  BENCHMARK_CAPTURE(BM_Solve, name, generator, llvm::anderson::SolverMode::mode, llvm::anderson::WorklistOrder::order) \
+      ->RangeMultiplier(4)->Range(16, maxSize)->Unit(benchmark::kMillisecond)
+
+// Sizes are chosen so that the largest instance of every shape takes about a second to solve.
+#define ANDERSON_BENCHMARK_SHAPE(shape, generator, maxSize)                                                            \
+  BENCHMARK_CAPTURE(BM_ValueTree, shape, generator)->RangeMultiplier(4)->Range(16, maxSize);                           \
+  BENCHMARK_CAPTURE(BM_Constraints, shape, generator)->RangeMultiplier(4)->Range(16, maxSize);                         \
+  ANDERSON_BENCHMARK_SOLVE(shape##_exhaustive, generator, maxSize, Exhaustive, Fifo);                                  \
+  ANDERSON_BENCHMARK_SOLVE(shape##_worklist_fifo, generator, maxSize, Worklist, Fifo);                                 \
+  ANDERSON_BENCHMARK_SOLVE(shape##_worklist_lifo, generator, maxSize, Worklist, Lifo);                                 \
+  ANDERSON_BENCHMARK_SOLVE(shape##_worklist_lrf, generator, maxSize, Worklist, Lrf);                                   \
+  ANDERSON_BENCHMARK_SOLVE(shape##_worklist_topo, generator, maxSize, Worklist, Topological);                          \
+  ANDERSON_BENCHMARK_SOLVE(shape##_worklist_two_phase, generator, maxSize, Worklist, TwoPhase);                        \
+  ANDERSON_BENCHMARK_SOLVE(shape##_partitioned, generator, maxSize, Partitioned, Fifo)
+
+ANDERSON_BENCHMARK_SHAPE(copy_chain, llvm::anderson::benchmarks::GenerateCopyChain, 1024);
+ANDERSON_BENCHMARK_SHAPE(copy_cycle, llvm::anderson::benchmarks::GenerateCopyCycle, 256);
+ANDERSON_BENCHMARK_SHAPE(deep_struct, llvm::anderson::benchmarks::GenerateDeepStruct, 256);
+ANDERSON_BENCHMARK_SHAPE(dynamic_array, llvm::anderson::benchmarks::GenerateDynamicArray, 256);
+ANDERSON_BENCHMARK_SHAPE(load_store_web, llvm::anderson::benchmarks::GenerateLoadStoreWeb, 256);
+ANDERSON_BENCHMARK_SHAPE(type_punning, llvm::anderson::benchmarks::GenerateTypePunning, 1024);
+
+} // namespace <anonymous>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,227 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "SyntheticModules.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace benchmarks {
+
+namespace {
+
+/**
+ * Deterministic pseudo-random number generator, so that every run benchmarks the same module.
+ */
+class Random {
+public:
+  explicit Random(uint64_t seed) noexcept
+    : _state(seed)
+  { }
+
+  size_t Next(size_t bound) noexcept {
+    _state = _state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<size_t>(_state >> 33) % bound;
+  }
+
+private:
+  uint64_t _state;
+};
+
+/**
+ * Create a module with a single function `void @f(i64 %idx)` and return its entry block.
+ */
+llvm::BasicBlock* CreateFunction(llvm::Module &module) noexcept {
+  auto &context = module.getContext();
+  auto functionType = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(context), { llvm::Type::getInt64Ty(context) }, false);
+  auto function = llvm::Function::Create(functionType, llvm::GlobalValue::ExternalLinkage, "f", module);
+  function->getArg(0)->setName("idx");
+  return llvm::BasicBlock::Create(context, "entry", function);
+}
+
+std::vector<llvm::Value *> CreateObjects(llvm::IRBuilder<> &builder, size_t count) noexcept {
+  std::vector<llvm::Value *> objects;
+  objects.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    objects.push_back(builder.CreateAlloca(builder.getInt32Ty()));
+  }
+  return objects;
+}
+
+} // namespace <anonymous>
+
+std::unique_ptr<llvm::Module> GenerateCopyChain(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("copy_chain", context);
+  llvm::IRBuilder<> builder { CreateFunction(*module) };
+
+  llvm::Type *types[2] = { builder.getInt8PtrTy(), builder.getInt32Ty()->getPointerTo() };
+  llvm::Value *pointer = builder.CreateAlloca(builder.getInt32Ty());
+  for (size_t i = 0; i < size; ++i) {
+    // Create the casts directly, since the builder folds casts to the same type.
+    pointer = builder.Insert(new llvm::BitCastInst(pointer, types[i % 2]));
+  }
+
+  builder.CreateRetVoid();
+  return module;
+}
+
+std::unique_ptr<llvm::Module> GenerateCopyCycle(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("copy_cycle", context);
+  auto entry = CreateFunction(*module);
+  auto function = entry->getParent();
+  auto loop = llvm::BasicBlock::Create(context, "loop", function);
+  auto exit = llvm::BasicBlock::Create(context, "exit", function);
+
+  llvm::IRBuilder<> builder { entry };
+  auto objects = CreateObjects(builder, size);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(loop);
+  std::vector<llvm::PHINode *> phis;
+  phis.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    phis.push_back(builder.CreatePHI(builder.getInt32Ty()->getPointerTo(), 2));
+  }
+  for (size_t i = 0; i < size; ++i) {
+    phis[i]->addIncoming(objects[i], entry);
+    phis[i]->addIncoming(phis[(i + 1) % size], loop);
+  }
+  auto done = builder.CreateICmpEQ(function->getArg(0), builder.getInt64(0));
+  builder.CreateCondBr(done, exit, loop);
+
+  builder.SetInsertPoint(exit);
+  builder.CreateRetVoid();
+  return module;
+}
+
+std::unique_ptr<llvm::Module> GenerateDeepStruct(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("deep_struct", context);
+  llvm::IRBuilder<> builder { CreateFunction(*module) };
+
+  // S0 = { i32* }, Sd = { i32*, S(d-1) }
+  auto pointerType = builder.getInt32Ty()->getPointerTo();
+  llvm::Type *structType = llvm::StructType::get(pointerType);
+  for (size_t depth = 1; depth < size; ++depth) {
+    structType = llvm::StructType::get(pointerType, structType);
+  }
+
+  auto root = builder.CreateAlloca(structType);
+  auto objects = CreateObjects(builder, size);
+
+  std::vector<llvm::Value *> indices { builder.getInt32(0) };
+  for (size_t depth = 0; depth < size; ++depth) {
+    indices.push_back(builder.getInt32(0));
+    auto field = builder.CreateGEP(structType, root, indices);
+    builder.CreateStore(objects[depth], field);
+    builder.CreateLoad(pointerType, field);
+    indices.back() = builder.getInt32(1);
+  }
+
+  builder.CreateRetVoid();
+  return module;
+}
+
+std::unique_ptr<llvm::Module> GenerateDynamicArray(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("dynamic_array", context);
+  auto entry = CreateFunction(*module);
+  auto index = entry->getParent()->getArg(0);
+  llvm::IRBuilder<> builder { entry };
+
+  auto pointerType = builder.getInt32Ty()->getPointerTo();
+  auto arrayType = llvm::ArrayType::get(pointerType, size);
+  auto array = builder.CreateAlloca(arrayType);
+  auto objects = CreateObjects(builder, size);
+
+  // Half of the stores use constant indices and the other half use the dynamic index.
+  for (size_t i = 0; i < size; ++i) {
+    auto elementIndex = i % 2 ? static_cast<llvm::Value *>(index) : builder.getInt64(i);
+    auto element = builder.CreateGEP(arrayType, array, { builder.getInt64(0), elementIndex });
+    builder.CreateStore(objects[i], element);
+  }
+  for (size_t i = 0; i < std::max<size_t>(size / 4, 1); ++i) {
+    auto element = builder.CreateGEP(arrayType, array, { builder.getInt64(0), index });
+    builder.CreateLoad(pointerType, element);
+  }
+
+  builder.CreateRetVoid();
+  return module;
+}
+
+std::unique_ptr<llvm::Module> GenerateLoadStoreWeb(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("load_store_web", context);
+  llvm::IRBuilder<> builder { CreateFunction(*module) };
+  Random random { size };
+
+  auto pointerType = builder.getInt32Ty()->getPointerTo();
+  auto objects = CreateObjects(builder, size);
+  std::vector<llvm::Value *> slots;
+  std::vector<llvm::Value *> slotPointers;
+  for (size_t i = 0; i < size; ++i) {
+    slots.push_back(builder.CreateAlloca(pointerType));
+    slotPointers.push_back(builder.CreateAlloca(pointerType->getPointerTo()));
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    // Seed the slots with objects, and the pointers to slots with slots.
+    builder.CreateStore(objects[random.Next(size)], slots[i]);
+    builder.CreateStore(slots[random.Next(size)], slotPointers[i]);
+  }
+  for (size_t i = 0; i < 2 * size; ++i) {
+    // Copy pointers between slots through memory.
+    auto value = builder.CreateLoad(pointerType, slots[random.Next(size)]);
+    builder.CreateStore(value, slots[random.Next(size)]);
+
+    // Store through and load through a slot found in memory.
+    auto slot = builder.CreateLoad(pointerType->getPointerTo(), slotPointers[random.Next(size)]);
+    builder.CreateStore(objects[random.Next(size)], slot);
+    auto indirectValue = builder.CreateLoad(pointerType, slot);
+    builder.CreateStore(indirectValue, slots[random.Next(size)]);
+  }
+
+  builder.CreateRetVoid();
+  return module;
+}
+
+std::unique_ptr<llvm::Module> GenerateTypePunning(llvm::LLVMContext &context, size_t size) noexcept {
+  auto module = std::make_unique<llvm::Module>("type_punning", context);
+  llvm::IRBuilder<> builder { CreateFunction(*module) };
+
+  auto pointerType = builder.getInt8PtrTy();
+  llvm::Type *cellTypes[3] = {
+    builder.getInt64Ty(),
+    llvm::StructType::get(context, { pointerType, builder.getInt32Ty() }),
+    llvm::StructType::get(context, { builder.getInt32Ty(), pointerType }),
+  };
+  auto objects = CreateObjects(builder, size);
+  auto sink = builder.CreateAlloca(pointerType);
+
+  for (size_t i = 0; i < size; ++i) {
+    auto cell = builder.CreateAlloca(cellTypes[i % 3]);
+    auto slot = builder.CreateBitCast(cell, pointerType->getPointerTo());
+    builder.CreateStore(builder.CreateBitCast(objects[i], pointerType), slot);
+    auto value = builder.CreateLoad(pointerType, slot);
+    builder.CreateStore(value, sink);
+  }
+
+  builder.CreateRetVoid();
+  return module;
+}
+
+} // namespace benchmarks
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,66 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_BENCHMARKS_SYNTHETIC_MODULES_H
+#define LLVM_ANDERSON_BENCHMARKS_SYNTHETIC_MODULES_H
+
+#include <cstddef>
+#include <memory>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace benchmarks {
+
+/**
+ * Signature of the synthetic module generators. Each generator builds a single function whose constraint graph has a
+ * particular shape, scaled by the specified size.
+ */
+using ModuleGenerator = std::unique_ptr<llvm::Module> (*)(llvm::LLVMContext &context, size_t size);
+
+/**
+ * Generate a chain of `size` pointer copies starting from a single `alloca`.
+ */
+std::unique_ptr<llvm::Module> GenerateCopyChain(llvm::LLVMContext &context, size_t size) noexcept;
+
+/**
+ * Generate a cycle of `size` `phi` nodes, each of which also receives the address of its own `alloca`, so that all
+ * pointers in the cycle end up pointing to all `size` objects.
+ */
+std::unique_ptr<llvm::Module> GenerateCopyCycle(llvm::LLVMContext &context, size_t size) noexcept;
+
+/**
+ * Generate a struct nested `size` levels deep, with a pointer field at every level that is stored to and loaded from
+ * through a chain of `getelementptr` instructions.
+ */
+std::unique_ptr<llvm::Module> GenerateDeepStruct(llvm::LLVMContext &context, size_t size) noexcept;
+
+/**
+ * Generate an array of `size` pointers, which is written and read through `getelementptr` instructions with dynamic
+ * indices.
+ */
+std::unique_ptr<llvm::Module> GenerateDynamicArray(llvm::LLVMContext &context, size_t size) noexcept;
+
+/**
+ * Generate `size` pointer slots connected by pseudo-random loads and stores, with a few stores and loads per slot.
+ */
+std::unique_ptr<llvm::Module> GenerateLoadStoreWeb(llvm::LLVMContext &context, size_t size) noexcept;
+
+/**
+ * Generate `size` memory cells of integer and struct types, each of which is cast to `i8**`, stored to and loaded from.
+ * Cells that start with an integer cannot hold the stored pointer.
+ */
+std::unique_ptr<llvm::Module> GenerateTypePunning(llvm::LLVMContext &context, size_t size) noexcept;
+
+} // namespace benchmarks
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_BENCHMARKS_SYNTHETIC_MODULES_H
@@ -0,0 +1,146 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_ALIAS_ANALYSIS_H
+#define LLVM_ANDERSON_ALIAS_ANALYSIS_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <memory>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/BitVector.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/MemoryLocation.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Alias analysis result that answers queries from the solved points-to relation.
+ *
+ * The points-to set of every pointer value is reduced to the set of memory objects, i.e. the roots of the value trees
+ * of stack, global and argument memory, that it may point into. Identical object sets share a single set ID, so the
+ * common queries are answered by comparing set IDs or by a cached intersection of two sparse bit sets over the dense
+ * object IDs.
+ *
+ * A pointer whose points-to set is empty, e.g. because it is produced by an instruction that the analysis does not
+ * model, is treated as pointing to anything, and the query is deferred to the next alias analysis.
+ *
+ * All object sets are computed when the result is constructed, so the result does not refer to the value tree it has
+ * been built from. Pointer values that are deleted afterwards are forgotten, and pointer values created afterwards are
+ * unknown to the result.
+ */
+class AndersonAAResult : public llvm::AAResultBase<AndersonAAResult> {
+public:
+  /**
+   * Construct a new AndersonAAResult object.
+   *
+   * @param module the analyzed module.
+   * @param valueTree the solved value tree of the module.
+   */
+  explicit AndersonAAResult(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  AndersonAAResult(AndersonAAResult &&) noexcept;
+
+  ~AndersonAAResult() noexcept;
+
+  /**
+   * Determine whether this result should be invalidated after a pass has been run on the module.
+   *
+   * Semantics-preserving transformations never add new flows of pointers between the values that exist before them,
+   * and the result neither refers to the value tree nor answers queries on the values created by the transformations,
+   * so the result stays valid until it is explicitly abandoned, e.g. with `invalidate<anderson-aa>`.
+   *
+   * @param module the module.
+   * @param preserved the analyses preserved by the pass.
+   * @param invalidator the invalidator of the analysis manager.
+   * @return whether this result should be invalidated.
+   */
+  bool invalidate(llvm::Module &module, const llvm::PreservedAnalyses &preserved,
+                  llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept;
+
+  /**
+   * Determine whether two memory locations may alias.
+   *
+   * Two locations do not alias if the objects their pointers may point into are disjoint.
+   */
+  llvm::AliasResult alias(const llvm::MemoryLocation &locA, const llvm::MemoryLocation &locB,
+                          llvm::AAQueryInfo &queryInfo) noexcept;
+
+  using llvm::AAResultBase<AndersonAAResult>::getModRefInfo;
+
+  /**
+   * Determine whether a call may read or write a memory location.
+   *
+   * A call cannot access a stack object of its caller that is not reachable from the arguments of the call, from global
+   * memory, or from memory passed in by the callers of any function.
+   */
+  llvm::ModRefInfo getModRefInfo(const llvm::CallBase *call, const llvm::MemoryLocation &loc,
+                                 llvm::AAQueryInfo &queryInfo) noexcept;
+
+  /**
+   * Compute whether each pair of the specified pointers may alias, in a single pass over their object sets.
+   *
+   * Only this analysis is consulted, so pointers unknown to it may alias every other pointer.
+   *
+   * @param pointers the pointer values.
+   * @return a bit matrix with one row per pointer, in which bit `j` of row `i` is set if `pointers[i]` and `pointers[j]`
+   * may alias. The matrix is symmetric and its diagonal is set.
+   */
+  std::vector<llvm::BitVector> GetAliasMatrix(llvm::ArrayRef<const llvm::Value *> pointers) noexcept;
+
+  /**
+   * Partition the specified pointers into alias classes, such that pointers in different classes never alias.
+   *
+   * Each class is the transitive closure of the may-alias relation, so two pointers in the same class do not
+   * necessarily alias each other.
+   *
+   * @param pointers the pointer values.
+   * @return the class number of each pointer. Classes are numbered from 0 in the order of their first pointers.
+   */
+  std::vector<unsigned> GetAliasClasses(llvm::ArrayRef<const llvm::Value *> pointers) noexcept;
+
+private:
+  class ObjectSets;
+
+  std::unique_ptr<ObjectSets> _objectSets;
+};
+
+/**
+ * Alias analysis of the new pass manager backed by `AndersonAnalysis`.
+ *
+ * The pass plugin registers the analysis as `anderson-aa`, both as a module analysis and as an alias analysis that can
+ * be added to `AAManager` with `-aa-pipeline`. Like other module-level alias analyses, the result is only visible to
+ * function passes once it has been computed, e.g. with `require<anderson-aa>`.
+ */
+class AndersonAA : public llvm::AnalysisInfoMixin<AndersonAA> {
+public:
+  using Result = AndersonAAResult;
+
+  /**
+   * Run the analysis on the specified module.
+   *
+   * @param module the module.
+   * @param moduleAnalysisManager the module analysis manager.
+   * @return the analysis result.
+   */
+  Result run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  friend llvm::AnalysisInfoMixin<AndersonAA>;
+
+  static llvm::AnalysisKey Key;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_ALIAS_ANALYSIS_H
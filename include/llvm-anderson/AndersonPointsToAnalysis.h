@@ -8,9 +8,12 @@
 #ifndef LLVM_ANDERSON_POINTS_TO_ANALYSIS_H
 #define LLVM_ANDERSON_POINTS_TO_ANALYSIS_H
 
+#include "llvm-anderson/SolverProgress.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -19,16 +22,19 @@
 #include <utility>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/iterator_range.h>
 #include <llvm/IR/Argument.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 #include <llvm/Pass.h>
 #include <llvm/Support/Casting.h>
+#include <llvm/Support/raw_ostream.h>
 
 #define NON_COPIABLE_NON_MOVABLE(className)             \
   className(const className &) = delete;                \
@@ -54,6 +60,8 @@ struct PolymorphicHasher {
 class Pointee;
 class Pointer;
 class ValueTreeNode;
+class ValueTree;
+class ExternalSummaries;
 
 /**
  * Different kinds of pointer assignment statements.
@@ -81,6 +89,12 @@ enum class PointerAssignmentKind {
    * Pointer assignment statement of the form `*p = q`.
    */
   PointeeAssigned,
+
+  /**
+   * Pointer assignment statement of the form `*p = *q`, which copies every pointer held by the pointee of `q` into the
+   * pointee of `p`, e.g. a `memcpy`.
+   */
+  PointeeAssignedPointee,
 };
 
 /**
@@ -168,7 +182,8 @@ public:
   static bool classof(const PointerAssignment *obj) noexcept {
     return obj->kind() == PointerAssignmentKind::AssignedElementPtr ||
       obj->kind() == PointerAssignmentKind::AssignedPointee ||
-      obj->kind() == PointerAssignmentKind::PointeeAssigned;
+      obj->kind() == PointerAssignmentKind::PointeeAssigned ||
+      obj->kind() == PointerAssignmentKind::PointeeAssignedPointee;
   }
 
   /**
@@ -358,6 +373,25 @@ public:
   { }
 };
 
+/**
+ * Represent a pointer assignment statement of the form `*p = *q`.
+ */
+class PointeeAssignedPointee : public PointerAssignedPointerBase {
+public:
+  static bool classof(const PointerAssignment *obj) noexcept {
+    return obj->kind() == PointerAssignmentKind::PointeeAssignedPointee;
+  }
+
+  /**
+   * Construct a new PointeeAssignedPointee object.
+   *
+   * @param pointer the pointer operand on the right hand side of the pointer assignment statement.
+   */
+  explicit PointeeAssignedPointee(Pointer *pointer) noexcept
+    : PointerAssignedPointerBase { PointerAssignmentKind::PointeeAssignedPointee, pointer }
+  { }
+};
+
 /**
  * A set of GetPointeeSet.
  */
@@ -526,6 +560,13 @@ public:
     return _pointees.insert(pointee).second;
   }
 
+  /**
+   * Remove all elements from this set.
+   */
+  void clear() noexcept {
+    _pointees.clear();
+  }
+
   /**
    * Get the iterator to the specified element.
    *
@@ -710,7 +751,9 @@ public:
       _assignedElementPtr(),
       _assignedPointee(),
       _pointeeAssigned(),
-      _pointees()
+      _pointeeCopied(),
+      _pointees(),
+      _unknown(false)
   { }
 
   NON_COPIABLE_NON_MOVABLE(Pointer)
@@ -771,6 +814,17 @@ public:
     return _pointeeAssigned.emplace(pointer).second;
   }
 
+  /**
+   * Specify that the pointee of the specified pointer is copied into the pointee of this pointer.
+   *
+   * @param pointer the pointer on the right hand side of the pointer assignment.
+   * @return whether the specified constraint is fresh and has been added to the constraints list.
+   */
+  bool PointeeCopied(Pointer *pointer) noexcept {
+    assert(pointer && "pointer cannot be null");
+    return _pointeeCopied.emplace(pointer).second;
+  }
+
   /**
    * Get the pointee set of this pointer.
    *
@@ -789,6 +843,38 @@ public:
     return _pointees;
   }
 
+  /**
+   * Determine whether the pointee set of this pointer may be incomplete because the solver ran out of its budget.
+   *
+   * An unknown pointer may point to any memory object. Its pointee set only holds the pointees found before the solver
+   * gave up.
+   *
+   * @return whether this pointer is unknown.
+   */
+  bool isUnknown() const noexcept {
+    return _unknown;
+  }
+
+  /**
+   * Mark this pointer as unknown.
+   */
+  void MarkUnknown() noexcept {
+    _unknown = true;
+  }
+
+  /**
+   * Remove all constraints on this pointer and clear its pointee set.
+   */
+  void Reset() noexcept {
+    _assignedAddressOf.clear();
+    _assignedElementPtr.clear();
+    _assignedPointee.clear();
+    _pointeeAssigned.clear();
+    _pointeeCopied.clear();
+    _pointees.clear();
+    _unknown = false;
+  }
+
   /**
    * Get the number of PointerAssignedAddressOf constraints on this pointer.
    *
@@ -897,12 +983,41 @@ public:
     return llvm::iterator_range<decltype(_pointeeAssigned)::const_iterator> { _pointeeAssigned };
   }
 
+  /**
+   * Get the number of PointeeAssignedPointee constraints on this pointer.
+   *
+   * @return the number of PointeeAssignedPointee constraints on this pointer.
+   */
+  size_t GetNumPointeeCopied() const noexcept {
+    return _pointeeCopied.size();
+  }
+
+  /**
+   * Get an iterator range over all PointeeAssignedPointee constraints on this pointer.
+   *
+   * @return an iterator range over all PointeeAssignedPointee constraints on this pointer.
+   */
+  auto pointee_copied() noexcept {
+    return llvm::iterator_range<decltype(_pointeeCopied)::iterator> { _pointeeCopied };
+  }
+
+  /**
+   * Get an iterator range over all PointeeAssignedPointee constraints on this pointer.
+   *
+   * @return an iterator range over all PointeeAssignedPointee constraints on this pointer.
+   */
+  auto pointee_copied() const noexcept {
+    return llvm::iterator_range<decltype(_pointeeCopied)::const_iterator> { _pointeeCopied };
+  }
+
 private:
   std::unordered_set<PointerAssignedAddressOf, details::PolymorphicHasher<PointerAssignedAddressOf>> _assignedAddressOf;
   std::unordered_set<PointerAssignedElementPtr, details::PolymorphicHasher<PointerAssignedElementPtr>> _assignedElementPtr;
   std::unordered_set<PointerAssignedPointee, details::PolymorphicHasher<PointerAssignedPointee>> _assignedPointee;
   std::unordered_set<PointeeAssignedPointer, details::PolymorphicHasher<PointeeAssignedPointer>> _pointeeAssigned;
+  std::unordered_set<PointeeAssignedPointee, details::PolymorphicHasher<PointeeAssignedPointee>> _pointeeCopied;
   PointeeSet _pointees;
+  bool _unknown;
 };
 
 /**
@@ -934,6 +1049,11 @@ enum class ValueKind {
    * Function return values.
    */
   FunctionReturnValue,
+
+  /**
+   * Values that are allocated in heap memory by a call to an external function summarized as returning a new object.
+   */
+  HeapMemory,
 };
 
 /**
@@ -959,11 +1079,22 @@ struct ArgumentMemoryValueTag { };
  */
 struct FunctionReturnValueTag { };
 
+/**
+ * A tag type that distinguishes the
+ * `ValueTreeNode::ValueTreeNode(HeapMemoryValueTag, const llvm::CallInst *, const llvm::Type *)` constructor.
+ */
+struct HeapMemoryValueTag { };
+
 /**
  * A node in the value tree.
  */
 class ValueTreeNode {
 public:
+  /**
+   * A reserved node ID value for nodes that have not been registered into a value tree.
+   */
+  constexpr static const size_t InvalidId = static_cast<size_t>(-1);
+
   /**
    * Construct a new ValueTreeNode object that represents the specified value.
    *
@@ -1002,6 +1133,14 @@ public:
    */
   explicit ValueTreeNode(FunctionReturnValueTag, const llvm::Function *function) noexcept;
 
+  /**
+   * Construct a new ValueTreeNode object that represents the value in the heap memory allocated by the specified call.
+   *
+   * @param heapMemoryAllocator the call that allocates the heap memory.
+   * @param type type of the allocated value.
+   */
+  explicit ValueTreeNode(HeapMemoryValueTag, const llvm::CallInst *heapMemoryAllocator, const llvm::Type *type) noexcept;
+
   /**
    * Construct a new ValueTreeNode object that represents the sub-object of the specified parent value.
    *
@@ -1011,8 +1150,29 @@ public:
    */
   explicit ValueTreeNode(const llvm::Type *type, ValueTreeNode *parent, size_t offset) noexcept;
 
+  /**
+   * Construct a new ValueTreeNode object that represents a root value of the specified kind and type, which does not
+   * correspond to any `llvm::Value` object, e.g. a value restored from a constraint summary.
+   *
+   * @param kind kind of the value.
+   * @param type type of the value.
+   */
+  explicit ValueTreeNode(ValueKind kind, const llvm::Type *type) noexcept;
+
   NON_COPIABLE_NON_MOVABLE(ValueTreeNode)
 
+  /**
+   * Get the ID of this node.
+   *
+   * Node IDs are dense and are assigned by the value tree in a deterministic pre-order, so the same module always
+   * produces the same node IDs.
+   *
+   * @return the ID of this node. If this node has not been registered into a value tree, returns `InvalidId`.
+   */
+  size_t id() const noexcept {
+    return _id;
+  }
+
   /**
    * Get the type of this value.
    *
@@ -1026,7 +1186,7 @@ public:
    * Get the value represented by this node as `llvm::Value` object.
    *
    * @return the value represented by this node as `llvm::Value` object. If this node represents a sub-object of some
-   * parent value, return nullptr.
+   * parent value, or this node is a detached root, return nullptr.
    */
   const llvm::Value *value() const noexcept {
     return _value;
@@ -1087,6 +1247,15 @@ public:
     return _kind == ValueKind::FunctionReturnValue;
   }
 
+  /**
+   * Determine whether this value is within a region of heap allocated memory.
+   *
+   * @return whether this value is within a region of heap allocated memory.
+   */
+  bool isHeapMemory() const noexcept {
+    return _kind == ValueKind::HeapMemory;
+  }
+
   /**
    * Get the parent node of this node.
    *
@@ -1134,6 +1303,9 @@ public:
     if (_parent) {
       return _parent->isGlobal();
     }
+    if (!_value) {
+      return _kind == ValueKind::GlobalMemory;
+    }
     return llvm::isa<llvm::GlobalObject>(_value);
   }
 
@@ -1149,7 +1321,7 @@ public:
 
     if (_kind == ValueKind::ArgumentMemory) {
       return true;
-    } else if (_kind == ValueKind::GlobalMemory) {
+    } else if (_kind == ValueKind::GlobalMemory && _value) {
       auto globalObject = llvm::cast<llvm::GlobalObject>(_value);
       return llvm::GlobalValue::isAvailableExternallyLinkage(globalObject->getLinkage());
     }
@@ -1233,6 +1405,20 @@ public:
     return llvm::cast<llvm::Function>(_value);
   }
 
+  /**
+   * Get the call that allocates this heap memory region.
+   *
+   * This function triggers an assertion failure if the value represented by this ValueTreeNode is not a heap memory.
+   *
+   * @return the call that allocates this heap memory region.
+   */
+  const llvm::CallInst* GetHeapMemoryAllocator() const noexcept {
+    if (!isRoot()) {
+      return _parent->GetHeapMemoryAllocator();
+    }
+    return llvm::cast<llvm::CallInst>(_value);
+  }
+
   /**
    * Determine whether this node has any child nodes.
    *
@@ -1321,6 +1507,9 @@ public:
   }
 
 private:
+  friend class ValueTree;
+
+  size_t _id;
   const llvm::Type *_type;
   const llvm::Value *_value;
   ValueKind _kind;
@@ -1358,8 +1547,21 @@ public:
    * This constructor builds all possible value trees for each rooted value in the specified module.
    *
    * @param module the LLVM module.
+   * @param reachable the global variables and functions to build value trees for, or nullptr to build value trees for
+   * all of them. Values of the others, and of their instructions, have no value tree node.
+   * @param summaries the summaries of the external functions called by the module, or nullptr. Calls to functions
+   * summarized as returning a new object get a heap memory value tree. The summaries must outlive the value tree.
    */
-  explicit ValueTree(const llvm::Module &module) noexcept;
+  explicit ValueTree(const llvm::Module &module,
+                     const std::unordered_set<const llvm::GlobalValue *> *reachable = nullptr,
+                     const ExternalSummaries *summaries = nullptr) noexcept;
+
+  /**
+   * Construct a new ValueTree object that is not bound to any module.
+   *
+   * Roots of the value tree are added by `AddDetachedRoot`.
+   */
+  explicit ValueTree() noexcept;
 
   /**
    * Get the number of pointees contained in the value tree.
@@ -1379,6 +1581,187 @@ public:
     return _numPointers;
   }
 
+  /**
+   * Get the number of node IDs allocated by the value tree.
+   *
+   * This equals to the number of nodes contained in the value tree unless some functions have been removed from the
+   * value tree by `RemoveFunction`.
+   *
+   * @return the number of node IDs allocated by the value tree.
+   */
+  size_t GetNumNodes() const noexcept {
+    return _nodes.size();
+  }
+
+  /**
+   * Get the node with the specified ID.
+   *
+   * If the ID is out of range, this function triggers an assertion failure.
+   *
+   * @param id the node ID.
+   * @return the node with the specified ID. If the node has been removed from the value tree, return nullptr.
+   */
+  ValueTreeNode* GetNode(size_t id) noexcept {
+    assert(id < _nodes.size() && "id is out of range");
+    return _nodes[id];
+  }
+
+  /**
+   * Get the node with the specified ID.
+   *
+   * If the ID is out of range, this function triggers an assertion failure.
+   *
+   * @param id the node ID.
+   * @return the node with the specified ID.
+   */
+  const ValueTreeNode* GetNode(size_t id) const noexcept {
+    return const_cast<ValueTree *>(this)->GetNode(id);
+  }
+
+  /**
+   * Build value trees for all rooted values defined by the specified function, including its arguments, instructions,
+   * return value, and the memory they refer to.
+   *
+   * @param function the function.
+   */
+  void AddFunction(const llvm::Function &function) noexcept;
+
+  /**
+   * Build value trees for the instructions of the specified function, whose body has been materialized after the
+   * function was added to the value tree.
+   *
+   * @param function the function.
+   */
+  void AddFunctionBody(const llvm::Function &function) noexcept;
+
+  /**
+   * Turn the value trees of the instructions of the specified function into detached roots.
+   *
+   * The nodes, their constraints and their points-to sets are kept, but they no longer refer to the instructions, so
+   * the body of the function can be deleted afterwards.
+   *
+   * @param function the function.
+   */
+  void DetachFunctionBody(const llvm::Function &function) noexcept;
+
+  /**
+   * Remove the value trees built by `AddFunction` for the specified function.
+   *
+   * The function is identified by address only and is never dereferenced, so it's safe to call this function after the
+   * specified function or any of its instructions have been deleted. IDs of the removed nodes are not reused.
+   *
+   * @param function the function.
+   */
+  void RemoveFunction(const llvm::Function *function) noexcept;
+
+  /**
+   * Build a value tree for a root value that does not correspond to any `llvm::Value` object.
+   *
+   * @param kind kind of the root value.
+   * @param type type of the root value.
+   * @return the root node of the new value tree.
+   */
+  ValueTreeNode* AddDetachedRoot(ValueKind kind, const llvm::Type *type) noexcept;
+
+  /**
+   * Visit all value tree nodes built for the specified function.
+   *
+   * The visitor should be a function object that takes a single argument of type `ValueTreeNode &` and returns a
+   * boolean value indicating whether the traversal should proceed.
+   *
+   * @tparam Visitor the type of the visitor.
+   * @param function the function. The function is never dereferenced.
+   * @param visitor the visitor.
+   * @return whether all value tree nodes have been visited and the visitor does not return a false value.
+   */
+  template <typename Visitor>
+  bool VisitFunction(const llvm::Function *function, Visitor &&visitor) noexcept {
+    auto it = _functionRoots.find(function);
+    if (it == _functionRoots.end()) {
+      return true;
+    }
+    for (auto root : it->second) {
+      if (!root->Visit(visitor)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Build the reverse points-to index, which maps each pointee to the pointers that may point to it.
+   *
+   * The index is built from the current pointee sets in a single pass and stored in compressed sparse row form, so it
+   * should be built after the value tree has been solved. It is dropped whenever value trees are added to or removed
+   * from the value tree.
+   */
+  void BuildReverseIndex() noexcept;
+
+  /**
+   * Drop the reverse points-to index and release its memory.
+   */
+  void DropReverseIndex() noexcept;
+
+  /**
+   * Determine whether the solver ran out of its budget while solving this value tree, in which case some pointers are
+   * marked as unknown.
+   *
+   * @return whether the solution is degraded.
+   */
+  bool isDegraded() const noexcept {
+    return _degraded;
+  }
+
+  /**
+   * Record that some pointers of this value tree have been marked as unknown.
+   */
+  void MarkDegraded() noexcept {
+    _degraded = true;
+  }
+
+  /**
+   * Determine whether the points-to sets of some regions of this value tree have been taken from the unification
+   * pre-pass instead of the inclusion solver, because the solver ran out of its budget. Such sets are sound but less
+   * precise than the solution of the inclusion solver.
+   *
+   * @return whether the solution is approximate.
+   */
+  bool isApproximate() const noexcept {
+    return _approximate;
+  }
+
+  /**
+   * Record that the points-to sets of some pointers of this value tree have been taken from the unification pre-pass.
+   */
+  void MarkApproximate() noexcept {
+    _approximate = true;
+  }
+
+  /**
+   * Determine whether the reverse points-to index has been built.
+   *
+   * @return whether the reverse points-to index has been built.
+   */
+  bool hasReverseIndex() const noexcept {
+    return !_reverseIndexOffsets.empty();
+  }
+
+  /**
+   * Get the pointers that may point to the specified pointee.
+   *
+   * If the reverse points-to index has not been built, this function triggers an assertion failure.
+   *
+   * @param pointee a node in the value tree.
+   * @return the node IDs of the pointers that may point to the pointee, in increasing order.
+   */
+  llvm::ArrayRef<uint32_t> GetPointersTo(const ValueTreeNode &pointee) const noexcept {
+    assert(hasReverseIndex() && "the reverse index has not been built");
+    assert(pointee.id() + 1 < _reverseIndexOffsets.size() && "pointee is not in the value tree");
+    auto begin = _reverseIndexOffsets[pointee.id()];
+    auto end = _reverseIndexOffsets[pointee.id() + 1];
+    return llvm::makeArrayRef(_reverseIndexPointers.data() + begin, end - begin);
+  }
+
   /**
    * Get the value tree node corresponding to the specified rooted value.
    *
@@ -1481,6 +1864,35 @@ public:
     return const_cast<ValueTree *>(this)->GetFunctionReturnValueNode(function);
   }
 
+  /**
+   * Get the ValueTreeNode corresponding to the heap memory allocated by the specified call.
+   *
+   * @param call the call that allocates the heap memory.
+   * @return the ValueTreeNode corresponding to the heap memory, or nullptr if the call does not allocate heap memory.
+   */
+  ValueTreeNode* GetHeapMemoryNode(const llvm::CallInst *call) noexcept {
+    return find_in(_heapMemoryRoots, call);
+  }
+
+  /**
+   * Get the ValueTreeNode corresponding to the heap memory allocated by the specified call.
+   *
+   * @param call the call that allocates the heap memory.
+   * @return the ValueTreeNode corresponding to the heap memory, or nullptr if the call does not allocate heap memory.
+   */
+  const ValueTreeNode* GetHeapMemoryNode(const llvm::CallInst *call) const noexcept {
+    return const_cast<ValueTree *>(this)->GetHeapMemoryNode(call);
+  }
+
+  /**
+   * Get the summaries of the external functions called by the module.
+   *
+   * @return the summaries of the external functions, or nullptr if calls to external functions are not summarized.
+   */
+  const ExternalSummaries* GetExternalSummaries() const noexcept {
+    return _summaries;
+  }
+
   /**
    * Get the number of value roots.
    *
@@ -1526,6 +1938,15 @@ public:
     return _returnValueRoots.size();
   }
 
+  /**
+   * Get the number of heap allocated memory roots.
+   *
+   * @return the number of heap allocated memory roots.
+   */
+  size_t GetNumHeapMemoryRoots() const noexcept {
+    return _heapMemoryRoots.size();
+  }
+
   /**
    * Visit all individual value tree nodes.
    *
@@ -1563,18 +1984,42 @@ public:
         return false;
       }
     }
+    for (const auto &r : _heapMemoryRoots) {
+      if (!r.second->Visit(visitor)) {
+        return false;
+      }
+    }
+    for (const auto &r : _detachedRoots) {
+      if (!r->Visit(visitor)) {
+        return false;
+      }
+    }
     return true;
   }
 
 private:
-  const llvm::Module &_module;
+  const llvm::Module *_module;
   std::unordered_map<const llvm::Value *, std::unique_ptr<ValueTreeNode>> _roots;
   std::unordered_map<const llvm::AllocaInst *, std::unique_ptr<ValueTreeNode>> _allocaMemoryRoots;
   std::unordered_map<const llvm::GlobalVariable *, std::unique_ptr<ValueTreeNode>> _globalMemoryRoots;
   std::unordered_map<const llvm::Argument *, std::unique_ptr<ValueTreeNode>> _argumentMemoryRoots;
   std::unordered_map<const llvm::Function *, std::unique_ptr<ValueTreeNode>> _returnValueRoots;
+  std::unordered_map<const llvm::CallInst *, std::unique_ptr<ValueTreeNode>> _heapMemoryRoots;
+  std::unordered_map<const llvm::Function *, std::vector<ValueTreeNode *>> _functionRoots;
+  std::vector<std::unique_ptr<ValueTreeNode>> _detachedRoots;
+  std::vector<ValueTreeNode *> _nodes;
+  std::vector<size_t> _reverseIndexOffsets;
+  std::vector<uint32_t> _reverseIndexPointers;
   size_t _numPointees;
   size_t _numPointers;
+  bool _degraded;
+  bool _approximate;
+  const ExternalSummaries *_summaries;
+
+  template <typename ...Args>
+  std::unique_ptr<ValueTreeNode> CreateRoot(Args&&... args) noexcept;
+
+  void UnregisterNodes(ValueTreeNode &root) noexcept;
 
   template <
       typename K, typename V,
@@ -1591,6 +2036,8 @@ private:
   }
 };
 
+class IncrementalSolver;
+
 /**
  * Implementation of Anderson points-to analysis algorithm as a LLVM module pass.
  */
@@ -1601,15 +2048,44 @@ public:
   /**
    * Construct a new AndersonPointsToAnalysis object.
    */
-  explicit AndersonPointsToAnalysis() noexcept
-    : llvm::ModulePass { ID },
-      _valueTree(nullptr)
-  { }
+  explicit AndersonPointsToAnalysis() noexcept;
 
   NON_COPIABLE_NON_MOVABLE(AndersonPointsToAnalysis)
 
+  ~AndersonPointsToAnalysis() noexcept override;
+
   bool runOnModule(llvm::Module &module) final;
 
+  /**
+   * Update the analysis result after some functions in the module have been changed, added or removed.
+   *
+   * If the analysis has been run in incremental mode (`-anderson-incremental`), only the constraints of the changed
+   * functions, and of the pointers whose points-to sets may depend on them, are retracted and re-solved. Otherwise the
+   * analysis is re-run from scratch. Either way the result is the same as a from-scratch run on the updated module.
+   *
+   * @param module the updated module. This must be the module on which the analysis has been run.
+   */
+  void Update(llvm::Module &module) noexcept;
+
+  /**
+   * Report the progress of the following runs of the analysis to the specified observer.
+   *
+   * @param observer the observer, or nullptr to stop reporting.
+   */
+  void SetProgressObserver(SolverProgressObserver *observer) noexcept {
+    _observer = observer;
+  }
+
+  /**
+   * Poll the specified token while the analysis runs. A cancelled run returns a degraded result, whose incomplete
+   * points-to sets are unknown.
+   *
+   * @param cancellation the token, or nullptr to stop polling.
+   */
+  void SetCancellationToken(const CancellationToken *cancellation) noexcept {
+    _cancellation = cancellation;
+  }
+
   /**
    * Get the value tree which contains analysis result.
    *
@@ -1622,6 +2098,121 @@ public:
 
 private:
   std::unique_ptr<ValueTree> _valueTree;
+  std::unique_ptr<IncrementalSolver> _incrementalSolver;
+  SolverProgressObserver *_observer;
+  const CancellationToken *_cancellation;
+};
+
+/**
+ * Result of the Anderson points-to analysis under the new pass manager.
+ */
+class AndersonPointsToResult {
+public:
+  /**
+   * Construct a new AndersonPointsToResult object.
+   *
+   * @param valueTree the solved value tree.
+   */
+  explicit AndersonPointsToResult(std::unique_ptr<ValueTree> valueTree) noexcept
+    : _valueTree(std::move(valueTree))
+  {
+    assert(_valueTree && "valueTree cannot be null");
+  }
+
+  /**
+   * Get the value tree which contains analysis result.
+   *
+   * @return the value tree which contains analysis result.
+   */
+  ValueTree* GetValueTree() const noexcept {
+    return _valueTree.get();
+  }
+
+  /**
+   * Determine whether this result should be invalidated after a pass has been run on the module.
+   *
+   * The result depends on nothing but the IR of the module, so it survives any pass that preserves `AndersonAnalysis`
+   * or all analyses on the module.
+   *
+   * @param module the module.
+   * @param preserved the analyses preserved by the pass.
+   * @param invalidator the invalidator of the analysis manager.
+   * @return whether this result should be invalidated.
+   */
+  bool invalidate(llvm::Module &module, const llvm::PreservedAnalyses &preserved,
+                  llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept;
+
+  /**
+   * Print the points-to set of every pointer in the module, one pointer per line.
+   *
+   * @param os the output stream.
+   * @param module the analyzed module.
+   */
+  void print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept;
+
+private:
+  std::unique_ptr<ValueTree> _valueTree;
+};
+
+/**
+ * Implementation of Anderson points-to analysis algorithm as an analysis of the new pass manager.
+ *
+ * The analysis is registered as `anderson` by the pass plugin, so it can be requested with `require<anderson>` and
+ * printed with `print<anderson>` in `opt -passes=`. The solved result is cached by the analysis manager and shared by
+ * all passes in the pipeline until it is invalidated.
+ */
+class AndersonAnalysis : public llvm::AnalysisInfoMixin<AndersonAnalysis> {
+public:
+  using Result = AndersonPointsToResult;
+
+  /**
+   * Construct a new AndersonAnalysis object.
+   *
+   * @param observer the observer receiving the progress of the analysis, or nullptr.
+   * @param cancellation the token polled to cancel the analysis, or nullptr.
+   */
+  explicit AndersonAnalysis(SolverProgressObserver *observer = nullptr,
+                            const CancellationToken *cancellation = nullptr) noexcept
+    : _observer(observer),
+      _cancellation(cancellation)
+  { }
+
+  /**
+   * Run the analysis on the specified module.
+   *
+   * @param module the module.
+   * @param moduleAnalysisManager the module analysis manager.
+   * @return the analysis result.
+   */
+  Result run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  friend llvm::AnalysisInfoMixin<AndersonAnalysis>;
+
+  SolverProgressObserver *_observer;
+  const CancellationToken *_cancellation;
+
+  static llvm::AnalysisKey Key;
+};
+
+/**
+ * A pass of the new pass manager that prints the result of `AndersonAnalysis`.
+ */
+class AndersonPrinterPass : public llvm::PassInfoMixin<AndersonPrinterPass> {
+public:
+  /**
+   * Construct a new AndersonPrinterPass object.
+   *
+   * @param os the output stream.
+   */
+  explicit AndersonPrinterPass(llvm::raw_ostream &os) noexcept
+    : _os(os)
+  { }
+
+  llvm::PreservedAnalyses run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  llvm::raw_ostream &_os;
 };
 
 inline bool Pointee::isPointer() const noexcept {
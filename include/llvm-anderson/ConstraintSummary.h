@@ -0,0 +1,294 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_CONSTRAINT_SUMMARY_H
+#define LLVM_ANDERSON_CONSTRAINT_SUMMARY_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * The local constraint graph of a single module, in a form that does not refer to any LLVM IR.
+ *
+ * A summary consists of the shapes of the rooted values in the module, and the constraints generated from the module
+ * before any of them is solved. Rooted values that are visible outside of the module, i.e. global variables, functions,
+ * their arguments and return values, and the memory referred to by global variables and function arguments, are named
+ * by their symbol names and are left unresolved. Summaries of different modules are combined by `SummaryLinker`.
+ */
+class ConstraintSummary {
+public:
+  /**
+   * Kinds of value shapes.
+   */
+  enum class TypeKind : uint8_t {
+    /**
+     * A value that is neither a pointer nor an aggregate.
+     */
+    Scalar,
+
+    /**
+     * A pointer value.
+     */
+    Pointer,
+
+    /**
+     * An array value.
+     */
+    Array,
+
+    /**
+     * A structure value.
+     */
+    Struct,
+  };
+
+  /**
+   * Shape of a value.
+   */
+  struct Type {
+    TypeKind kind;
+
+    /**
+     * Number of elements in an array value. Always 0 for other kinds.
+     */
+    uint64_t numElements;
+
+    /**
+     * Indexes of the element shapes. An array value has a single element shape. Element shapes always precede the
+     * shapes containing them.
+     */
+    std::vector<uint32_t> elementTypes;
+  };
+
+  /**
+   * A rooted value.
+   */
+  struct Root {
+    ValueKind kind;
+
+    /**
+     * Whether the root refers to a symbol that may be defined or used by other modules.
+     */
+    bool isLinkable;
+
+    /**
+     * Index of the shape of the root value.
+     */
+    uint32_t type;
+
+    /**
+     * Name of the root. Roots of the same kind and the same name are the same value if they are linkable.
+     */
+    std::string symbol;
+  };
+
+  /**
+   * Reference to a node in the value tree of a root.
+   */
+  struct NodeRef {
+    /**
+     * Index of the root.
+     */
+    uint32_t root;
+
+    /**
+     * Pre-order offset of the node within the value tree of the root. The root itself has offset 0.
+     */
+    uint64_t offset;
+  };
+
+  /**
+   * A constraint on a pointer.
+   */
+  struct Constraint {
+    PointerAssignmentKind kind;
+
+    /**
+     * The pointer on the left hand side of the constraint.
+     */
+    NodeRef pointer;
+
+    /**
+     * The pointee on the right hand side of a `p = &q` constraint, or the pointer on the right hand side of other
+     * constraints.
+     */
+    NodeRef operand;
+
+    /**
+     * Index sequence of a `p = &q[...]` constraint. Always empty for other kinds.
+     */
+    std::vector<PointerIndex> indexSequence;
+  };
+
+  /**
+   * Build the summary of the specified module.
+   *
+   * The constraints of the summary are taken from the value tree, so all constraints of the module, including the
+   * trivial ones, should have been added to the value tree before it is solved.
+   *
+   * @param module the module.
+   * @param valueTree the value tree of the module.
+   * @return the summary.
+   */
+  static std::unique_ptr<ConstraintSummary> Build(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  /**
+   * Build the summary of the specified lazily loaded module.
+   *
+   * Functions are materialized one at a time, and the body of each function is deleted as soon as its constraints
+   * have been generated, so at most one function body is alive at any time.
+   *
+   * @param module the lazily loaded module, e.g. returned by `llvm::getLazyIRFileModule`.
+   * @return the summary. If some function cannot be materialized, return nullptr.
+   */
+  static std::unique_ptr<ConstraintSummary> BuildLazily(llvm::Module &module) noexcept;
+
+  /**
+   * Determine whether the specified buffer contains a summary rather than, e.g., LLVM IR.
+   *
+   * @param buffer the buffer.
+   * @return whether the buffer starts with the magic of summaries.
+   */
+  static bool IsSummary(llvm::MemoryBufferRef buffer) noexcept;
+
+  /**
+   * Read a summary from the specified buffer.
+   *
+   * @param buffer the buffer written by `Write`.
+   * @return the summary. If the buffer does not contain a well-formed summary, return nullptr.
+   */
+  static std::unique_ptr<ConstraintSummary> Read(llvm::MemoryBufferRef buffer) noexcept;
+
+  /**
+   * Read a summary from the specified file.
+   *
+   * @param path path to the file.
+   * @return the summary. If the file cannot be read or does not contain a well-formed summary, return nullptr.
+   */
+  static std::unique_ptr<ConstraintSummary> ReadFile(llvm::StringRef path) noexcept;
+
+  /**
+   * Write the summary to the specified stream.
+   *
+   * @param os the output stream.
+   */
+  void Write(llvm::raw_ostream &os) const noexcept;
+
+  /**
+   * Write the summary to the specified file.
+   *
+   * @param path path to the file.
+   * @return whether the summary has been written successfully.
+   */
+  bool WriteFile(llvm::StringRef path) const noexcept;
+
+  const std::vector<Type>& types() const noexcept {
+    return _types;
+  }
+
+  const std::vector<Root>& roots() const noexcept {
+    return _roots;
+  }
+
+  const std::vector<Constraint>& constraints() const noexcept {
+    return _constraints;
+  }
+
+private:
+  std::vector<Type> _types;
+  std::vector<Root> _roots;
+  std::vector<Constraint> _constraints;
+};
+
+/**
+ * Link constraint summaries of different modules into a single constraint graph and solve it.
+ *
+ * Linkable roots of the same kind and the same symbol name are unified. If the shapes of unified roots differ, the
+ * shape of the first linked root is kept, and nodes that do not exist in the kept shape are folded into their nearest
+ * existing ancestor.
+ */
+class SummaryLinker {
+public:
+  /**
+   * Construct a new SummaryLinker object with an empty constraint graph.
+   */
+  explicit SummaryLinker() noexcept;
+
+  NON_COPIABLE_NON_MOVABLE(SummaryLinker)
+
+  /**
+   * Link the specified summary into the constraint graph.
+   *
+   * @param summary the summary.
+   */
+  void Link(const ConstraintSummary &summary) noexcept;
+
+  /**
+   * Load the specified IR file lazily, summarize it with `ConstraintSummary::BuildLazily` and link the summary into
+   * the constraint graph. The IR is released before this function returns.
+   *
+   * @param path path to the IR file.
+   * @param diagnostic receives the error if the IR file cannot be loaded.
+   * @return whether the IR file has been linked.
+   */
+  bool LinkIRFile(llvm::StringRef path, llvm::SMDiagnostic &diagnostic) noexcept;
+
+  /**
+   * Solve the linked constraint graph.
+   */
+  void Solve() noexcept;
+
+  /**
+   * Get the value tree of the linked constraint graph.
+   *
+   * @return the value tree of the linked constraint graph.
+   */
+  ValueTree* GetValueTree() const noexcept {
+    return _valueTree.get();
+  }
+
+  /**
+   * Get the symbol name of the specified root node.
+   *
+   * @param root a root node in the linked value tree.
+   * @return the symbol name of the root node.
+   */
+  llvm::StringRef GetSymbol(const ValueTreeNode &root) const noexcept;
+
+  /**
+   * Print the points-to set of every pointer in the linked constraint graph, one pointer per line.
+   *
+   * @param os the output stream.
+   */
+  void Print(llvm::raw_ostream &os) const noexcept;
+
+private:
+  llvm::LLVMContext _context;
+  std::unique_ptr<ValueTree> _valueTree;
+  std::map<std::pair<ValueKind, std::string>, ValueTreeNode *> _linkableRoots;
+  std::unordered_map<const ValueTreeNode *, std::string> _symbols;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_CONSTRAINT_SUMMARY_H
@@ -0,0 +1,132 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_DEMAND_DRIVEN_ANALYSIS_H
+#define LLVM_ANDERSON_DEMAND_DRIVEN_ANALYSIS_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Value.h>
+
+namespace llvm {
+
+namespace anderson {
+
+class DependencyIndex;
+class PointsToSolver;
+
+/**
+ * Anderson points-to analysis that only solves the part of the constraint graph needed to answer a set of queries.
+ *
+ * The value tree of the whole module is built up front, but the constraints are only generated for the pointers that
+ * are explored, which are the pointers backward-reachable from the queried values in the constraint graph. A load
+ * `p = *q` depends on the pointees of `q`, which in turn depend on the stores that may write to them. The stores that
+ * may write to an object are found by following the def-use chains from the address of the object, so exploring
+ * through memory only explores the pointers that those stores write through.
+ *
+ * Exploration is bounded by a budget on the number of explored pointers. A queried value whose dependencies have not
+ * all been explored within the budget is answered as unknown; every other answer equals the answer of the exhaustive
+ * solver.
+ */
+class DemandDrivenAnalysis {
+public:
+  /**
+   * Construct a new DemandDrivenAnalysis object and build the value tree of the specified module.
+   *
+   * @param module the module. It must outlive this object.
+   */
+  explicit DemandDrivenAnalysis(const llvm::Module &module) noexcept;
+
+  NON_COPIABLE_NON_MOVABLE(DemandDrivenAnalysis)
+
+  ~DemandDrivenAnalysis() noexcept;
+
+  /**
+   * Solve the points-to sets of the specified values.
+   *
+   * The explored region of the constraint graph is kept across queries, so later queries only explore what earlier
+   * queries have not.
+   *
+   * @param values the queried values.
+   * @param budget the maximum number of pointers newly explored by this query.
+   * @return whether all queried pointer values have been answered, i.e. the budget has not been exhausted.
+   */
+  bool Query(llvm::ArrayRef<const llvm::Value *> values, size_t budget) noexcept;
+
+  /**
+   * Get the solved pointee set of the specified value.
+   *
+   * @param value the value.
+   * @return the pointee set of the value, which equals to the one computed by the exhaustive solver. If the value is not
+   * a pointer, has not been queried, or depends on pointers that have not been explored, return nullptr.
+   */
+  const PointeeSet* GetPointeeSet(const llvm::Value *value) const noexcept;
+
+  /**
+   * Get the number of pointers explored so far.
+   *
+   * @return the number of pointers explored so far.
+   */
+  size_t GetNumExploredPointers() const noexcept {
+    return _region.size();
+  }
+
+  /**
+   * Get the value tree of the module. Only the pointee sets of explored pointers are meaningful.
+   *
+   * @return the value tree of the module.
+   */
+  ValueTree* GetValueTree() const noexcept;
+
+private:
+  /**
+   * The pointers that stores may write to an object through.
+   */
+  struct ObjectStores {
+    std::vector<Pointer *> pointers;
+
+    /**
+     * Whether all of the pointers have been explored.
+     */
+    bool explored;
+  };
+
+  const llvm::Module &_module;
+  std::unique_ptr<PointsToSolver> _solver;
+  std::unique_ptr<DependencyIndex> _dependencies;
+  std::unordered_set<Pointer *> _region;
+  std::vector<Pointer *> _regionOrder;
+  std::unordered_map<Pointer *, std::pair<size_t, size_t>> _exploredOperands;
+  std::unordered_set<const llvm::Value *> _generated;
+  std::unordered_map<const ValueTreeNode *, ObjectStores> _objectStores;
+  std::unique_ptr<std::vector<const llvm::Value *>> _loadedPointers;
+  std::unordered_set<const Pointer *> _incomplete;
+
+  void AddToRegion(Pointer *pointer) noexcept;
+
+  void GenerateConstraints(const ValueTreeNode &root) noexcept;
+
+  ObjectStores& GetObjectStores(const ValueTreeNode &object) noexcept;
+
+  const std::vector<const llvm::Value *>& GetLoadedPointers() noexcept;
+
+  bool Explore(size_t &budget) noexcept;
+
+  void ComputeIncompletePointers() noexcept;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_DEMAND_DRIVEN_ANALYSIS_H
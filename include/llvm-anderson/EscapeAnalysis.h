@@ -0,0 +1,159 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_ESCAPE_ANALYSIS_H
+#define LLVM_ANDERSON_ESCAPE_ANALYSIS_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * How far the memory allocated by an `alloca` instruction may escape.
+ */
+enum class EscapeKind {
+  /**
+   * The memory is only reachable from pointers local to the allocating function.
+   */
+  NoEscape,
+
+  /**
+   * The memory is reachable from the arguments of some call, but not from any of the roots of `GlobalEscape`. The callee
+   * may still keep the memory alive after it returns unless it is known not to capture its arguments.
+   */
+  ArgEscape,
+
+  /**
+   * The memory is reachable from global memory, from the memory passed in by the callers of a function, from the return
+   * value of a function, or from a pointer the analysis cannot follow, e.g. an integer converted from a pointer, a
+   * pointer copied through memory as an integer, or a pointer stored into memory that cannot hold a pointer.
+   */
+  GlobalEscape,
+};
+
+/**
+ * Escape classification of all `alloca` instructions in a module, derived from the solved points-to relation.
+ *
+ * Every stack memory object is classified by a single reachability sweep over the memory objects: objects reachable
+ * from the escape roots of `GlobalEscape` are swept first, then the remaining objects reachable from call arguments. An
+ * object is reachable from a pointer if it is in the points-to set of the pointer, or if it is reachable from a pointer
+ * stored in an object reachable from the pointer.
+ *
+ * The classification is computed when this object is constructed, so it does not refer to the value tree afterwards.
+ */
+class EscapeInfo {
+public:
+  /**
+   * Construct a new EscapeInfo object and classify all `alloca` instructions in the module.
+   *
+   * @param module the module.
+   * @param valueTree the solved value tree of the module.
+   */
+  explicit EscapeInfo(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  /**
+   * Get the escape classification of the specified `alloca` instruction.
+   *
+   * @param alloca the `alloca` instruction.
+   * @return the escape classification. `alloca` instructions that are unknown to the analysis, e.g. created after the
+   * analysis has been run, are classified as `GlobalEscape`.
+   */
+  EscapeKind GetEscapeKind(const llvm::AllocaInst &alloca) const noexcept {
+    auto it = _kinds.find(&alloca);
+    return it == _kinds.end() ? EscapeKind::GlobalEscape : it->second;
+  }
+
+  /**
+   * Determine whether the memory allocated by the specified `alloca` instruction never escapes its function.
+   *
+   * @param alloca the `alloca` instruction.
+   * @return whether the memory does not escape.
+   */
+  bool isNonEscaping(const llvm::AllocaInst &alloca) const noexcept {
+    return GetEscapeKind(alloca) == EscapeKind::NoEscape;
+  }
+
+  /**
+   * Determine whether this result should be invalidated after a pass has been run on the module.
+   *
+   * The classification is derived from the result of `AndersonAnalysis`, so it is invalidated along with it.
+   *
+   * @param module the module.
+   * @param preserved the analyses preserved by the pass.
+   * @param invalidator the invalidator of the analysis manager.
+   * @return whether this result should be invalidated.
+   */
+  bool invalidate(llvm::Module &module, const llvm::PreservedAnalyses &preserved,
+                  llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept;
+
+  /**
+   * Print the escape classification of every `alloca` instruction in the module, one instruction per line.
+   *
+   * @param os the output stream.
+   * @param module the analyzed module.
+   */
+  void print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept;
+
+private:
+  llvm::DenseMap<const llvm::AllocaInst *, EscapeKind> _kinds;
+};
+
+/**
+ * Escape analysis of `alloca` instructions as an analysis of the new pass manager.
+ *
+ * The pass plugin registers the analysis as `anderson-escape`, so it can be requested with `require<anderson-escape>`
+ * and printed with `print<anderson-escape>` in `opt -passes=`.
+ */
+class AndersonEscapeAnalysis : public llvm::AnalysisInfoMixin<AndersonEscapeAnalysis> {
+public:
+  using Result = EscapeInfo;
+
+  /**
+   * Run the analysis on the specified module.
+   *
+   * @param module the module.
+   * @param moduleAnalysisManager the module analysis manager.
+   * @return the analysis result.
+   */
+  Result run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  friend llvm::AnalysisInfoMixin<AndersonEscapeAnalysis>;
+
+  static llvm::AnalysisKey Key;
+};
+
+/**
+ * Pass that prints the escape classification of all `alloca` instructions in a module.
+ */
+class AndersonEscapePrinterPass : public llvm::PassInfoMixin<AndersonEscapePrinterPass> {
+public:
+  /**
+   * Construct a new AndersonEscapePrinterPass object.
+   *
+   * @param os the output stream.
+   */
+  explicit AndersonEscapePrinterPass(llvm::raw_ostream &os) noexcept
+    : _os(os)
+  { }
+
+  llvm::PreservedAnalyses run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  llvm::raw_ostream &_os;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_ESCAPE_ANALYSIS_H
@@ -0,0 +1,251 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_MOD_REF_SUMMARY_H
+#define LLVM_ANDERSON_MOD_REF_SUMMARY_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <memory>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SparseBitVector.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+class TaintAnalysis;
+
+/**
+ * Per-function summaries of the memory objects that a function, including all of its callees, may read or write.
+ *
+ * Objects are the roots of the value trees of stack, global and argument memory, numbered densely from 0. The local
+ * accesses of each function are collected from the points-to sets of the pointer operands of its loads, stores, atomic
+ * instructions and memory intrinsics, and are then propagated bottom-up over the strongly connected components of the
+ * direct call graph, so all functions in a cycle of calls share the same summary.
+ *
+ * The points-to sets are completed with the conservative escape analysis shared with the alias analysis, so an access
+ * through a pointer that unknown code may have produced, e.g. a pointer loaded from memory passed to an external
+ * function, may access every escaped object. An access through a pointer whose points-to set is empty, and a call to a
+ * function that is not defined in the module and is not known to access only its arguments, may access any object.
+ *
+ * All summaries are computed when this object is constructed. The object sets of the pointers passed to
+ * `GetModRefInfo` are cached on first use, so this object must not be queried from multiple threads concurrently.
+ */
+class ModRefSummary {
+public:
+  /**
+   * The object ID returned for nodes that do not belong to any memory object.
+   */
+  static constexpr unsigned InvalidObject = ~0U;
+
+  /**
+   * Mod/ref summary of a single function.
+   */
+  struct FunctionSummary {
+    /**
+     * The objects that the function may write.
+     */
+    llvm::SparseBitVector<> mod;
+
+    /**
+     * The objects that the function may read.
+     */
+    llvm::SparseBitVector<> ref;
+
+    /**
+     * Whether the function may write any object.
+     */
+    bool modAny = false;
+
+    /**
+     * Whether the function may read any object.
+     */
+    bool refAny = false;
+
+    /**
+     * Merge the specified summary into this summary.
+     *
+     * @param other the other summary.
+     */
+    void MergeFrom(const FunctionSummary &other) noexcept {
+      mod |= other.mod;
+      ref |= other.ref;
+      modAny |= other.modAny;
+      refAny |= other.refAny;
+    }
+  };
+
+  /**
+   * Construct a new ModRefSummary object and compute the summaries of all functions defined in the module.
+   *
+   * @param module the module.
+   * @param valueTree the solved value tree of the module. It must outlive this object.
+   */
+  explicit ModRefSummary(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  ModRefSummary(ModRefSummary &&) noexcept;
+
+  ModRefSummary& operator=(ModRefSummary &&) noexcept;
+
+  ~ModRefSummary() noexcept;
+
+  /**
+   * Get the number of memory objects.
+   *
+   * @return the number of memory objects.
+   */
+  unsigned GetNumObjects() const noexcept {
+    return static_cast<unsigned>(_objectNodes.size());
+  }
+
+  /**
+   * Get the ID of the memory object containing the specified node.
+   *
+   * @param node the value tree node.
+   * @return the ID of the memory object. If the node does not live in stack, global or argument memory, return
+   * `InvalidObject`.
+   */
+  unsigned GetObjectId(const ValueTreeNode &node) const noexcept;
+
+  /**
+   * Get the root node of the specified memory object.
+   *
+   * @param objectId the object ID.
+   * @return the root node of the memory object.
+   */
+  const ValueTreeNode* GetObjectNode(unsigned objectId) const noexcept {
+    assert(objectId < GetNumObjects() && "object ID out of range");
+    return _objectNodes[objectId];
+  }
+
+  /**
+   * Get the summary of the specified function.
+   *
+   * @param function the function.
+   * @return the summary of the function. If the function is not defined in the module, return nullptr.
+   */
+  const FunctionSummary* GetSummary(const llvm::Function &function) const noexcept {
+    auto it = _summaries.find(&function);
+    return it == _summaries.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * Determine whether the specified function, or any of its callees, may read or write the memory the specified
+   * pointer may point to.
+   *
+   * @param function the function.
+   * @param pointer the pointer value.
+   * @return the mod/ref information.
+   */
+  llvm::ModRefInfo GetModRefInfo(const llvm::Function &function, const llvm::Value *pointer) const noexcept;
+
+  /**
+   * Determine whether the specified call may read or write the memory the specified pointer may point to.
+   *
+   * @param call the call.
+   * @param pointer the pointer value.
+   * @return the mod/ref information. Calls to functions not defined in the module, and indirect calls, may read and
+   * write any memory unless their attributes say otherwise.
+   */
+  llvm::ModRefInfo GetModRefInfo(const llvm::CallBase &call, const llvm::Value *pointer) const noexcept;
+
+  /**
+   * Determine whether this result should be invalidated after a pass has been run on the module.
+   *
+   * The summaries are derived from the result of `AndersonAnalysis`, so they are invalidated along with it.
+   *
+   * @param module the module.
+   * @param preserved the analyses preserved by the pass.
+   * @param invalidator the invalidator of the analysis manager.
+   * @return whether this result should be invalidated.
+   */
+  bool invalidate(llvm::Module &module, const llvm::PreservedAnalyses &preserved,
+                  llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept;
+
+  /**
+   * Print the summary of every function defined in the module, one function per line.
+   *
+   * @param os the output stream.
+   * @param module the analyzed module.
+   */
+  void print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept;
+
+private:
+  struct PointerObjects {
+    llvm::SparseBitVector<> objects;
+    bool unknown = false;
+  };
+
+  const ValueTree *_valueTree;
+  std::unique_ptr<TaintAnalysis> _taint;
+  std::vector<const ValueTreeNode *> _objectNodes;
+  llvm::DenseMap<const ValueTreeNode *, unsigned> _objectIds;
+  llvm::SparseBitVector<> _escapedObjects;
+  llvm::DenseMap<const llvm::Function *, FunctionSummary> _summaries;
+  mutable llvm::DenseMap<const llvm::Value *, PointerObjects> _pointerObjects;
+
+  const PointerObjects& GetPointerObjects(const llvm::Value *pointer) const noexcept;
+
+  FunctionSummary ComputeLocalSummary(const llvm::Function &function) const noexcept;
+};
+
+/**
+ * Mod/ref summaries as an analysis of the new pass manager.
+ *
+ * The pass plugin registers the analysis as `anderson-modref`, so it can be requested with `require<anderson-modref>`
+ * and printed with `print<anderson-modref>` in `opt -passes=`.
+ */
+class AndersonModRefAnalysis : public llvm::AnalysisInfoMixin<AndersonModRefAnalysis> {
+public:
+  using Result = ModRefSummary;
+
+  /**
+   * Run the analysis on the specified module.
+   *
+   * @param module the module.
+   * @param moduleAnalysisManager the module analysis manager.
+   * @return the analysis result.
+   */
+  Result run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  friend llvm::AnalysisInfoMixin<AndersonModRefAnalysis>;
+
+  static llvm::AnalysisKey Key;
+};
+
+/**
+ * Pass that prints the mod/ref summaries of all functions in a module.
+ */
+class AndersonModRefPrinterPass : public llvm::PassInfoMixin<AndersonModRefPrinterPass> {
+public:
+  /**
+   * Construct a new AndersonModRefPrinterPass object.
+   *
+   * @param os the output stream.
+   */
+  explicit AndersonModRefPrinterPass(llvm::raw_ostream &os) noexcept
+    : _os(os)
+  { }
+
+  llvm::PreservedAnalyses run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept;
+
+private:
+  llvm::raw_ostream &_os;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_MOD_REF_SUMMARY_H
@@ -0,0 +1,206 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_POINTS_TO_QUERY_H
+#define LLVM_ANDERSON_POINTS_TO_QUERY_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Value.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Immutable snapshot of a solved points-to relation that can be queried from multiple threads concurrently.
+ *
+ * The snapshot copies everything it needs out of the value tree when it is built: the IDs of the rooted values, the
+ * roots and kinds of all value tree nodes, and the pointee sets and the reverse points-to index in compressed sparse row
+ * form. It does not refer to the value tree, the solver or any other mutable structure afterwards, and none of its
+ * member functions modify it, so any number of threads may query it at the same time without synchronization.
+ *
+ * Nodes are identified by their IDs in the value tree the snapshot has been built from.
+ */
+class PointsToQuery {
+public:
+  /**
+   * The node ID returned for values that have no value tree node.
+   */
+  static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+  /**
+   * Build a snapshot of the specified solved value tree.
+   *
+   * This function reads the pointee set of every pointer, so it must not run concurrently with any modification of the
+   * value tree.
+   *
+   * @param valueTree the solved value tree.
+   * @return the snapshot.
+   */
+  static std::shared_ptr<const PointsToQuery> Build(const ValueTree &valueTree) noexcept;
+
+  NON_COPIABLE_NON_MOVABLE(PointsToQuery)
+
+  /**
+   * Get the number of node IDs in the snapshot.
+   *
+   * @return the number of node IDs in the snapshot.
+   */
+  size_t GetNumNodes() const noexcept {
+    return _nodeRoots.size();
+  }
+
+  /**
+   * Get the ID of the node corresponding to the specified rooted value.
+   *
+   * @param value the rooted value.
+   * @return the ID of the node. If the value is not a valid root of a value tree, return `InvalidNode`.
+   */
+  uint32_t GetValueNode(const llvm::Value *value) const noexcept {
+    auto it = _valueNodes.find(value);
+    return it == _valueNodes.end() ? InvalidNode : it->second;
+  }
+
+  /**
+   * Get the ID of the root node of the value tree containing the specified node.
+   *
+   * @param node the node ID.
+   * @return the ID of the root node, or `InvalidNode` if the node has been removed from the value tree.
+   */
+  uint32_t GetRootNode(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return _nodeRoots[node];
+  }
+
+  /**
+   * Get the kind of the specified node.
+   *
+   * @param node the node ID.
+   * @return the kind of the node.
+   */
+  ValueKind GetNodeKind(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return _nodeKinds[node];
+  }
+
+  /**
+   * Get the LLVM value of the specified root node.
+   *
+   * @param node the node ID.
+   * @return the value associated with the root node, i.e. the value itself for normal values, or the `alloca`
+   * instruction, global variable, argument or function the memory or return value belongs to. If the node is not a
+   * root, or the root has no value, return nullptr.
+   */
+  const llvm::Value* GetNodeValue(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return _nodeValues[node];
+  }
+
+  /**
+   * Get the pointee set of the specified node.
+   *
+   * @param node the node ID.
+   * @return the IDs of the pointees of the node in ascending order. If the node is not a pointer, return an empty list.
+   */
+  llvm::ArrayRef<uint32_t> GetPointees(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return GetRow(_pointeeOffsets, _pointees, node);
+  }
+
+  /**
+   * Get the pointee set of the specified rooted value.
+   *
+   * @param value the rooted value.
+   * @return the IDs of the pointees of the value in ascending order. If the value is not a valid root or not a pointer,
+   * return an empty list.
+   */
+  llvm::ArrayRef<uint32_t> GetPointees(const llvm::Value *value) const noexcept {
+    auto node = GetValueNode(value);
+    return node == InvalidNode ? llvm::ArrayRef<uint32_t> { } : GetPointees(node);
+  }
+
+  /**
+   * Determine whether the specified node is a pointer whose pointee set is unknown because the solver ran out of its
+   * budget. Such a pointer may point to any node, and `GetPointees` only returns the pointees found before the solver
+   * gave up.
+   *
+   * @param node the node ID.
+   * @return whether the pointee set of the node is unknown.
+   */
+  bool isUnknown(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return _unknown.test(node);
+  }
+
+  /**
+   * Get the pointers that may point to the specified node.
+   *
+   * @param node the node ID.
+   * @return the IDs of the pointers whose pointee sets contain the node, in ascending order.
+   */
+  llvm::ArrayRef<uint32_t> GetPointersTo(uint32_t node) const noexcept {
+    assert(node < GetNumNodes() && "node ID out of range");
+    return GetRow(_pointerOffsets, _pointers, node);
+  }
+
+  /**
+   * Determine whether the pointee set of a node contains another node.
+   *
+   * @param pointer the ID of the pointer node.
+   * @param pointee the ID of the pointee node.
+   * @return whether `pointer` may point to `pointee`. Unknown pointers may point to any node.
+   */
+  bool MayPointTo(uint32_t pointer, uint32_t pointee) const noexcept;
+
+  /**
+   * Determine whether two rooted values may point into the same object.
+   *
+   * Pointees are compared by the roots of their value trees, so a pointer to a struct may alias a pointer to one of its
+   * fields. A value without a node or with an empty pointee set may point anywhere, as may an unknown pointer.
+   *
+   * @param lhs the first rooted value.
+   * @param rhs the second rooted value.
+   * @return whether the two values may point into the same object.
+   */
+  bool MayAlias(const llvm::Value *lhs, const llvm::Value *rhs) const noexcept;
+
+private:
+  llvm::DenseMap<const llvm::Value *, uint32_t> _valueNodes;
+  std::vector<uint32_t> _nodeRoots;
+  std::vector<ValueKind> _nodeKinds;
+  std::vector<const llvm::Value *> _nodeValues;
+  std::vector<size_t> _pointeeOffsets;
+  std::vector<uint32_t> _pointees;
+  std::vector<size_t> _pointerOffsets;
+  std::vector<uint32_t> _pointers;
+  llvm::BitVector _unknown;
+
+  explicit PointsToQuery() noexcept;
+
+  /**
+   * Get the IDs of the roots of the pointees of the specified node, in ascending order and without duplicates.
+   */
+  llvm::SmallVector<uint32_t, 8> GetPointeeObjects(uint32_t node) const noexcept;
+
+  static llvm::ArrayRef<uint32_t> GetRow(const std::vector<size_t> &offsets, const std::vector<uint32_t> &elements,
+                                         uint32_t row) noexcept {
+    return llvm::makeArrayRef(elements.data() + offsets[row], elements.data() + offsets[row + 1]);
+  }
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_POINTS_TO_QUERY_H
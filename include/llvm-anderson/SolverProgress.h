@@ -0,0 +1,138 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SOLVER_PROGRESS_H
+#define LLVM_ANDERSON_SOLVER_PROGRESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Phases of the analysis of a module.
+ */
+enum class SolverPhase {
+  /**
+   * Building the value tree of the module.
+   */
+  BuildValueTree,
+
+  /**
+   * Generating the constraints of the instructions in the module.
+   */
+  GenerateConstraints,
+
+  /**
+   * Relaxing the constraints until a fixpoint is reached.
+   */
+  Solve,
+
+  /**
+   * The analysis has finished, has run out of its budget or has been cancelled.
+   */
+  Done,
+};
+
+/**
+ * Get the name of the specified phase, e.g. `solve`.
+ *
+ * @param phase the phase.
+ * @return the name of the phase.
+ */
+const char* GetSolverPhaseName(SolverPhase phase) noexcept;
+
+/**
+ * A snapshot of the progress of the analysis of a module.
+ */
+struct SolverProgress {
+  /**
+   * The current phase.
+   */
+  SolverPhase phase = SolverPhase::BuildValueTree;
+
+  /**
+   * Number of outer iterations started by the exhaustive solver, or 0 for the worklist solver.
+   */
+  size_t iteration = 0;
+
+  /**
+   * Number of pointers on the worklist, or 0 for the exhaustive solver.
+   */
+  size_t worklistSize = 0;
+
+  /**
+   * Number of constraints relaxed so far.
+   */
+  uint64_t constraintsProcessed = 0;
+
+  /**
+   * Estimated number of pointers that remain to be relaxed. This is a lower bound: relaxing a pointer may require
+   * relaxing more pointers.
+   */
+  uint64_t estimatedRemaining = 0;
+};
+
+/**
+ * Receives progress reports from the solver.
+ *
+ * Reports are delivered at the start of each phase, at bounded intervals while solving, and once at the end, on the
+ * thread running the analysis. A parallel solver delivers them from one thread at a time.
+ */
+class SolverProgressObserver {
+public:
+  virtual ~SolverProgressObserver() noexcept = default;
+
+  /**
+   * Receive a progress report.
+   *
+   * @param progress the progress of the analysis.
+   */
+  virtual void OnProgress(const SolverProgress &progress) noexcept = 0;
+};
+
+/**
+ * A flag that asks a running analysis to stop.
+ *
+ * The token may be cancelled from any thread, including from a signal handler. The analysis polls it at bounded
+ * intervals, stops at the next poll, and returns a degraded result in which the pointers whose points-to sets are
+ * incomplete are marked as unknown, as if its budget had been exceeded.
+ */
+class CancellationToken {
+public:
+  explicit CancellationToken() noexcept
+    : _cancelled(false)
+  { }
+
+  CancellationToken(const CancellationToken &) = delete;
+  CancellationToken& operator=(const CancellationToken &) = delete;
+
+  /**
+   * Ask the analyses polling this token to stop.
+   */
+  void Cancel() noexcept {
+    _cancelled.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * Determine whether this token has been cancelled.
+   *
+   * @return whether this token has been cancelled.
+   */
+  bool isCancelled() const noexcept {
+    return _cancelled.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> _cancelled;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SOLVER_PROGRESS_H
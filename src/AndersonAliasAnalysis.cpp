@@ -0,0 +1,431 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonAliasAnalysis.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/IntEqClasses.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/SparseBitVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/ValueMap.h>
+
+#include "TaintAnalysis.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+bool ContainsPointer(const llvm::Type *type) noexcept {
+  if (type->isPointerTy()) {
+    return true;
+  }
+  for (auto elementType : type->subtypes()) {
+    if (ContainsPointer(elementType)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace <anonymous>
+
+/**
+ * Object sets of the pointer values in a module.
+ *
+ * An object is identified by the node ID of the root of its value tree. The points-to relation only covers the pointers
+ * produced by instructions modeled by the constraint generator, so the object sets are completed with the conservative
+ * escape analysis of `TaintAnalysis`.
+ *
+ * The object set of a tainted pointer contains the pseudo object `_escapedObject`, which stands for every escaped
+ * object.
+ */
+class AndersonAAResult::ObjectSets {
+public:
+  /**
+   * Set ID of pointers that are unknown to the points-to relation.
+   */
+  constexpr static const unsigned UnknownSet = 0;
+
+  explicit ObjectSets(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  NON_COPIABLE_NON_MOVABLE(ObjectSets)
+
+  /**
+   * Get the ID of the object set of the specified pointer value.
+   *
+   * @param pointer the pointer value.
+   * @return the set ID, or `UnknownSet` if the pointer is unknown.
+   */
+  unsigned GetSetId(const llvm::Value *pointer) const noexcept {
+    return _setIds.lookup(pointer);
+  }
+
+  /**
+   * Determine whether pointers with the specified object sets may point to the same object.
+   */
+  bool MayAlias(unsigned setA, unsigned setB) noexcept;
+
+  /**
+   * Determine whether the specified call may access any object in the specified object set.
+   */
+  bool MayBeAccessedBy(unsigned setId, const llvm::CallBase &call) noexcept;
+
+  /**
+   * Compute the may-alias bit matrix of the specified pointers.
+   */
+  std::vector<llvm::BitVector> GetAliasMatrix(llvm::ArrayRef<const llvm::Value *> pointers) noexcept;
+
+  /**
+   * Partition the specified pointers into alias classes.
+   */
+  std::vector<unsigned> GetAliasClasses(llvm::ArrayRef<const llvm::Value *> pointers) noexcept;
+
+private:
+  using ObjectSet = llvm::SparseBitVector<>;
+
+  struct SetIdMapConfig : llvm::ValueMapConfig<const llvm::Value *> {
+    // A value that has been replaced is dropped with its users, rather than taking over the set of the replacement.
+    enum { FollowRAUW = false };
+  };
+
+  unsigned _escapedObject;
+  llvm::ValueMap<const llvm::Value *, unsigned, SetIdMapConfig> _setIds;
+  std::vector<ObjectSet> _sets;
+  std::map<std::vector<unsigned>, unsigned> _setIndex;
+  llvm::DenseMap<std::pair<unsigned, unsigned>, bool> _mayAlias;
+  llvm::DenseMap<unsigned, ObjectSet> _contents;
+  llvm::DenseMap<unsigned, ObjectSet> _closures;
+  ObjectSet _escaped;
+
+  unsigned Intern(const ObjectSet &objects) noexcept;
+
+  const ObjectSet& GetClosure(unsigned setId) noexcept;
+};
+
+AndersonAAResult::ObjectSets::ObjectSets(const llvm::Module &module, const ValueTree &valueTree) noexcept
+  : _escapedObject(static_cast<unsigned>(valueTree.GetNumNodes())),
+    _setIds(),
+    _sets(1),
+    _setIndex(),
+    _mayAlias(),
+    _contents(),
+    _closures(),
+    _escaped()
+{
+  TaintAnalysis taint { module, valueTree };
+  _escaped = taint.GetEscapedObjects();
+  _contents = taint.GetContents();
+
+  // Intern the final object sets.
+  for (const auto &entry : taint.GetAllObjects()) {
+    auto value = entry.first;
+    auto pointees = entry.second;
+    if (taint.isTainted(value)) {
+      pointees.set(_escapedObject);
+    }
+    if (pointees.empty()) {
+      continue;
+    }
+    _setIds[value] = Intern(pointees);
+  }
+  _setIndex.clear();
+}
+
+unsigned AndersonAAResult::ObjectSets::Intern(const ObjectSet &objects) noexcept {
+  std::vector<unsigned> key;
+  for (auto object : objects) {
+    key.push_back(object);
+  }
+  auto it = _setIndex.find(key);
+  if (it != _setIndex.end()) {
+    return it->second;
+  }
+
+  auto setId = static_cast<unsigned>(_sets.size());
+  _sets.push_back(objects);
+  _setIndex.emplace(std::move(key), setId);
+  return setId;
+}
+
+bool AndersonAAResult::ObjectSets::MayAlias(unsigned setA, unsigned setB) noexcept {
+  assert(setA != UnknownSet && setB != UnknownSet && "object sets should be known");
+  if (setA == setB) {
+    return true;
+  }
+  if (setA > setB) {
+    std::swap(setA, setB);
+  }
+
+  auto it = _mayAlias.find(std::make_pair(setA, setB));
+  if (it != _mayAlias.end()) {
+    return it->second;
+  }
+
+  const auto &objectsA = _sets[setA];
+  const auto &objectsB = _sets[setB];
+  auto result = objectsA.intersects(objectsB) ||
+                (objectsA.test(_escapedObject) && objectsB.intersects(_escaped)) ||
+                (objectsB.test(_escapedObject) && objectsA.intersects(_escaped));
+  _mayAlias[std::make_pair(setA, setB)] = result;
+  return result;
+}
+
+const AndersonAAResult::ObjectSets::ObjectSet& AndersonAAResult::ObjectSets::GetClosure(unsigned setId) noexcept {
+  auto it = _closures.find(setId);
+  if (it != _closures.end()) {
+    return it->second;
+  }
+
+  ObjectSet closure;
+  llvm::SmallVector<unsigned, 8> stack;
+  for (auto object : _sets[setId]) {
+    if (object == _escapedObject) {
+      closure |= _escaped;
+    } else if (closure.test_and_set(object)) {
+      stack.push_back(object);
+    }
+  }
+  while (!stack.empty()) {
+    auto object = stack.pop_back_val();
+    auto contentsIt = _contents.find(object);
+    if (contentsIt == _contents.end()) {
+      continue;
+    }
+    for (auto content : contentsIt->second) {
+      if (closure.test_and_set(content)) {
+        stack.push_back(content);
+      }
+    }
+  }
+
+  return _closures[setId] = std::move(closure);
+}
+
+bool AndersonAAResult::ObjectSets::MayBeAccessedBy(unsigned setId, const llvm::CallBase &call) noexcept {
+  assert(setId != UnknownSet && "object set should be known");
+
+  const auto &objects = _sets[setId];
+  if (objects.test(_escapedObject) || objects.intersects(_escaped)) {
+    return true;
+  }
+
+  for (const auto &operand : call.data_ops()) {
+    auto value = operand.get();
+    if (!value->getType()->isPointerTy()) {
+      if (ContainsPointer(value->getType())) {
+        return true;
+      }
+      continue;
+    }
+    if (llvm::isa<llvm::ConstantPointerNull>(value) || llvm::isa<llvm::UndefValue>(value)) {
+      continue;
+    }
+
+    auto operandSetId = GetSetId(value);
+    if (operandSetId == UnknownSet || objects.intersects(GetClosure(operandSetId))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::vector<llvm::BitVector> AndersonAAResult::ObjectSets::GetAliasMatrix(
+    llvm::ArrayRef<const llvm::Value *> pointers) noexcept {
+  auto numPointers = static_cast<unsigned>(pointers.size());
+
+  // Invert the object sets: for each object, the pointers that may point into it.
+  std::vector<unsigned> setIds;
+  setIds.reserve(numPointers);
+  llvm::BitVector unknown { numPointers };
+  llvm::BitVector tainted { numPointers };
+  llvm::BitVector escaping { numPointers };
+  llvm::DenseMap<unsigned, llvm::BitVector> members;
+  for (unsigned i = 0; i < numPointers; ++i) {
+    auto setId = GetSetId(pointers[i]);
+    setIds.push_back(setId);
+    if (setId == UnknownSet) {
+      unknown.set(i);
+      continue;
+    }
+
+    const auto &objects = _sets[setId];
+    for (auto object : objects) {
+      if (object == _escapedObject) {
+        tainted.set(i);
+        continue;
+      }
+      auto &objectMembers = members[object];
+      if (objectMembers.empty()) {
+        objectMembers.resize(numPointers);
+      }
+      objectMembers.set(i);
+    }
+    if (objects.intersects(_escaped)) {
+      escaping.set(i);
+    }
+  }
+
+  // Pointers with the same object set share the same row.
+  std::vector<llvm::BitVector> matrix;
+  matrix.reserve(numPointers);
+  llvm::DenseMap<unsigned, unsigned> firstRows;
+  for (unsigned i = 0; i < numPointers; ++i) {
+    auto setId = setIds[i];
+    if (setId == UnknownSet) {
+      matrix.emplace_back(numPointers, true);
+      continue;
+    }
+
+    auto it = firstRows.find(setId);
+    if (it != firstRows.end()) {
+      matrix.push_back(matrix[it->second]);
+      continue;
+    }
+    firstRows[setId] = i;
+
+    llvm::BitVector row { numPointers };
+    for (auto object : _sets[setId]) {
+      if (object != _escapedObject) {
+        row |= members[object];
+      }
+    }
+    if (tainted.test(i)) {
+      row |= tainted;
+      row |= escaping;
+    }
+    if (escaping.test(i)) {
+      row |= tainted;
+    }
+    row |= unknown;
+    matrix.push_back(std::move(row));
+  }
+
+  return matrix;
+}
+
+std::vector<unsigned> AndersonAAResult::ObjectSets::GetAliasClasses(
+    llvm::ArrayRef<const llvm::Value *> pointers) noexcept {
+  auto numPointers = static_cast<unsigned>(pointers.size());
+  if (!numPointers) {
+    return { };
+  }
+
+  // Join each pointer with the first pointer into each of its objects. Tainted pointers may alias every escaped object,
+  // so once there is a tainted pointer, all pointers into escaped objects end up in the same class.
+  llvm::IntEqClasses classes { numPointers };
+  llvm::DenseMap<unsigned, unsigned> firstMembers;
+  auto firstUnknown = numPointers;
+  auto firstTainted = numPointers;
+  std::vector<unsigned> escaping;
+  for (unsigned i = 0; i < numPointers; ++i) {
+    auto setId = GetSetId(pointers[i]);
+    if (setId == UnknownSet) {
+      if (firstUnknown == numPointers) {
+        firstUnknown = i;
+      }
+      classes.join(firstUnknown, i);
+      continue;
+    }
+
+    const auto &objects = _sets[setId];
+    for (auto object : objects) {
+      if (object == _escapedObject) {
+        if (firstTainted == numPointers) {
+          firstTainted = i;
+        }
+        classes.join(firstTainted, i);
+        continue;
+      }
+      auto it = firstMembers.try_emplace(object, i).first;
+      classes.join(it->second, i);
+    }
+    if (objects.intersects(_escaped)) {
+      escaping.push_back(i);
+    }
+  }
+  if (firstTainted != numPointers) {
+    for (auto i : escaping) {
+      classes.join(firstTainted, i);
+    }
+  }
+  if (firstUnknown != numPointers) {
+    for (unsigned i = 0; i < numPointers; ++i) {
+      classes.join(firstUnknown, i);
+    }
+  }
+
+  classes.compress();
+  std::vector<unsigned> result;
+  result.reserve(numPointers);
+  for (unsigned i = 0; i < numPointers; ++i) {
+    result.push_back(classes[i]);
+  }
+  return result;
+}
+
+AndersonAAResult::AndersonAAResult(const llvm::Module &module, const ValueTree &valueTree) noexcept
+  : llvm::AAResultBase<AndersonAAResult> { },
+    _objectSets(std::make_unique<ObjectSets>(module, valueTree))
+{ }
+
+AndersonAAResult::AndersonAAResult(AndersonAAResult &&) noexcept = default;
+
+AndersonAAResult::~AndersonAAResult() noexcept = default;
+
+bool AndersonAAResult::invalidate(llvm::Module &,
+                                  const llvm::PreservedAnalyses &preserved,
+                                  llvm::ModuleAnalysisManager::Invalidator &) noexcept {
+  return !preserved.getChecker<AndersonAA>().preservedWhenStateless();
+}
+
+llvm::AliasResult AndersonAAResult::alias(const llvm::MemoryLocation &locA,
+                                          const llvm::MemoryLocation &locB,
+                                          llvm::AAQueryInfo &queryInfo) noexcept {
+  auto setA = _objectSets->GetSetId(locA.Ptr);
+  auto setB = _objectSets->GetSetId(locB.Ptr);
+  if (setA == ObjectSets::UnknownSet || setB == ObjectSets::UnknownSet || _objectSets->MayAlias(setA, setB)) {
+    return AAResultBase::alias(locA, locB, queryInfo);
+  }
+  return llvm::AliasResult::NoAlias;
+}
+
+llvm::ModRefInfo AndersonAAResult::getModRefInfo(const llvm::CallBase *call,
+                                                 const llvm::MemoryLocation &loc,
+                                                 llvm::AAQueryInfo &queryInfo) noexcept {
+  auto setId = _objectSets->GetSetId(loc.Ptr);
+  if (setId == ObjectSets::UnknownSet || _objectSets->MayBeAccessedBy(setId, *call)) {
+    return AAResultBase::getModRefInfo(call, loc, queryInfo);
+  }
+  return llvm::ModRefInfo::NoModRef;
+}
+
+std::vector<llvm::BitVector> AndersonAAResult::GetAliasMatrix(llvm::ArrayRef<const llvm::Value *> pointers) noexcept {
+  return _objectSets->GetAliasMatrix(pointers);
+}
+
+std::vector<unsigned> AndersonAAResult::GetAliasClasses(llvm::ArrayRef<const llvm::Value *> pointers) noexcept {
+  return _objectSets->GetAliasClasses(pointers);
+}
+
+llvm::AnalysisKey AndersonAA::Key;
+
+AndersonAA::Result AndersonAA::run(llvm::Module &module, llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  auto &pointsTo = moduleAnalysisManager.getResult<AndersonAnalysis>(module);
+  return Result { module, *pointsTo.GetValueTree() };
+}
+
+} // namespace anderson
+
+} // namespace llvm
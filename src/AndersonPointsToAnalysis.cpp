@@ -3,11 +3,37 @@
 //
 
 #include "llvm-anderson/AndersonPointsToAnalysis.h"
-
+#include "llvm-anderson/AndersonAliasAnalysis.h"
+#include "llvm-anderson/ConstraintSummary.h"
+#include "llvm-anderson/EscapeAnalysis.h"
+#include "llvm-anderson/ModRefSummary.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/Config/llvm-config.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
-
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/PassPlugin.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TimeProfiler.h>
+
+#include "ExternalSummaries.h"
+#include "IncrementalSolver.h"
 #include "PointsToSolver.h"
+#include "Reachability.h"
+#include "SolutionCache.h"
+#include "SolverProfile.h"
+#include "SolverVerifier.h"
 
 namespace llvm {
 
@@ -15,6 +41,148 @@ namespace anderson {
 
 namespace {
 
+llvm::cl::opt<std::string> CacheDirectory { // NOLINT(cert-err58-cpp)
+  "anderson-cache-dir",
+  llvm::cl::desc("Directory of the on-disk cache of solved points-to relations; caching is disabled if empty"),
+  llvm::cl::value_desc("directory"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<std::string> CachePolicy { // NOLINT(cert-err58-cpp)
+  "anderson-cache-policy",
+  llvm::cl::desc("Pruning policy of the points-to cache, e.g. \"prune_after=24h:cache_size_bytes=1g\""),
+  llvm::cl::value_desc("policy"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<bool> Incremental { // NOLINT(cert-err58-cpp)
+  "anderson-incremental",
+  llvm::cl::desc("Keep the constraint graph after solving so that later runs only re-solve the changed functions"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<std::string> SummaryOutput { // NOLINT(cert-err58-cpp)
+  "anderson-summary-out",
+  llvm::cl::desc("Write the local constraint summary of the module to the specified file for llvm-anderson-link"),
+  llvm::cl::value_desc("path"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<bool> ReverseIndex { // NOLINT(cert-err58-cpp)
+  "anderson-reverse-index",
+  llvm::cl::desc("Build the reverse points-to index from pointees to the pointers that may point to them after solving"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<bool> Steensgaard { // NOLINT(cert-err58-cpp)
+  "anderson-steensgaard",
+  llvm::cl::desc("Partition the constraints into independent regions with a unification pre-pass and solve them one "
+                 "by one; regions over the budget fall back to the unification result"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<bool> Verify { // NOLINT(cert-err58-cpp)
+  "anderson-verify",
+  llvm::cl::desc("Check the solutions loaded from the cache or updated incrementally against a fresh solve"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<std::string> ProfileOutput { // NOLINT(cert-err58-cpp)
+  "anderson-profile-out",
+  llvm::cl::desc("Write a JSON profile of the solved constraint graph and of the solver to the specified file"),
+  llvm::cl::value_desc("path"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<unsigned> ProfileLimit { // NOLINT(cert-err58-cpp)
+  "anderson-profile-limit",
+  llvm::cl::desc("Number of entries of each ranking in the profile"),
+  llvm::cl::init(20)
+};
+
+llvm::cl::opt<std::string> DotOutput { // NOLINT(cert-err58-cpp)
+  "anderson-dot-out",
+  llvm::cl::desc("Write the constraint graph around the pointer named by -anderson-dot-root to the specified DOT file"),
+  llvm::cl::value_desc("path"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<std::string> DotRoot { // NOLINT(cert-err58-cpp)
+  "anderson-dot-root",
+  llvm::cl::desc("Name of the pointer at the center of the DOT export, e.g. \"main.%p\""),
+  llvm::cl::value_desc("name"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<unsigned> DotDepth { // NOLINT(cert-err58-cpp)
+  "anderson-dot-depth",
+  llvm::cl::desc("Maximal number of constraints between a pointer in the DOT export and the center"),
+  llvm::cl::init(2)
+};
+
+llvm::cl::opt<unsigned> TimeBudget { // NOLINT(cert-err58-cpp)
+  "anderson-time-budget",
+  llvm::cl::desc("Stop solving after the specified number of milliseconds and mark the unsolved pointers as unknown"),
+  llvm::cl::value_desc("ms"),
+  llvm::cl::init(0)
+};
+
+llvm::cl::opt<unsigned> MemoryBudget { // NOLINT(cert-err58-cpp)
+  "anderson-memory-budget",
+  llvm::cl::desc("Stop solving once the heap has grown by the specified number of MiB and mark the unsolved pointers "
+                 "as unknown"),
+  llvm::cl::value_desc("MiB"),
+  llvm::cl::init(0)
+};
+
+llvm::cl::opt<WorklistOrder> WorklistOrderOption { // NOLINT(cert-err58-cpp)
+  "anderson-worklist-order",
+  llvm::cl::desc("Order in which the worklist solver pops the pointers off the worklist. Requesting an order solves "
+                 "with the worklist solver instead of the default exhaustive solver, or with the partitioned solver "
+                 "under -anderson-steensgaard"),
+  llvm::cl::values(
+      clEnumValN(WorklistOrder::Fifo, "fifo", "Pop the pointer enqueued first"),
+      clEnumValN(WorklistOrder::Lifo, "lifo", "Pop the pointer enqueued last"),
+      clEnumValN(WorklistOrder::Lrf, "lrf", "Pop the pointer relaxed least recently"),
+      clEnumValN(WorklistOrder::Topological, "topo",
+                 "Pop the pointer that comes first in the topological order of the collapsed copy graph"),
+      clEnumValN(WorklistOrder::TwoPhase, "two-phase",
+                 "Relax the worklist in rounds, each least recently relaxed first")),
+  llvm::cl::init(WorklistOrder::Fifo)
+};
+
+llvm::cl::opt<TypeFilterMode> TypeFilterOption { // NOLINT(cert-err58-cpp)
+  "anderson-type-filter",
+  llvm::cl::desc("Filter the pointees reached by loads and stores by their types"),
+  llvm::cl::values(
+      clEnumValN(TypeFilterMode::None, "none", "Apply no type check"),
+      clEnumValN(TypeFilterMode::Strict, "strict",
+                 "Reject the pointees whose pointer type is incompatible with the accessed type; unsound if pointers "
+                 "are accessed through pointers of unrelated types")),
+  llvm::cl::init(TypeFilterMode::None)
+};
+
+llvm::cl::list<std::string> EntryPoints { // NOLINT(cert-err58-cpp)
+  "anderson-entry-points",
+  llvm::cl::desc("Only analyze the functions and global variables reachable from the specified functions"),
+  llvm::cl::value_desc("function"),
+  llvm::cl::CommaSeparated
+};
+
+llvm::cl::opt<bool> DefaultExternalSummaries { // NOLINT(cert-err58-cpp)
+  "anderson-default-summaries",
+  llvm::cl::desc("Model calls to common C and C++ library functions by their built-in summaries"),
+  llvm::cl::init(true)
+};
+
+llvm::cl::list<std::string> ExternalSummaryFiles { // NOLINT(cert-err58-cpp)
+  "anderson-external-summaries",
+  llvm::cl::desc("Model calls to external functions by the summaries in the specified files, which take precedence "
+                 "over the built-in ones"),
+  llvm::cl::value_desc("path"),
+  llvm::cl::CommaSeparated
+};
+
 template <typename Instruction>
 struct PointerInstructionHandler { };
 
@@ -26,7 +194,39 @@ struct PointerInstructionHandler<llvm::AllocaInst> {
     assert(pointerNode->isPointer());
 
     auto allocatedMemoryNode = solver.GetValueTree()->GetAllocaMemoryNode(&inst);
-    pointerNode->pointer()->AssignedAddressOf(allocatedMemoryNode->pointee());
+    solver.AddAssignedAddressOf(pointerNode->pointer(), allocatedMemoryNode->pointee());
+  }
+};
+
+template <>
+struct PointerInstructionHandler<llvm::BitCastInst> {
+  static void Handle(PointsToSolver &solver, const llvm::BitCastInst &inst) noexcept {
+    HandlePointerCast(solver, inst);
+  }
+
+  static void HandlePointerCast(PointsToSolver &solver, const llvm::CastInst &inst) noexcept {
+    if (!inst.getType()->isPointerTy() || !inst.getSrcTy()->isPointerTy()) {
+      return;
+    }
+
+    auto resultPtrValue = static_cast<const llvm::Value *>(&inst);
+    auto resultPtrNode = solver.GetValueTree()->GetValueNode(resultPtrValue);
+    auto sourcePtrNode = solver.GetValueTree()->GetValueNode(inst.getOperand(0));
+    assert(resultPtrNode->isPointer());
+    if (!sourcePtrNode) {
+      // Casts of constants other than global values are not modeled.
+      return;
+    }
+    assert(sourcePtrNode->isPointer());
+
+    solver.AddAssignedPointer(resultPtrNode->pointer(), sourcePtrNode->pointer());
+  }
+};
+
+template <>
+struct PointerInstructionHandler<llvm::AddrSpaceCastInst> {
+  static void Handle(PointsToSolver &solver, const llvm::AddrSpaceCastInst &inst) noexcept {
+    PointerInstructionHandler<llvm::BitCastInst>::HandlePointerCast(solver, inst);
   }
 };
 
@@ -37,10 +237,22 @@ struct PointerInstructionHandler<llvm::CallInst> {
       return;
     }
 
-    auto function = inst.getFunction();
+    auto callee = inst.getCalledFunction();
+    if (!callee) {
+      // Indirect calls are not modeled.
+      return;
+    }
 
-    for (unsigned i = 0; i < inst.getNumArgOperands(); ++i) {
-      auto param = function->getArg(i);
+    auto summaries = solver.GetValueTree()->GetExternalSummaries();
+    if (auto summary = summaries ? summaries->GetCalleeSummary(inst) : nullptr) {
+      HandleSummary(solver, inst, *summary);
+      return;
+    }
+
+    // Arguments passed through the variable argument list of the callee are not modeled.
+    auto numParams = std::min(static_cast<size_t>(inst.arg_size()), callee->arg_size());
+    for (unsigned i = 0; i < numParams; ++i) {
+      auto param = callee->getArg(i);
       if (!param->getType()->isPointerTy()) {
         continue;
       }
@@ -50,22 +262,75 @@ struct PointerInstructionHandler<llvm::CallInst> {
       auto paramNode = solver.GetValueTree()->GetValueNode(param);
       auto argNode = solver.GetValueTree()->GetValueNode(arg);
       assert(paramNode->isPointer());
+      if (!argNode) {
+        // Constants other than global values are not modeled.
+        continue;
+      }
       assert(argNode->isPointer());
 
-      paramNode->pointer()->AssignedPointer(argNode->pointer());
+      solver.AddAssignedPointer(paramNode->pointer(), argNode->pointer());
     }
 
-    if (!function->getReturnType()->isPointerTy()) {
+    if (!callee->getReturnType()->isPointerTy()) {
       return;
     }
 
     auto returnPtrValue = static_cast<const llvm::Value *>(&inst);
     auto returnPtrNode = solver.GetValueTree()->GetValueNode(returnPtrValue);
-    auto functionReturnValueNode = solver.GetValueTree()->GetFunctionReturnValueNode(function);
+    auto functionReturnValueNode = solver.GetValueTree()->GetFunctionReturnValueNode(callee);
     assert(functionReturnValueNode->isPointer());
     assert(returnPtrNode->isPointer());
 
-    returnPtrNode->pointer()->AssignedPointer(functionReturnValueNode->pointer());
+    solver.AddAssignedPointer(returnPtrNode->pointer(), functionReturnValueNode->pointer());
+  }
+
+  static void HandleSummary(PointsToSolver &solver, const llvm::CallInst &inst,
+                            const ExternalSummary &summary) noexcept {
+    auto valueTree = solver.GetValueTree();
+    auto returnPtrNode = inst.getType()->isPointerTy() ? valueTree->GetValueNode(&inst) : nullptr;
+
+    for (const auto &effect : summary.effects) {
+      if (effect.kind == ExternalEffect::Kind::ReturnsNew) {
+        auto heapMemoryNode = valueTree->GetHeapMemoryNode(&inst);
+        assert(returnPtrNode && heapMemoryNode);
+        solver.AddAssignedAddressOf(returnPtrNode->pointer(), heapMemoryNode->pointee());
+        continue;
+      }
+
+      auto sourcePtrNode = valueTree->GetValueNode(inst.getArgOperand(effect.source));
+      if (!sourcePtrNode) {
+        // Constants other than global values are not modeled.
+        continue;
+      }
+      assert(sourcePtrNode->isPointer());
+
+      switch (effect.kind) {
+        case ExternalEffect::Kind::ReturnsArgument:
+          solver.AddAssignedPointer(returnPtrNode->pointer(), sourcePtrNode->pointer());
+          break;
+        case ExternalEffect::Kind::ReturnsArgumentPointee:
+          solver.AddAssignedPointee(returnPtrNode->pointer(), sourcePtrNode->pointer());
+          break;
+        case ExternalEffect::Kind::StoresArgument: {
+          auto targetPtrNode = valueTree->GetValueNode(inst.getArgOperand(effect.target));
+          if (targetPtrNode) {
+            assert(targetPtrNode->isPointer());
+            solver.AddPointeeAssigned(targetPtrNode->pointer(), sourcePtrNode->pointer());
+          }
+          break;
+        }
+        case ExternalEffect::Kind::CopiesArgumentPointee: {
+          auto targetPtrNode = valueTree->GetValueNode(inst.getArgOperand(effect.target));
+          if (targetPtrNode) {
+            assert(targetPtrNode->isPointer());
+            solver.AddPointeeCopied(targetPtrNode->pointer(), sourcePtrNode->pointer());
+          }
+          break;
+        }
+        default:
+          llvm_unreachable("unexpected external effect kind");
+      }
+    }
   }
 };
 
@@ -82,12 +347,16 @@ struct PointerInstructionHandler<llvm::ExtractValueInst> {
 
     auto sourceValue = inst.getAggregateOperand();
     auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourceValue);
+    if (!sourcePtrNode) {
+      // Constants other than global values are not modeled.
+      return;
+    }
     for (auto index : inst.indices()) {
       sourcePtrNode = sourcePtrNode->GetChild(static_cast<size_t>(index));
     }
     assert(sourcePtrNode->isPointer());
 
-    targetPtrNode->pointer()->AssignedPointer(sourcePtrNode->pointer());
+    solver.AddAssignedPointer(targetPtrNode->pointer(), sourcePtrNode->pointer());
   }
 };
 
@@ -100,6 +369,10 @@ struct PointerInstructionHandler<llvm::GetElementPtrInst> {
 
     auto sourcePtrValue = inst.getPointerOperand();
     auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourcePtrValue);
+    if (!sourcePtrNode) {
+      // Constants other than global values are not modeled.
+      return;
+    }
     assert(sourcePtrNode->isPointer());
 
     std::vector<PointerIndex> indexSequence;
@@ -114,7 +387,7 @@ struct PointerInstructionHandler<llvm::GetElementPtrInst> {
       }
     }
 
-    targetPtrNode->pointer()->AssignedElementPtr(sourcePtrNode->pointer(), std::move(indexSequence));
+    solver.AddAssignedElementPtr(targetPtrNode->pointer(), sourcePtrNode->pointer(), std::move(indexSequence));
   }
 };
 
@@ -131,9 +404,13 @@ struct PointerInstructionHandler<llvm::LoadInst> {
     auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourcePtrValue);
 
     assert(resultPtrNode->isPointer());
+    if (!sourcePtrNode) {
+      // Constants other than global values are not modeled.
+      return;
+    }
     assert(sourcePtrNode->isPointer());
 
-    resultPtrNode->pointer()->AssignedPointee(sourcePtrNode->pointer());
+    solver.AddAssignedPointee(resultPtrNode->pointer(), sourcePtrNode->pointer());
   }
 };
 
@@ -151,9 +428,13 @@ struct PointerInstructionHandler<llvm::PHINode> {
     for (const auto &sourcePtrValueUse : phi.incoming_values()) {
       auto sourcePtrValue = sourcePtrValueUse.get();
       auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourcePtrValue);
+      if (!sourcePtrNode) {
+        // Constants other than global values are not modeled.
+        continue;
+      }
       assert(sourcePtrNode->isPointer());
 
-      resultPtrNode->pointer()->AssignedPointer(sourcePtrNode->pointer());
+      solver.AddAssignedPointer(resultPtrNode->pointer(), sourcePtrNode->pointer());
     }
   }
 };
@@ -162,17 +443,21 @@ template <>
 struct PointerInstructionHandler<llvm::ReturnInst> {
   static void Handle(PointsToSolver &solver, const llvm::ReturnInst &inst) noexcept {
     auto returnValue = inst.getReturnValue();
-    if (!returnValue->getType()->isPointerTy()) {
+    if (!returnValue || !returnValue->getType()->isPointerTy()) {
       return;
     }
 
     auto function = inst.getFunction();
     auto returnValueNode = solver.GetValueTree()->GetValueNode(returnValue);
     auto functionReturnValueNode = solver.GetValueTree()->GetFunctionReturnValueNode(function);
+    if (!returnValueNode) {
+      // Constants other than global values are not modeled.
+      return;
+    }
     assert(returnValueNode->isPointer());
     assert(functionReturnValueNode->isPointer());
 
-    functionReturnValueNode->pointer()->AssignedPointer(returnValueNode->pointer());
+    solver.AddAssignedPointer(functionReturnValueNode->pointer(), returnValueNode->pointer());
   }
 };
 
@@ -193,9 +478,13 @@ struct PointerInstructionHandler<llvm::SelectInst> {
     };
     for (auto sourcePtrValue : sourcePtrValues) {
       auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourcePtrValue);
+      if (!sourcePtrNode) {
+        // Constants other than global values are not modeled.
+        continue;
+      }
       assert(sourcePtrNode->isPointer());
 
-      resultPtrNode->pointer()->AssignedPointer(sourcePtrNode->pointer());
+      solver.AddAssignedPointer(resultPtrNode->pointer(), sourcePtrNode->pointer());
     }
   }
 };
@@ -212,15 +501,21 @@ struct PointerInstructionHandler<llvm::StoreInst> {
 
     auto targetPtrNode = solver.GetValueTree()->GetValueNode(targetPtrValue);
     auto sourcePtrNode = solver.GetValueTree()->GetValueNode(sourcePtrValue);
+    if (!targetPtrNode || !sourcePtrNode) {
+      // Constants other than global values are not modeled.
+      return;
+    }
     assert(targetPtrNode->isPointer());
     assert(sourcePtrNode->isPointer());
 
-    targetPtrNode->pointer()->PointeeAssigned(sourcePtrNode->pointer());
+    solver.AddPointeeAssigned(targetPtrNode->pointer(), sourcePtrNode->pointer());
   }
 };
 
 #define LLVM_POINTER_INST_LIST(H) \
+  H(AddrSpaceCastInst)            \
   H(AllocaInst)                   \
+  H(BitCastInst)                  \
   H(CallInst)                     \
   H(ExtractValueInst)             \
   H(GetElementPtrInst)            \
@@ -230,7 +525,14 @@ struct PointerInstructionHandler<llvm::StoreInst> {
   H(SelectInst)                   \
   H(StoreInst)
 
+} // namespace <anonymous>
+
 void UpdateAndersonSolverOnInst(PointsToSolver &solver, const llvm::Instruction &inst) noexcept {
+  if (!solver.GetValueTree()->GetValueNode(inst.getFunction())) {
+    // The function is unreachable from the entry points.
+    return;
+  }
+
 #define INST_DISPATCHER(instType)                                                                 \
   if (llvm::isa<llvm::instType>(inst)) {                                                          \
     PointerInstructionHandler<llvm::instType>::Handle(solver, llvm::cast<llvm::instType>(inst));  \
@@ -241,26 +543,327 @@ LLVM_POINTER_INST_LIST(INST_DISPATCHER)
 
 #undef LLVM_POINTER_INST_LIST
 
+namespace {
+
+std::unique_ptr<SolutionCache> CreateSolutionCache() noexcept {
+  if (CacheDirectory.empty()) {
+    return nullptr;
+  }
+
+  auto policy = llvm::parseCachePruningPolicy(CachePolicy);
+  if (!policy) {
+    llvm::errs() << "anderson: invalid cache policy: " << llvm::toString(policy.takeError()) << "\n";
+    return nullptr;
+  }
+
+  return std::make_unique<SolutionCache>(CacheDirectory, *policy);
+}
+
 } // namespace <anonymous>
 
+std::unique_ptr<ValueTree> SolveRequestedModule(const llvm::Module &module, SolverMode mode, bool keepConstraints,
+                                                SolverProgressObserver *observer,
+                                                const CancellationToken *cancellation) noexcept {
+  auto reportPhase = [observer](SolverPhase phase) noexcept {
+    if (observer) {
+      SolverProgress progress;
+      progress.phase = phase;
+      observer->OnProgress(progress);
+    }
+  };
+
+  reportPhase(SolverPhase::BuildValueTree);
+  auto valueTree = CreateRequestedValueTree(module);
+
+  // The summary is built from the constraints, so the cache is bypassed when a summary is requested.
+  auto cache = CreateSolutionCache();
+  std::string cacheKey;
+  if (cache) {
+    cacheKey = SolutionCache::ComputeKey(module, GetRequestedConfiguration());
+    if (!keepConstraints && SummaryOutput.empty() && !IsProfileRequested() && cache->Load(cacheKey, *valueTree)) {
+      if (Verify) {
+        VerifySolution(module, *valueTree, *SolveReference(module), llvm::errs());
+      }
+      if (ReverseIndex) {
+        valueTree->BuildReverseIndex();
+      }
+      reportPhase(SolverPhase::Done);
+      return valueTree;
+    }
+  }
+
+  PointsToSolver solver { module, std::move(valueTree) };
+  solver.SetProgressObserver(observer);
+  solver.SetCancellationToken(cancellation);
+
+  reportPhase(SolverPhase::GenerateConstraints);
+  auto cancelled = false;
+  {
+    llvm::TimeTraceScope timeScope { "AndersonConstraints" };
+    for (const auto &func : module) {
+      if (cancellation && cancellation->isCancelled()) {
+        cancelled = true;
+        break;
+      }
+      if (!solver.GetValueTree()->GetValueNode(&func)) {
+        continue;
+      }
+      for (const auto &bb : func) {
+        for (const auto &inst : bb) {
+          UpdateAndersonSolverOnInst(solver, inst);
+        }
+      }
+    }
+  }
+
+  if (cancelled) {
+    // Some constraints are missing, so no points-to set can be trusted.
+    solver.Abandon();
+  } else if (!SummaryOutput.empty()) {
+    solver.AddTrivialPointerAssignments();
+    auto summary = ConstraintSummary::Build(module, *solver.GetValueTree());
+    if (!summary->WriteFile(SummaryOutput)) {
+      llvm::errs() << "anderson: cannot write constraint summary to " << SummaryOutput << "\n";
+    }
+  }
+
+  SolverProfile profile;
+  if (IsProfileRequested()) {
+    solver.SetProfile(&profile);
+  }
+  solver.SetBudget(GetRequestedBudget());
+  solver.SetWorklistOrder(GetRequestedWorklistOrder());
+  solver.SetTypeFilter(GetRequestedTypeFilter());
+  if (!cancelled) {
+    solver.Solve(mode);
+  }
+  if (cancellation && cancellation->isCancelled()) {
+    llvm::errs() << "anderson: analysis of module " << module.getName()
+                 << " cancelled, the points-to sets of some pointers are unknown\n";
+  } else if (solver.GetValueTree()->isDegraded()) {
+    llvm::errs() << "anderson: solver budget exceeded on module " << module.getName()
+                 << ", the points-to sets of some pointers are unknown\n";
+  } else if (solver.GetValueTree()->isApproximate()) {
+    llvm::errs() << "anderson: solver budget exceeded on module " << module.getName()
+                 << ", the points-to sets of some regions are approximated by unification\n";
+  }
+  if (IsProfileRequested()) {
+    solver.SetProfile(nullptr);
+    WriteRequestedProfile(module, *solver.GetValueTree(), profile);
+  }
+
+  valueTree = solver.TakeValueTree();
+  if (cache) {
+    cache->Store(cacheKey, *valueTree);
+  }
+  if (ReverseIndex) {
+    valueTree->BuildReverseIndex();
+  }
+
+  return valueTree;
+}
+
+std::string GetNodeName(const ValueTreeNode &node, llvm::ModuleSlotTracker &slotTracker) noexcept {
+  std::vector<size_t> path;
+  auto root = &node;
+  while (!root->isRoot()) {
+    path.push_back(root->offset());
+    root = root->parent();
+  }
+
+  std::string name;
+  llvm::raw_string_ostream os { name };
+  switch (root->kind()) {
+    case ValueKind::Normal:
+      break;
+    case ValueKind::StackMemory:
+      os << "stack:";
+      break;
+    case ValueKind::GlobalMemory:
+      os << "global:";
+      break;
+    case ValueKind::ArgumentMemory:
+      os << "argmem:";
+      break;
+    case ValueKind::FunctionReturnValue:
+      os << "ret:";
+      break;
+    case ValueKind::HeapMemory:
+      os << "heap:";
+      break;
+  }
+
+  auto value = root->value();
+  if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+    os << arg->getParent()->getName() << ".";
+  } else if (auto inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+    os << inst->getFunction()->getName() << ".";
+  }
+  value->printAsOperand(os, false, slotTracker);
+
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    os << "[" << *it << "]";
+  }
+
+  return os.str();
+}
+
+SolverBudget GetRequestedBudget() noexcept {
+  SolverBudget budget;
+  budget.time = std::chrono::milliseconds { TimeBudget.getValue() };
+  budget.memory = static_cast<size_t>(MemoryBudget.getValue()) * 1024 * 1024;
+  return budget;
+}
+
+WorklistOrder GetRequestedWorklistOrder() noexcept {
+  return WorklistOrderOption.getValue();
+}
+
+bool IsWorklistOrderRequested() noexcept {
+  return WorklistOrderOption.getNumOccurrences() > 0;
+}
+
+SolverMode GetRequestedSolverMode() noexcept {
+  if (Steensgaard) {
+    return SolverMode::Partitioned;
+  }
+  return IsWorklistOrderRequested() ? SolverMode::Worklist : SolverMode::Exhaustive;
+}
+
+std::unique_ptr<ValueTree> CreateRequestedValueTree(const llvm::Module &module) noexcept {
+  if (EntryPoints.empty()) {
+    return std::make_unique<ValueTree>(module, nullptr, GetRequestedExternalSummaries());
+  }
+  auto reachable = ComputeReachableGlobals(module, EntryPoints);
+  return std::make_unique<ValueTree>(module, &reachable, GetRequestedExternalSummaries());
+}
+
+std::vector<std::string> GetRequestedEntryPoints() noexcept {
+  return { EntryPoints.begin(), EntryPoints.end() };
+}
+
+const ExternalSummaries* GetRequestedExternalSummaries() noexcept {
+  if (!DefaultExternalSummaries && ExternalSummaryFiles.empty()) {
+    return nullptr;
+  }
+
+  // The summaries are read once for each combination of the options, and shared by every module analyzed by the
+  // process. Value trees keep pointers to them, so they are never freed.
+  static std::mutex mutex;
+  static std::map<std::pair<bool, std::vector<std::string>>, std::unique_ptr<ExternalSummaries>> summaries;
+  std::lock_guard<std::mutex> lock { mutex };
+  auto &result = summaries[{ DefaultExternalSummaries, { ExternalSummaryFiles.begin(), ExternalSummaryFiles.end() } }];
+  if (!result) {
+    result = std::make_unique<ExternalSummaries>();
+    if (DefaultExternalSummaries) {
+      *result = ExternalSummaries::CreateDefault();
+    }
+    for (const auto &path : ExternalSummaryFiles) {
+      result->ReadFile(path, llvm::errs());
+    }
+  }
+  return result.get();
+}
+
+std::string GetRequestedConfiguration() noexcept {
+  std::string configuration = "type-filter=" + std::to_string(static_cast<int>(TypeFilterOption.getValue()));
+  if (!EntryPoints.empty()) {
+    configuration += ";entry-points=";
+    for (const auto &entryPoint : EntryPoints) {
+      configuration += entryPoint + ",";
+    }
+  }
+  if (auto summaries = GetRequestedExternalSummaries()) {
+    llvm::raw_string_ostream os { configuration };
+    os << ";external-summaries=\n";
+    summaries->Print(os);
+  }
+  return configuration;
+}
+
+TypeFilterMode GetRequestedTypeFilter() noexcept {
+  return TypeFilterOption.getValue();
+}
+
+bool IsProfileRequested() noexcept {
+  return !ProfileOutput.empty() || !DotOutput.empty();
+}
+
+void WriteRequestedProfile(const llvm::Module &module, const ValueTree &valueTree,
+                           const SolverProfile &profile) noexcept {
+  if (!ProfileOutput.empty()) {
+    std::error_code ec;
+    llvm::raw_fd_ostream os { ProfileOutput, ec, llvm::sys::fs::OF_None };
+    if (ec) {
+      llvm::errs() << "anderson: cannot write profile to " << ProfileOutput << ": " << ec.message() << "\n";
+    } else {
+      profile.WriteJSON(os, module, valueTree, ProfileLimit);
+    }
+  }
+
+  if (!DotOutput.empty()) {
+    std::error_code ec;
+    llvm::raw_fd_ostream os { DotOutput, ec, llvm::sys::fs::OF_None };
+    if (ec) {
+      llvm::errs() << "anderson: cannot write constraint graph to " << DotOutput << ": " << ec.message() << "\n";
+    } else if (!WriteConstraintGraphDOT(os, module, valueTree, DotRoot, DotDepth)) {
+      llvm::errs() << "anderson: no pointer named \"" << DotRoot << "\"\n";
+    }
+  }
+}
+
 char AndersonPointsToAnalysis::ID = 0;
 
+AndersonPointsToAnalysis::AndersonPointsToAnalysis() noexcept
+  : llvm::ModulePass { ID },
+    _valueTree(nullptr),
+    _incrementalSolver(nullptr),
+    _observer(nullptr),
+    _cancellation(nullptr)
+{ }
+
+AndersonPointsToAnalysis::~AndersonPointsToAnalysis() noexcept = default;
+
 bool AndersonPointsToAnalysis::runOnModule(llvm::Module &module) {
-  PointsToSolver solver { module };
+  if (_incrementalSolver) {
+    Update(module);
+    return false;
+  }
 
-  for (const auto &func : module) {
-    for (const auto &bb : func) {
-      for (const auto &inst : bb) {
-        UpdateAndersonSolverOnInst(solver, inst);
-      }
-    }
+  _valueTree = SolveRequestedModule(module, GetRequestedSolverMode(), Incremental, _observer, _cancellation);
+
+  if (Incremental) {
+    _incrementalSolver = std::make_unique<IncrementalSolver>();
+    _incrementalSolver->Initialize(module, *_valueTree, GetRequestedEntryPoints());
   }
-  solver.Solve();
 
-  _valueTree = solver.TakeValueTree();
   return false;  // The module is not modified by this pass.
 }
 
+void AndersonPointsToAnalysis::Update(llvm::Module &module) noexcept {
+  if (!_incrementalSolver || !_valueTree) {
+    _valueTree = nullptr;
+    _incrementalSolver = nullptr;
+    runOnModule(module);
+    return;
+  }
+
+  _valueTree = _incrementalSolver->Update(module, std::move(_valueTree));
+  if (!_valueTree) {
+    // The change cannot be handled incrementally; solve the module from scratch.
+    _incrementalSolver = nullptr;
+    runOnModule(module);
+    return;
+  }
+
+  if (Verify) {
+    VerifySolution(module, *_valueTree, *SolveReference(module), llvm::errs());
+  }
+  if (ReverseIndex && !_valueTree->hasReverseIndex()) {
+    _valueTree->BuildReverseIndex();
+  }
+}
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
 static llvm::RegisterPass<AndersonPointsToAnalysis> RegisterAnderson { // NOLINT(cert-err58-cpp)
@@ -271,6 +874,135 @@ static llvm::RegisterPass<AndersonPointsToAnalysis> RegisterAnderson { // NOLINT
 };
 #pragma clang diagnostic pop
 
+bool AndersonPointsToResult::invalidate(llvm::Module &,
+                                        const llvm::PreservedAnalyses &preserved,
+                                        llvm::ModuleAnalysisManager::Invalidator &) noexcept {
+  auto checker = preserved.getChecker<AndersonAnalysis>();
+  return !checker.preserved() && !checker.preservedSet<llvm::AllAnalysesOn<llvm::Module>>();
+}
+
+void AndersonPointsToResult::print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+
+  for (size_t id = 0; id < _valueTree->GetNumNodes(); ++id) {
+    auto node = _valueTree->GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    if (node->pointer()->isUnknown()) {
+      os << GetNodeName(*node, slotTracker) << " -> unknown\n";
+      continue;
+    }
+    if (!node->pointer()->GetPointeeSet().size()) {
+      continue;
+    }
+
+    std::set<std::string> pointees;
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      pointees.insert(GetNodeName(*pointee->node(), slotTracker));
+    }
+
+    os << GetNodeName(*node, slotTracker) << " ->";
+    for (const auto &pointee : pointees) {
+      os << " " << pointee;
+    }
+    os << "\n";
+  }
+}
+
+llvm::AnalysisKey AndersonAnalysis::Key;
+
+AndersonAnalysis::Result AndersonAnalysis::run(llvm::Module &module, llvm::ModuleAnalysisManager &) noexcept {
+  return Result { SolveRequestedModule(module, GetRequestedSolverMode(), false, _observer, _cancellation) };
+}
+
+llvm::PreservedAnalyses AndersonPrinterPass::run(llvm::Module &module,
+                                                 llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  _os << "Anderson points-to sets for module '" << module.getName() << "':\n";
+  moduleAnalysisManager.getResult<AndersonAnalysis>(module).print(_os, module);
+  return llvm::PreservedAnalyses::all();
+}
+
 } // namespace anderson
 
 } // namespace llvm
+
+extern "C" LLVM_ATTRIBUTE_WEAK llvm::PassPluginLibraryInfo llvmGetPassPluginInfo() {
+  return {
+    LLVM_PLUGIN_API_VERSION, "anderson", LLVM_VERSION_STRING,
+    [](llvm::PassBuilder &passBuilder) {
+      passBuilder.registerAnalysisRegistrationCallback([](llvm::ModuleAnalysisManager &moduleAnalysisManager) {
+        moduleAnalysisManager.registerPass([] {
+          return llvm::anderson::AndersonAnalysis { };
+        });
+        moduleAnalysisManager.registerPass([] {
+          return llvm::anderson::AndersonAA { };
+        });
+        moduleAnalysisManager.registerPass([] {
+          return llvm::anderson::AndersonModRefAnalysis { };
+        });
+        moduleAnalysisManager.registerPass([] {
+          return llvm::anderson::AndersonEscapeAnalysis { };
+        });
+      });
+      passBuilder.registerParseAACallback([](llvm::StringRef name, llvm::AAManager &aaManager) {
+        if (name == "anderson-aa") {
+          aaManager.registerModuleAnalysis<llvm::anderson::AndersonAA>();
+          return true;
+        }
+        return false;
+      });
+      passBuilder.registerPipelineParsingCallback(
+          [](llvm::StringRef name, llvm::ModulePassManager &modulePassManager,
+             llvm::ArrayRef<llvm::PassBuilder::PipelineElement>) {
+            if (name == "require<anderson>") {
+              modulePassManager.addPass(llvm::RequireAnalysisPass<llvm::anderson::AndersonAnalysis, llvm::Module> { });
+              return true;
+            }
+            if (name == "invalidate<anderson>") {
+              modulePassManager.addPass(llvm::InvalidateAnalysisPass<llvm::anderson::AndersonAnalysis> { });
+              return true;
+            }
+            if (name == "require<anderson-aa>") {
+              modulePassManager.addPass(llvm::RequireAnalysisPass<llvm::anderson::AndersonAA, llvm::Module> { });
+              return true;
+            }
+            if (name == "invalidate<anderson-aa>") {
+              modulePassManager.addPass(llvm::InvalidateAnalysisPass<llvm::anderson::AndersonAA> { });
+              return true;
+            }
+            if (name == "require<anderson-modref>") {
+              modulePassManager.addPass(
+                  llvm::RequireAnalysisPass<llvm::anderson::AndersonModRefAnalysis, llvm::Module> { });
+              return true;
+            }
+            if (name == "invalidate<anderson-modref>") {
+              modulePassManager.addPass(llvm::InvalidateAnalysisPass<llvm::anderson::AndersonModRefAnalysis> { });
+              return true;
+            }
+            if (name == "require<anderson-escape>") {
+              modulePassManager.addPass(
+                  llvm::RequireAnalysisPass<llvm::anderson::AndersonEscapeAnalysis, llvm::Module> { });
+              return true;
+            }
+            if (name == "invalidate<anderson-escape>") {
+              modulePassManager.addPass(llvm::InvalidateAnalysisPass<llvm::anderson::AndersonEscapeAnalysis> { });
+              return true;
+            }
+            if (name == "print<anderson>") {
+              modulePassManager.addPass(llvm::anderson::AndersonPrinterPass { llvm::errs() });
+              return true;
+            }
+            if (name == "print<anderson-escape>") {
+              modulePassManager.addPass(llvm::anderson::AndersonEscapePrinterPass { llvm::errs() });
+              return true;
+            }
+            if (name == "print<anderson-modref>") {
+              modulePassManager.addPass(llvm::anderson::AndersonModRefPrinterPass { llvm::errs() });
+              return true;
+            }
+            return false;
+          });
+    }
+  };
+}
@@ -0,0 +1,722 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/ConstraintSummary.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <tuple>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/DataExtractor.h>
+#include <llvm/Support/EndianStream.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include "PointsToSolver.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+constexpr const char SummaryMagic[8] = { 'L', 'L', 'V', 'M', 'A', 'P', 'S', 'M' };
+
+/**
+ * Version of the summary format. Bump this whenever the format or the semantics of the constraints changes.
+ */
+constexpr const uint32_t SummaryVersion = 2;
+
+/**
+ * Compute the number of value tree nodes in a value of each shape, saturated at the maximum value of uint64_t.
+ */
+std::vector<uint64_t> ComputeTypeSizes(const std::vector<ConstraintSummary::Type> &types) noexcept {
+  constexpr const auto MaxSize = std::numeric_limits<uint64_t>::max();
+
+  std::vector<uint64_t> sizes;
+  sizes.reserve(types.size());
+  for (const auto &type : types) {
+    uint64_t size = 1;
+    if (type.kind == ConstraintSummary::TypeKind::Array) {
+      auto elementSize = sizes[type.elementTypes.front()];
+      if (type.numElements && elementSize > (MaxSize - 1) / type.numElements) {
+        size = MaxSize;
+      } else {
+        size += elementSize * type.numElements;
+      }
+    } else {
+      for (auto elementType : type.elementTypes) {
+        auto elementSize = sizes[elementType];
+        size = elementSize > MaxSize - size ? MaxSize : size + elementSize;
+      }
+    }
+    sizes.push_back(size);
+  }
+
+  return sizes;
+}
+
+/**
+ * Builds the shape table and the root table of a summary from a value tree.
+ */
+class SummaryBuilder {
+public:
+  explicit SummaryBuilder(const llvm::Module &module,
+                          std::vector<ConstraintSummary::Type> &types,
+                          std::vector<ConstraintSummary::Root> &roots) noexcept
+    : _module(module),
+      _types(types),
+      _roots(roots),
+      _typeIndexes(),
+      _rootIndexes(),
+      _numbers(),
+      _numberedFunctions(),
+      _nextNodeId(0)
+  {
+    unsigned number = 0;
+    for (const auto &globalVariable : module.globals()) {
+      _numbers[&globalVariable] = number++;
+    }
+    number = 0;
+    for (const auto &function : module) {
+      _numbers[&function] = number++;
+    }
+  }
+
+  /**
+   * Add all roots that have been registered into the value tree since the last call.
+   *
+   * Roots are named when they are added, so the values of the roots must still be alive.
+   */
+  void AddNewRoots(const ValueTree &valueTree) noexcept {
+    for (; _nextNodeId < valueTree.GetNumNodes(); ++_nextNodeId) {
+      auto node = valueTree.GetNode(_nextNodeId);
+      if (node && node->isRoot()) {
+        AddRoot(*node);
+      }
+    }
+  }
+
+  void AddRoot(const ValueTreeNode &root) noexcept {
+    ConstraintSummary::Root summaryRoot { root.kind(), false, GetTypeIndex(root.type()), "" };
+    summaryRoot.symbol = GetSymbol(root.value(), summaryRoot.isLinkable);
+
+    _rootIndexes[&root] = static_cast<uint32_t>(_roots.size());
+    _roots.push_back(std::move(summaryRoot));
+  }
+
+  ConstraintSummary::NodeRef GetNodeRef(const ValueTreeNode &node) const noexcept {
+    auto root = &node;
+    while (root->parent()) {
+      root = root->parent();
+    }
+
+    auto it = _rootIndexes.find(root);
+    assert(it != _rootIndexes.end() && "root has not been added");
+    return ConstraintSummary::NodeRef { it->second, node.id() - root->id() };
+  }
+
+private:
+  const llvm::Module &_module;
+  std::vector<ConstraintSummary::Type> &_types;
+  std::vector<ConstraintSummary::Root> &_roots;
+  llvm::DenseMap<const llvm::Type *, uint32_t> _typeIndexes;
+  llvm::DenseMap<const ValueTreeNode *, uint32_t> _rootIndexes;
+  llvm::DenseMap<const llvm::Value *, unsigned> _numbers;
+  llvm::SmallPtrSet<const llvm::Function *, 16> _numberedFunctions;
+  size_t _nextNodeId;
+
+  uint32_t GetTypeIndex(const llvm::Type *type) noexcept {
+    auto it = _typeIndexes.find(type);
+    if (it != _typeIndexes.end()) {
+      return it->second;
+    }
+
+    ConstraintSummary::Type summaryType { ConstraintSummary::TypeKind::Scalar, 0, { } };
+    if (type->isPointerTy()) {
+      summaryType.kind = ConstraintSummary::TypeKind::Pointer;
+    } else if (type->isArrayTy()) {
+      summaryType.kind = ConstraintSummary::TypeKind::Array;
+      summaryType.numElements = type->getArrayNumElements();
+      summaryType.elementTypes.push_back(GetTypeIndex(type->getArrayElementType()));
+    } else if (type->isStructTy()) {
+      summaryType.kind = ConstraintSummary::TypeKind::Struct;
+      for (auto elementType : llvm::cast<llvm::StructType>(type)->elements()) {
+        summaryType.elementTypes.push_back(GetTypeIndex(elementType));
+      }
+    }
+
+    // Element shapes have been added by the recursive calls above, so they always precede this shape.
+    auto index = static_cast<uint32_t>(_types.size());
+    _types.push_back(std::move(summaryType));
+    _typeIndexes[type] = index;
+    return index;
+  }
+
+  std::string GetGlobalSymbol(const llvm::GlobalValue &globalValue, bool &isLinkable) const noexcept {
+    isLinkable = globalValue.hasName() && !globalValue.hasLocalLinkage();
+    if (isLinkable) {
+      return globalValue.getName().str();
+    }
+    return GetLocalSymbol(globalValue.hasName() ? globalValue.getName().str() : GetNumberedName(&globalValue));
+  }
+
+  std::string GetSymbol(const llvm::Value *value, bool &isLinkable) noexcept {
+    if (auto globalValue = llvm::dyn_cast<llvm::GlobalValue>(value)) {
+      return GetGlobalSymbol(*globalValue, isLinkable);
+    }
+
+    if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+      auto functionSymbol = GetGlobalSymbol(*arg->getParent(), isLinkable);
+      return functionSymbol + "#" + std::to_string(arg->getArgNo());
+    }
+
+    auto inst = llvm::cast<llvm::Instruction>(value);
+    auto function = inst->getFunction();
+    NumberInstructions(*function);
+    auto functionName = function->hasName() ? function->getName().str() : GetNumberedName(function);
+    auto instName = inst->hasName() ? "%" + inst->getName().str() : GetNumberedName(inst);
+    isLinkable = false;
+    return GetLocalSymbol(functionName + "/" + instName);
+  }
+
+  void NumberInstructions(const llvm::Function &function) noexcept {
+    if (!_numberedFunctions.insert(&function).second) {
+      return;
+    }
+
+    unsigned number = 0;
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        _numbers[&inst] = number++;
+      }
+    }
+  }
+
+  std::string GetNumberedName(const llvm::Value *value) const noexcept {
+    auto it = _numbers.find(value);
+    assert(it != _numbers.end() && "value is not numbered");
+    return "#" + std::to_string(it->second);
+  }
+
+  std::string GetLocalSymbol(const std::string &name) const noexcept {
+    // Local symbols are never linked; qualify them with the source file name so that they are distinguishable from
+    // the local symbols of other modules.
+    return _module.getSourceFileName() + ":" + name;
+  }
+};
+
+/**
+ * Add the constraints held by all pointers in the value tree to the summary, in a deterministic order.
+ */
+void AddConstraints(const ValueTree &valueTree, const SummaryBuilder &builder,
+                    std::vector<ConstraintSummary::Constraint> &constraints) noexcept {
+  using Constraint = ConstraintSummary::Constraint;
+
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+
+    auto pointer = node->pointer();
+    auto pointerRef = builder.GetNodeRef(*node);
+    for (const auto &e : pointer->assigned_address_of()) {
+      constraints.push_back(Constraint {
+          PointerAssignmentKind::AssignedAddressOf, pointerRef, builder.GetNodeRef(*e.pointee()->node()), { } });
+    }
+    for (const auto &e : pointer->assigned_element_ptr()) {
+      constraints.push_back(Constraint {
+          PointerAssignmentKind::AssignedElementPtr, pointerRef, builder.GetNodeRef(*e.pointer()->node()),
+          std::vector<PointerIndex> { e.index_sequence().begin(), e.index_sequence().end() } });
+    }
+    for (const auto &e : pointer->assigned_pointee()) {
+      constraints.push_back(Constraint {
+          PointerAssignmentKind::AssignedPointee, pointerRef, builder.GetNodeRef(*e.pointer()->node()), { } });
+    }
+    for (const auto &e : pointer->pointee_assigned()) {
+      constraints.push_back(Constraint {
+          PointerAssignmentKind::PointeeAssigned, pointerRef, builder.GetNodeRef(*e.pointer()->node()), { } });
+    }
+    for (const auto &e : pointer->pointee_copied()) {
+      constraints.push_back(Constraint {
+          PointerAssignmentKind::PointeeAssignedPointee, pointerRef, builder.GetNodeRef(*e.pointer()->node()), { } });
+    }
+  }
+
+  // Constraints are kept in hash sets, so sort them to make the summary of the same module byte-identical.
+  auto constraintKey = [](const Constraint &c) noexcept {
+    std::vector<size_t> indexes;
+    indexes.reserve(c.indexSequence.size());
+    for (const auto &index : c.indexSequence) {
+      indexes.push_back(index.index());
+    }
+    return std::make_tuple(c.pointer.root, c.pointer.offset, static_cast<int>(c.kind), c.operand.root, c.operand.offset,
+                           std::move(indexes));
+  };
+  std::sort(constraints.begin(), constraints.end(),
+            [&constraintKey](const Constraint &lhs, const Constraint &rhs) noexcept {
+              return constraintKey(lhs) < constraintKey(rhs);
+            });
+}
+
+} // namespace <anonymous>
+
+std::unique_ptr<ConstraintSummary> ConstraintSummary::Build(const llvm::Module &module,
+                                                           const ValueTree &valueTree) noexcept {
+  auto summary = std::make_unique<ConstraintSummary>();
+  SummaryBuilder builder { module, summary->_types, summary->_roots };
+  builder.AddNewRoots(valueTree);
+  AddConstraints(valueTree, builder, summary->_constraints);
+  return summary;
+}
+
+std::unique_ptr<ConstraintSummary> ConstraintSummary::BuildLazily(llvm::Module &module) noexcept {
+  auto summary = std::make_unique<ConstraintSummary>();
+  SummaryBuilder builder { module, summary->_types, summary->_roots };
+
+  // Functions that have not been materialized yet only get the value trees of their arguments and return values here.
+  PointsToSolver solver { module, std::make_unique<ValueTree>(module, nullptr, GetRequestedExternalSummaries()) };
+  auto valueTree = solver.GetValueTree();
+  builder.AddNewRoots(*valueTree);
+
+  for (const auto &globalVariable : module.globals()) {
+    solver.AddTrivialPointerAssignments(globalVariable);
+  }
+
+  for (auto &function : module) {
+    auto isLazy = function.isMaterializable();
+    if (isLazy) {
+      if (auto error = function.materialize()) {
+        llvm::consumeError(std::move(error));
+        return nullptr;
+      }
+      valueTree->AddFunctionBody(function);
+      builder.AddNewRoots(*valueTree);
+    }
+
+    solver.AddTrivialPointerAssignments(function);
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+
+    if (isLazy) {
+      // The constraints of the function body have been generated, so release the body to bound the memory usage.
+      valueTree->DetachFunctionBody(function);
+      function.deleteBody();
+    }
+  }
+
+  AddConstraints(*valueTree, builder, summary->_constraints);
+  return summary;
+}
+
+bool ConstraintSummary::IsSummary(llvm::MemoryBufferRef buffer) noexcept {
+  return buffer.getBuffer().startswith(llvm::StringRef { SummaryMagic, sizeof(SummaryMagic) });
+}
+
+std::unique_ptr<ConstraintSummary> ConstraintSummary::Read(llvm::MemoryBufferRef buffer) noexcept {
+  if (!IsSummary(buffer)) {
+    return nullptr;
+  }
+  auto data = buffer.getBuffer();
+
+  llvm::DataExtractor extractor { data, true, 8 };
+  llvm::DataExtractor::Cursor cursor { sizeof(SummaryMagic) };
+  if (extractor.getU32(cursor) != SummaryVersion) {
+    llvm::consumeError(cursor.takeError());
+    return nullptr;
+  }
+  extractor.getU32(cursor);
+
+  auto summary = std::make_unique<ConstraintSummary>();
+  auto malformed = false;
+
+  // Every record takes at least one byte, so counts that exceed the remaining size are never valid.
+  auto readCount = [&extractor, &cursor, &malformed, &data]() noexcept -> uint64_t {
+    auto count = extractor.getU64(cursor);
+    if (cursor && count > data.size() - cursor.tell()) {
+      malformed = true;
+      return 0;
+    }
+    return count;
+  };
+
+  auto numTypes = readCount();
+  summary->_types.reserve(numTypes);
+  for (uint64_t i = 0; cursor && !malformed && i < numTypes; ++i) {
+    Type type { static_cast<TypeKind>(extractor.getU8(cursor)), 0, { } };
+    switch (type.kind) {
+      case TypeKind::Scalar:
+      case TypeKind::Pointer:
+        break;
+      case TypeKind::Array:
+        type.numElements = extractor.getU64(cursor);
+        type.elementTypes.push_back(extractor.getU32(cursor));
+        break;
+      case TypeKind::Struct: {
+        auto numElements = extractor.getU32(cursor);
+        for (uint32_t j = 0; cursor && j < numElements; ++j) {
+          type.elementTypes.push_back(extractor.getU32(cursor));
+        }
+        break;
+      }
+      default:
+        malformed = true;
+        break;
+    }
+    for (auto elementType : type.elementTypes) {
+      if (elementType >= i) {
+        malformed = true;
+      }
+    }
+    summary->_types.push_back(std::move(type));
+  }
+
+  auto numRoots = readCount();
+  summary->_roots.reserve(numRoots);
+  for (uint64_t i = 0; cursor && !malformed && i < numRoots; ++i) {
+    Root root { static_cast<ValueKind>(extractor.getU8(cursor)), extractor.getU8(cursor) != 0, 0, "" };
+    root.type = extractor.getU32(cursor);
+    auto symbolSize = extractor.getU32(cursor);
+    root.symbol = extractor.getBytes(cursor, symbolSize).str();
+    if (root.kind > ValueKind::HeapMemory || root.type >= summary->_types.size()) {
+      malformed = true;
+    }
+    summary->_roots.push_back(std::move(root));
+  }
+
+  if (!cursor) {
+    llvm::consumeError(cursor.takeError());
+    return nullptr;
+  }
+  if (malformed) {
+    return nullptr;
+  }
+
+  auto sizes = ComputeTypeSizes(summary->_types);
+  auto isValidNodeRef = [&summary, &sizes](const NodeRef &ref) noexcept {
+    return ref.root < summary->_roots.size() && ref.offset < sizes[summary->_roots[ref.root].type];
+  };
+
+  auto numConstraints = readCount();
+  summary->_constraints.reserve(numConstraints);
+  for (uint64_t i = 0; cursor && !malformed && i < numConstraints; ++i) {
+    Constraint constraint { static_cast<PointerAssignmentKind>(extractor.getU8(cursor)), { 0, 0 }, { 0, 0 }, { } };
+    constraint.pointer.root = extractor.getU32(cursor);
+    constraint.pointer.offset = extractor.getU64(cursor);
+    constraint.operand.root = extractor.getU32(cursor);
+    constraint.operand.offset = extractor.getU64(cursor);
+    auto numIndexes = extractor.getU32(cursor);
+    for (uint32_t j = 0; cursor && j < numIndexes; ++j) {
+      auto index = extractor.getU64(cursor);
+      constraint.indexSequence.push_back(
+          index == std::numeric_limits<uint64_t>::max() ? PointerIndex { } : PointerIndex { index });
+    }
+    if (constraint.kind > PointerAssignmentKind::PointeeAssignedPointee ||
+        !isValidNodeRef(constraint.pointer) ||
+        !isValidNodeRef(constraint.operand)) {
+      malformed = true;
+    }
+    summary->_constraints.push_back(std::move(constraint));
+  }
+
+  if (!cursor) {
+    llvm::consumeError(cursor.takeError());
+    return nullptr;
+  }
+  if (malformed || cursor.tell() != data.size()) {
+    return nullptr;
+  }
+
+  return summary;
+}
+
+std::unique_ptr<ConstraintSummary> ConstraintSummary::ReadFile(llvm::StringRef path) noexcept {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return nullptr;
+  }
+  return Read((*buffer)->getMemBufferRef());
+}
+
+void ConstraintSummary::Write(llvm::raw_ostream &os) const noexcept {
+  llvm::support::endian::Writer writer { os, llvm::support::little };
+  os.write(SummaryMagic, sizeof(SummaryMagic));
+  writer.write<uint32_t>(SummaryVersion);
+  writer.write<uint32_t>(0);
+
+  writer.write<uint64_t>(_types.size());
+  for (const auto &type : _types) {
+    writer.write<uint8_t>(static_cast<uint8_t>(type.kind));
+    if (type.kind == TypeKind::Array) {
+      writer.write<uint64_t>(type.numElements);
+      writer.write<uint32_t>(type.elementTypes.front());
+    } else if (type.kind == TypeKind::Struct) {
+      writer.write<uint32_t>(static_cast<uint32_t>(type.elementTypes.size()));
+      writer.write<uint32_t>(type.elementTypes);
+    }
+  }
+
+  writer.write<uint64_t>(_roots.size());
+  for (const auto &root : _roots) {
+    writer.write<uint8_t>(static_cast<uint8_t>(root.kind));
+    writer.write<uint8_t>(root.isLinkable ? 1 : 0);
+    writer.write<uint32_t>(root.type);
+    writer.write<uint32_t>(static_cast<uint32_t>(root.symbol.size()));
+    os << root.symbol;
+  }
+
+  writer.write<uint64_t>(_constraints.size());
+  for (const auto &constraint : _constraints) {
+    writer.write<uint8_t>(static_cast<uint8_t>(constraint.kind));
+    writer.write<uint32_t>(constraint.pointer.root);
+    writer.write<uint64_t>(constraint.pointer.offset);
+    writer.write<uint32_t>(constraint.operand.root);
+    writer.write<uint64_t>(constraint.operand.offset);
+    writer.write<uint32_t>(static_cast<uint32_t>(constraint.indexSequence.size()));
+    for (const auto &index : constraint.indexSequence) {
+      writer.write<uint64_t>(index.isConstant() ? index.index() : std::numeric_limits<uint64_t>::max());
+    }
+  }
+}
+
+bool ConstraintSummary::WriteFile(llvm::StringRef path) const noexcept {
+  std::error_code ec;
+  llvm::raw_fd_ostream os { path, ec, llvm::sys::fs::OF_None };
+  if (ec) {
+    return false;
+  }
+
+  Write(os);
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  return true;
+}
+
+SummaryLinker::SummaryLinker() noexcept
+  : _context(),
+    _valueTree(std::make_unique<ValueTree>()),
+    _linkableRoots(),
+    _symbols()
+{ }
+
+void SummaryLinker::Link(const ConstraintSummary &summary) noexcept {
+  const auto &summaryTypes = summary.types();
+  auto sizes = ComputeTypeSizes(summaryTypes);
+
+  // Shapes are materialized as literal types so that the same shape maps to the same type in all summaries.
+  std::vector<llvm::Type *> types;
+  types.reserve(summaryTypes.size());
+  auto scalarType = llvm::Type::getInt8Ty(_context);
+  for (const auto &type : summaryTypes) {
+    switch (type.kind) {
+      case ConstraintSummary::TypeKind::Scalar:
+        types.push_back(scalarType);
+        break;
+      case ConstraintSummary::TypeKind::Pointer:
+        types.push_back(llvm::PointerType::getUnqual(scalarType));
+        break;
+      case ConstraintSummary::TypeKind::Array:
+        types.push_back(llvm::ArrayType::get(types[type.elementTypes.front()], type.numElements));
+        break;
+      case ConstraintSummary::TypeKind::Struct: {
+        std::vector<llvm::Type *> elementTypes;
+        for (auto elementType : type.elementTypes) {
+          elementTypes.push_back(types[elementType]);
+        }
+        types.push_back(llvm::StructType::get(_context, elementTypes));
+        break;
+      }
+    }
+  }
+
+  std::vector<ValueTreeNode *> roots;
+  roots.reserve(summary.roots().size());
+  for (const auto &root : summary.roots()) {
+    if (!root.isLinkable) {
+      auto node = _valueTree->AddDetachedRoot(root.kind, types[root.type]);
+      _symbols[node] = root.symbol;
+      roots.push_back(node);
+      continue;
+    }
+
+    auto &node = _linkableRoots[std::make_pair(root.kind, root.symbol)];
+    if (!node) {
+      node = _valueTree->AddDetachedRoot(root.kind, types[root.type]);
+      _symbols[node] = root.symbol;
+    }
+    roots.push_back(node);
+  }
+
+  // Map a node in the summary to the linked value tree. The summary shape is used to decode the offset; if the linked
+  // root has a different shape, stop at the deepest node that exists in both shapes.
+  auto resolve = [&summary, &summaryTypes, &sizes, &roots](const ConstraintSummary::NodeRef &ref) noexcept {
+    auto node = roots[ref.root];
+    auto type = summary.roots()[ref.root].type;
+    auto offset = ref.offset;
+    while (offset) {
+      --offset;
+      const auto &summaryType = summaryTypes[type];
+
+      size_t childIndex = 0;
+      if (summaryType.kind == ConstraintSummary::TypeKind::Array) {
+        auto elementSize = sizes[summaryType.elementTypes.front()];
+        childIndex = offset / elementSize;
+        offset %= elementSize;
+        type = summaryType.elementTypes.front();
+      } else {
+        for (auto elementType : summaryType.elementTypes) {
+          if (offset < sizes[elementType]) {
+            type = elementType;
+            break;
+          }
+          offset -= sizes[elementType];
+          ++childIndex;
+        }
+      }
+
+      if (childIndex >= node->GetNumChildren()) {
+        break;
+      }
+      node = node->GetChild(childIndex);
+    }
+    return node;
+  };
+
+  for (const auto &constraint : summary.constraints()) {
+    auto pointerNode = resolve(constraint.pointer);
+    auto operandNode = resolve(constraint.operand);
+    if (!pointerNode->isPointer()) {
+      continue;
+    }
+
+    auto pointer = pointerNode->pointer();
+    if (constraint.kind == PointerAssignmentKind::AssignedAddressOf) {
+      pointer->AssignedAddressOf(operandNode->pointee());
+      continue;
+    }
+
+    if (!operandNode->isPointer()) {
+      continue;
+    }
+    auto operand = operandNode->pointer();
+    switch (constraint.kind) {
+      case PointerAssignmentKind::AssignedElementPtr:
+        pointer->AssignedElementPtr(operand, constraint.indexSequence);
+        break;
+      case PointerAssignmentKind::AssignedPointee:
+        pointer->AssignedPointee(operand);
+        break;
+      case PointerAssignmentKind::PointeeAssigned:
+        pointer->PointeeAssigned(operand);
+        break;
+      case PointerAssignmentKind::PointeeAssignedPointee:
+        pointer->PointeeCopied(operand);
+        break;
+      default:
+        llvm_unreachable("unexpected constraint kind");
+    }
+  }
+}
+
+bool SummaryLinker::LinkIRFile(llvm::StringRef path, llvm::SMDiagnostic &diagnostic) noexcept {
+  llvm::LLVMContext context;
+  auto module = llvm::getLazyIRFileModule(path, diagnostic, context);
+  if (!module) {
+    return false;
+  }
+
+  auto summary = ConstraintSummary::BuildLazily(*module);
+  if (!summary) {
+    diagnostic = llvm::SMDiagnostic { path, llvm::SourceMgr::DK_Error, "cannot materialize function" };
+    return false;
+  }
+
+  // Release the IR before linking so that at most one module is alive at any time.
+  module = nullptr;
+  Link(*summary);
+  return true;
+}
+
+void SummaryLinker::Solve() noexcept {
+  PointsToSolver solver { std::move(_valueTree) };
+  solver.Solve();
+  _valueTree = solver.TakeValueTree();
+}
+
+llvm::StringRef SummaryLinker::GetSymbol(const ValueTreeNode &root) const noexcept {
+  auto it = _symbols.find(&root);
+  assert(it != _symbols.end() && "not a root node of the linked value tree");
+  return it->second;
+}
+
+void SummaryLinker::Print(llvm::raw_ostream &os) const noexcept {
+  auto getName = [this](const ValueTreeNode *node) noexcept {
+    std::vector<size_t> path;
+    while (!node->isRoot()) {
+      path.push_back(node->offset());
+      node = node->parent();
+    }
+
+    std::string name;
+    switch (node->kind()) {
+      case ValueKind::Normal:
+        break;
+      case ValueKind::StackMemory:
+        name = "stack:";
+        break;
+      case ValueKind::GlobalMemory:
+        name = "global:";
+        break;
+      case ValueKind::ArgumentMemory:
+        name = "argmem:";
+        break;
+      case ValueKind::FunctionReturnValue:
+        name = "ret:";
+        break;
+      case ValueKind::HeapMemory:
+        name = "heap:";
+        break;
+    }
+    name += GetSymbol(*node).str();
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+      name += "[" + std::to_string(*it) + "]";
+    }
+    return name;
+  };
+
+  for (size_t id = 0; id < _valueTree->GetNumNodes(); ++id) {
+    auto node = _valueTree->GetNode(id);
+    if (!node || !node->isPointer() || !node->pointer()->GetPointeeSet().size()) {
+      continue;
+    }
+
+    std::set<std::string> pointees;
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      pointees.insert(getName(pointee->node()));
+    }
+
+    os << getName(node) << " ->";
+    for (const auto &pointee : pointees) {
+      os << " " << pointee;
+    }
+    os << "\n";
+  }
+}
+
+} // namespace anderson
+
+} // namespace llvm
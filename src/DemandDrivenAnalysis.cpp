@@ -0,0 +1,401 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/DemandDrivenAnalysis.h"
+
+#include <algorithm>
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+#include "DependencyIndex.h"
+#include "ExternalSummaries.h"
+#include "PointsToSolver.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+/**
+ * Determine whether the specified pointer lives in memory, i.e. whether its pointee set is only assigned through stores.
+ */
+bool IsMemoryPointer(const Pointer *pointer) noexcept {
+  auto node = pointer->node();
+  return node->isStackMemory() || node->isGlobalMemory() || node->isArgumentMemory() || node->isHeapMemory();
+}
+
+/**
+ * Visit the operands that the pointee set of the specified pointer is computed from.
+ *
+ * The stored values of `*p = q` constraints are not visited since they only flow into the pointees of `p`, which hold
+ * the derived `o = q` constraints themselves. The sources of `*p = *q` constraints are visited, since the pointers the
+ * derived constraints copy are only known once the pointee set of `q` is.
+ */
+template <typename Visitor>
+void ForEachDemandedOperand(Pointer *pointer, Visitor &&visitor) noexcept {
+  for (const auto &e : pointer->assigned_element_ptr()) {
+    visitor(e.pointer());
+  }
+  for (const auto &e : pointer->assigned_pointee()) {
+    visitor(e.pointer());
+  }
+  for (const auto &e : pointer->pointee_copied()) {
+    visitor(e.pointer());
+  }
+}
+
+const ValueTreeNode* GetRootNode(const ValueTreeNode *node) noexcept {
+  while (!node->isRoot()) {
+    node = node->parent();
+  }
+  return node;
+}
+
+} // namespace <anonymous>
+
+DemandDrivenAnalysis::DemandDrivenAnalysis(const llvm::Module &module) noexcept
+  : _module(module),
+    _solver(std::make_unique<PointsToSolver>(
+        module, std::make_unique<ValueTree>(module, nullptr, GetRequestedExternalSummaries()))),
+    _dependencies(std::make_unique<DependencyIndex>()),
+    _region(),
+    _regionOrder(),
+    _exploredOperands(),
+    _generated(),
+    _objectStores(),
+    _loadedPointers(),
+    _incomplete()
+{
+  // The solver records the reverse edges of the constraints as they are generated.
+  _solver->SetDependencyIndex(_dependencies.get());
+  _solver->SetRegion(&_region);
+  _solver->SetTypeFilter(GetRequestedTypeFilter());
+}
+
+DemandDrivenAnalysis::~DemandDrivenAnalysis() noexcept = default;
+
+ValueTree* DemandDrivenAnalysis::GetValueTree() const noexcept {
+  return _solver->GetValueTree();
+}
+
+bool DemandDrivenAnalysis::Query(llvm::ArrayRef<const llvm::Value *> values, size_t budget) noexcept {
+  std::vector<Pointer *> queried;
+  for (auto value : values) {
+    auto node = _solver->GetValueTree()->GetValueNode(value);
+    if (node && node->isPointer()) {
+      queried.push_back(node->pointer());
+    }
+  }
+
+  for (auto pointer : queried) {
+    if (_region.find(pointer) == _region.end()) {
+      AddToRegion(pointer);
+    }
+  }
+
+  // Exploring may derive new constraints on the explored pointers once they are solved, which in turn demand more
+  // pointers, so alternate between exploring and solving until neither makes progress.
+  while (true) {
+    _solver->SolveWorklist();
+    if (!Explore(budget)) {
+      break;
+    }
+  }
+
+  ComputeIncompletePointers();
+
+  for (auto pointer : queried) {
+    if (_incomplete.find(pointer) != _incomplete.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DemandDrivenAnalysis::AddToRegion(Pointer *pointer) noexcept {
+  _region.insert(pointer);
+  _regionOrder.push_back(pointer);
+  GenerateConstraints(*GetRootNode(pointer->node()));
+  _solver->Enqueue(pointer);
+}
+
+void DemandDrivenAnalysis::GenerateConstraints(const ValueTreeNode &root) noexcept {
+  // Memory is only assigned through stores, whose constraints are generated by `GetObjectStores`.
+  if (!root.isNormalValue() && !root.isFunctionReturnValue()) {
+    return;
+  }
+  auto value = root.value();
+  if (!value || !_generated.insert(value).second) {
+    return;
+  }
+
+  if (root.isFunctionReturnValue()) {
+    for (const auto &bb : *llvm::cast<llvm::Function>(value)) {
+      if (llvm::isa<llvm::ReturnInst>(bb.getTerminator())) {
+        UpdateAndersonSolverOnInst(*_solver, *bb.getTerminator());
+      }
+    }
+  } else if (auto inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+    UpdateAndersonSolverOnInst(*_solver, *inst);
+  } else if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+    auto function = arg->getParent();
+    _solver->AddTrivialPointerAssignments(*function);
+    for (auto user : function->users()) {
+      auto call = llvm::dyn_cast<llvm::CallInst>(user);
+      if (call && call->getCalledFunction() == function) {
+        UpdateAndersonSolverOnInst(*_solver, *call);
+      }
+    }
+  } else if (auto globalVariable = llvm::dyn_cast<llvm::GlobalVariable>(value)) {
+    _solver->AddTrivialPointerAssignments(*globalVariable);
+  }
+}
+
+DemandDrivenAnalysis::ObjectStores& DemandDrivenAnalysis::GetObjectStores(const ValueTreeNode &object) noexcept {
+  auto it = _objectStores.find(&object);
+  if (it != _objectStores.end()) {
+    return it->second;
+  }
+  auto &stores = _objectStores[&object];
+  stores.explored = false;
+
+  auto valueTree = _solver->GetValueTree();
+  auto summaries = valueTree->GetExternalSummaries();
+  auto addStore = [this, valueTree, &stores](const llvm::Instruction &inst, const llvm::Value *pointerValue) noexcept {
+    UpdateAndersonSolverOnInst(*_solver, inst);
+    auto node = valueTree->GetValueNode(pointerValue);
+    if (node && node->isPointer() &&
+        std::find(stores.pointers.begin(), stores.pointers.end(), node->pointer()) == stores.pointers.end()) {
+      stores.pointers.push_back(node->pointer());
+    }
+  };
+
+  // Follow the address of the object along the def-use chains that the constraint generator models to every value
+  // that may point into the object. Once the address is stored into memory, any load may read it back.
+  std::unordered_set<const llvm::Value *> reached;
+  std::vector<const llvm::Value *> worklist;
+  auto reach = [&reached, &worklist](const llvm::Value *value) noexcept {
+    if (reached.insert(value).second) {
+      worklist.push_back(value);
+    }
+  };
+  reach(object.value());
+  auto stored = false;
+  auto loadsReached = false;
+  while (true) {
+    if (worklist.empty()) {
+      if (!stored || loadsReached) {
+        break;
+      }
+      loadsReached = true;
+      for (auto load : GetLoadedPointers()) {
+        reach(load);
+      }
+      continue;
+    }
+
+    auto value = worklist.back();
+    worklist.pop_back();
+    for (auto user : value->users()) {
+      if (auto store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+        stored |= store->getValueOperand() == value;
+        if (store->getPointerOperand() == value && store->getValueOperand()->getType()->isPointerTy()) {
+          addStore(*store, value);
+        }
+      } else if (auto call = llvm::dyn_cast<llvm::CallInst>(user)) {
+        auto callee = call->getCalledFunction();
+        if (!callee || llvm::isa<llvm::IntrinsicInst>(call)) {
+          continue;
+        }
+        auto summary = summaries ? summaries->GetCalleeSummary(*call) : nullptr;
+        for (unsigned i = 0; i < call->arg_size(); ++i) {
+          if (call->getArgOperand(i) != value) {
+            continue;
+          }
+          if (!summary) {
+            if (i < callee->arg_size()) {
+              reach(callee->getArg(i));
+            }
+            continue;
+          }
+          for (const auto &effect : summary->effects) {
+            if (effect.kind == ExternalEffect::Kind::ReturnsArgument && effect.source == i) {
+              reach(call);
+            } else if (effect.kind == ExternalEffect::Kind::StoresArgument) {
+              stored |= effect.source == i;
+              if (effect.target == i) {
+                addStore(*call, value);
+              }
+            } else if (effect.kind == ExternalEffect::Kind::CopiesArgumentPointee && effect.target == i) {
+              addStore(*call, value);
+            }
+          }
+        }
+      } else if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(user)) {
+        auto function = ret->getFunction();
+        for (auto caller : function->users()) {
+          auto call = llvm::dyn_cast<llvm::CallInst>(caller);
+          if (call && call->getCalledFunction() == function) {
+            reach(call);
+          }
+        }
+      } else if (auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(user)) {
+        if (gep->getPointerOperand() == value) {
+          reach(gep);
+        }
+      } else if (llvm::isa<llvm::BitCastInst>(user) || llvm::isa<llvm::AddrSpaceCastInst>(user) ||
+                 llvm::isa<llvm::PHINode>(user) || llvm::isa<llvm::SelectInst>(user)) {
+        if (user->getType()->isPointerTy()) {
+          reach(user);
+        }
+      }
+    }
+  }
+
+  return stores;
+}
+
+const std::vector<const llvm::Value *>& DemandDrivenAnalysis::GetLoadedPointers() noexcept {
+  if (_loadedPointers) {
+    return *_loadedPointers;
+  }
+
+  _loadedPointers = std::make_unique<std::vector<const llvm::Value *>>();
+  auto summaries = _solver->GetValueTree()->GetExternalSummaries();
+  for (const auto &function : _module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        if (llvm::isa<llvm::LoadInst>(inst) && inst.getType()->isPointerTy()) {
+          _loadedPointers->push_back(&inst);
+          continue;
+        }
+        auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+        auto summary = call && summaries ? summaries->GetCalleeSummary(*call) : nullptr;
+        if (!summary) {
+          continue;
+        }
+        for (const auto &effect : summary->effects) {
+          if (effect.kind == ExternalEffect::Kind::ReturnsArgumentPointee) {
+            _loadedPointers->push_back(&inst);
+            break;
+          }
+        }
+      }
+    }
+  }
+  return *_loadedPointers;
+}
+
+bool DemandDrivenAnalysis::Explore(size_t &budget) noexcept {
+  auto explored = false;
+  auto exhausted = false;
+  auto demand = [this, &budget, &explored, &exhausted](Pointer *pointer) noexcept {
+    if (_region.find(pointer) != _region.end()) {
+      return;
+    }
+    if (budget == 0) {
+      exhausted = true;
+      return;
+    }
+    --budget;
+    explored = true;
+    AddToRegion(pointer);
+  };
+
+  for (size_t i = 0; i < _regionOrder.size() && !exhausted; ++i) {
+    auto pointer = _regionOrder[i];
+    auto numOperands = std::make_pair(pointer->GetNumAssignedElementPtr(),
+                                      pointer->GetNumAssignedPointee() + pointer->GetNumPointeeCopied());
+
+    auto it = _exploredOperands.find(pointer);
+    if (it != _exploredOperands.end() && it->second == numOperands) {
+      continue;
+    }
+
+    ForEachDemandedOperand(pointer, demand);
+    if (IsMemoryPointer(pointer)) {
+      // The stores writing to this pointer are only known once the pointee sets of their pointers are known.
+      auto &stores = GetObjectStores(*GetRootNode(pointer->node()));
+      if (!stores.explored) {
+        for (auto store : stores.pointers) {
+          demand(store);
+        }
+        stores.explored = !exhausted;
+      }
+    }
+
+    if (!exhausted) {
+      _exploredOperands[pointer] = numOperands;
+    }
+  }
+
+  return explored;
+}
+
+void DemandDrivenAnalysis::ComputeIncompletePointers() noexcept {
+  _incomplete.clear();
+
+  std::vector<const Pointer *> worklist;
+  auto mark = [this, &worklist](const Pointer *pointer) noexcept {
+    if (_incomplete.insert(pointer).second) {
+      worklist.push_back(pointer);
+    }
+  };
+
+  std::unordered_map<const Pointer *, std::vector<const Pointer *>> dependents;
+  for (auto pointer : _regionOrder) {
+    ForEachDemandedOperand(pointer, [this, pointer, &mark, &dependents](Pointer *operand) noexcept {
+      if (_region.find(operand) == _region.end()) {
+        mark(pointer);
+      } else {
+        dependents[operand].push_back(pointer);
+      }
+    });
+    if (!IsMemoryPointer(pointer)) {
+      continue;
+    }
+
+    // An incomplete store pointer may write to any pointer in the objects it may point into.
+    auto &stores = GetObjectStores(*GetRootNode(pointer->node()));
+    if (!stores.explored) {
+      mark(pointer);
+    }
+    for (auto store : stores.pointers) {
+      if (_region.find(store) != _region.end()) {
+        dependents[store].push_back(pointer);
+      }
+    }
+  }
+
+  while (!worklist.empty()) {
+    auto pointer = worklist.back();
+    worklist.pop_back();
+
+    auto it = dependents.find(pointer);
+    if (it != dependents.end()) {
+      for (auto dependent : it->second) {
+        mark(dependent);
+      }
+    }
+  }
+}
+
+const PointeeSet* DemandDrivenAnalysis::GetPointeeSet(const llvm::Value *value) const noexcept {
+  auto node = _solver->GetValueTree()->GetValueNode(value);
+  if (!node || !node->isPointer()) {
+    return nullptr;
+  }
+
+  auto pointer = node->pointer();
+  if (_region.find(pointer) == _region.end() || _incomplete.find(pointer) != _incomplete.end()) {
+    return nullptr;
+  }
+  return &pointer->GetPointeeSet();
+}
+
+} // namespace anderson
+
+} // namespace llvm
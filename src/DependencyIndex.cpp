@@ -0,0 +1,49 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "DependencyIndex.h"
+
+namespace llvm {
+
+namespace anderson {
+
+void DependencyIndex::Build(ValueTree &valueTree) noexcept {
+  _users.clear();
+  _storeOrigins.clear();
+
+  valueTree.Visit([this](ValueTreeNode &node) noexcept -> bool {
+    if (!node.isPointer()) {
+      return true;
+    }
+
+    auto pointer = node.pointer();
+    ForEachOperand(pointer, [this, pointer](Pointer *operand) noexcept {
+      AddUser(operand, pointer);
+    });
+    ForEachStoreTarget(pointer, [this, pointer](Pointer *stored) noexcept {
+      AddStoreOrigin(stored, pointer);
+    });
+
+    return true;
+  });
+}
+
+void DependencyIndex::RemoveEdgesFrom(Pointer *pointer) noexcept {
+  ForEachOperand(pointer, [this, pointer](Pointer *operand) noexcept {
+    auto it = _users.find(operand);
+    if (it != _users.end()) {
+      it->second.erase(pointer);
+    }
+  });
+  ForEachStoreTarget(pointer, [this, pointer](Pointer *stored) noexcept {
+    auto it = _storeOrigins.find(stored);
+    if (it != _storeOrigins.end()) {
+      it->second.erase(pointer);
+    }
+  });
+}
+
+} // namespace anderson
+
+} // namespace llvm
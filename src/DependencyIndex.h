@@ -0,0 +1,173 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_DEPENDENCY_INDEX_H
+#define LLVM_ANDERSON_SRC_DEPENDENCY_INDEX_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include "TypeFilter.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Reverse edges of the constraint graph, i.e. which pointers depend on a given pointer.
+ *
+ * The index records two kinds of reverse edges:
+ * - the users of a pointer `q`, which are the pointers holding a constraint whose right hand side operand is `q`;
+ * - the store origins of a pointer `o`, which are the pointers `p` holding a constraint `*p = q` such that `o` is in the
+ *   pointee set of `p`, or a constraint `*p = *q` such that `o` is in the memory pointed to by `p`. The constraints
+ *   derived from such stores and copies are not otherwise attributed to `p`.
+ */
+class DependencyIndex {
+public:
+  /**
+   * Build the dependency index of all constraints and pointee sets in the specified value tree.
+   *
+   * @param valueTree the value tree.
+   */
+  void Build(ValueTree &valueTree) noexcept;
+
+  /**
+   * Record that `user` holds a constraint whose right hand side operand is `pointer`.
+   *
+   * @param pointer the right hand side operand.
+   * @param user the pointer holding the constraint.
+   */
+  void AddUser(Pointer *pointer, Pointer *user) noexcept {
+    _users[pointer].insert(user);
+  }
+
+  /**
+   * Record that the constraints `*origin = q` or `*origin = *q` of `origin` have been relaxed onto `pointer`.
+   *
+   * @param pointer a pointer in the memory pointed to by `origin`.
+   * @param origin the pointer holding the store or copy constraints.
+   */
+  void AddStoreOrigin(Pointer *pointer, Pointer *origin) noexcept {
+    _storeOrigins[pointer].insert(origin);
+  }
+
+  /**
+   * Remove all reverse edges originating from the constraints and the pointee set of the specified pointer.
+   *
+   * This function should be called before the constraints of the pointer are reset or the pointer is destroyed.
+   *
+   * @param pointer the pointer.
+   */
+  void RemoveEdgesFrom(Pointer *pointer) noexcept;
+
+  /**
+   * Remove all reverse edges that end at the specified pointer.
+   *
+   * @param pointer the pointer.
+   */
+  void RemoveEdgesTo(Pointer *pointer) noexcept {
+    _users.erase(pointer);
+    _storeOrigins.erase(pointer);
+  }
+
+  /**
+   * Visit all users of the specified pointer.
+   *
+   * @tparam Visitor type of the visitor, which takes a single argument of type `Pointer *`.
+   * @param pointer the pointer.
+   * @param visitor the visitor.
+   */
+  template <typename Visitor>
+  void ForEachUser(Pointer *pointer, Visitor &&visitor) const noexcept {
+    auto it = _users.find(pointer);
+    if (it == _users.end()) {
+      return;
+    }
+    for (auto user : it->second) {
+      visitor(user);
+    }
+  }
+
+  /**
+   * Visit all store origins of the specified pointer.
+   *
+   * @tparam Visitor type of the visitor, which takes a single argument of type `Pointer *`.
+   * @param pointer the pointer.
+   * @param visitor the visitor.
+   */
+  template <typename Visitor>
+  void ForEachStoreOrigin(Pointer *pointer, Visitor &&visitor) const noexcept {
+    auto it = _storeOrigins.find(pointer);
+    if (it == _storeOrigins.end()) {
+      return;
+    }
+    for (auto origin : it->second) {
+      visitor(origin);
+    }
+  }
+
+  /**
+   * Visit the right hand side operands of all constraints on the specified pointer whose right hand side operand is a
+   * pointer.
+   *
+   * @tparam Visitor type of the visitor, which takes a single argument of type `Pointer *`.
+   * @param pointer the pointer.
+   * @param visitor the visitor.
+   */
+  template <typename Visitor>
+  static void ForEachOperand(Pointer *pointer, Visitor &&visitor) noexcept {
+    for (const auto &e : pointer->assigned_element_ptr()) {
+      visitor(e.pointer());
+    }
+    for (const auto &e : pointer->assigned_pointee()) {
+      visitor(e.pointer());
+    }
+    for (const auto &e : pointer->pointee_assigned()) {
+      visitor(e.pointer());
+    }
+    for (const auto &e : pointer->pointee_copied()) {
+      visitor(e.pointer());
+    }
+  }
+
+  /**
+   * Visit the pointers that the store and copy constraints on the specified pointer may have been relaxed onto, given
+   * its current pointee set.
+   *
+   * @tparam Visitor type of the visitor, which takes a single argument of type `Pointer *`.
+   * @param pointer the pointer.
+   * @param visitor the visitor.
+   */
+  template <typename Visitor>
+  static void ForEachStoreTarget(Pointer *pointer, Visitor &&visitor) noexcept {
+    if (pointer->GetNumPointeeAssigned()) {
+      for (auto pointee : pointer->GetPointeeSet()) {
+        if (auto stored = GetFirstScalarPointer(pointee)) {
+          visitor(stored);
+        }
+      }
+    }
+    for (const auto &e : pointer->pointee_copied()) {
+      for (auto pointee : pointer->GetPointeeSet()) {
+        for (auto source : e.pointer()->GetPointeeSet()) {
+          ForEachCopiedPointer(*pointee->node(), *source->node(), [&visitor](Pointer *copied, Pointer *) noexcept {
+            visitor(copied);
+          });
+        }
+      }
+    }
+  }
+
+private:
+  std::unordered_map<Pointer *, std::unordered_set<Pointer *>> _users;
+  std::unordered_map<Pointer *, std::unordered_set<Pointer *>> _storeOrigins;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_DEPENDENCY_INDEX_H
@@ -0,0 +1,321 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/EscapeAnalysis.h"
+
+#include <vector>
+
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+
+#include "ExternalSummaries.h"
+#include "PointsToSolver.h"
+#include "TaintAnalysis.h"
+#include "TypeFilter.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+const ValueTreeNode* GetRootNode(const ValueTreeNode *node) noexcept {
+  while (!node->isRoot()) {
+    node = node->parent();
+  }
+  return node;
+}
+
+bool IsMemoryObject(const ValueTreeNode *root) noexcept {
+  return root->isStackMemory() || root->isGlobalMemory() || root->isArgumentMemory() || root->isHeapMemory();
+}
+
+/**
+ * Reachability sweep over the memory objects of a value tree.
+ */
+class EscapeSweep {
+public:
+  explicit EscapeSweep(const ValueTree &valueTree) noexcept
+    : _valueTree(valueTree),
+      _objectPointers(),
+      _kinds(),
+      _worklist()
+  {
+    for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+      auto node = valueTree.GetNode(id);
+      if (!node || !node->isPointer()) {
+        continue;
+      }
+      auto root = GetRootNode(node);
+      if (IsMemoryObject(root)) {
+        _objectPointers[root].push_back(node->pointer());
+      }
+    }
+  }
+
+  void AddObject(const ValueTreeNode *root, EscapeKind kind) noexcept {
+    if (_kinds.insert(std::make_pair(root, kind)).second) {
+      _worklist.push_back(root);
+    }
+  }
+
+  void AddPointer(const Pointer *pointer, EscapeKind kind) noexcept {
+    for (auto pointee : pointer->GetPointeeSet()) {
+      auto root = GetRootNode(pointee->node());
+      if (IsMemoryObject(root)) {
+        AddObject(root, kind);
+      }
+    }
+  }
+
+  void AddValue(const llvm::Value *value, EscapeKind kind) noexcept {
+    // Constants only refer to global objects, which are roots of `GlobalEscape` anyway.
+    if (!value->getType()->isPointerTy() || llvm::isa<llvm::Constant>(value)) {
+      return;
+    }
+    auto node = _valueTree.GetValueNode(value);
+    if (node && node->isPointer()) {
+      AddPointer(node->pointer(), kind);
+    }
+  }
+
+  void AddContents(const llvm::Value *pointer, EscapeKind kind) noexcept {
+    auto node = _valueTree.GetValueNode(pointer);
+    if (!node || !node->isPointer()) {
+      return;
+    }
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      auto it = _objectPointers.find(GetRootNode(pointee->node()));
+      if (it == _objectPointers.end()) {
+        continue;
+      }
+      for (auto content : it->second) {
+        AddPointer(content, kind);
+      }
+    }
+  }
+
+  void Sweep(EscapeKind kind) noexcept {
+    while (!_worklist.empty()) {
+      auto root = _worklist.back();
+      _worklist.pop_back();
+
+      auto it = _objectPointers.find(root);
+      if (it == _objectPointers.end()) {
+        continue;
+      }
+      for (auto pointer : it->second) {
+        AddPointer(pointer, kind);
+      }
+    }
+  }
+
+  EscapeKind GetKind(const ValueTreeNode *root) const noexcept {
+    auto it = _kinds.find(root);
+    return it == _kinds.end() ? EscapeKind::NoEscape : it->second;
+  }
+
+private:
+  const ValueTree &_valueTree;
+  llvm::DenseMap<const ValueTreeNode *, std::vector<const Pointer *>> _objectPointers;
+  llvm::DenseMap<const ValueTreeNode *, EscapeKind> _kinds;
+  std::vector<const ValueTreeNode *> _worklist;
+};
+
+/**
+ * Determine whether the specified call is a marker that does not let any pointer escape.
+ */
+bool IsMarkerCall(const llvm::CallBase &call) noexcept {
+  if (llvm::isa<llvm::DbgInfoIntrinsic>(call)) {
+    return true;
+  }
+  auto intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(&call);
+  return intrinsic && intrinsic->isLifetimeStartOrEnd();
+}
+
+bool HasEmptyPointeeSet(const ValueTree &valueTree, const llvm::Value *pointer) noexcept {
+  auto node = valueTree.GetValueNode(pointer);
+  return !node || !node->isPointer() || node->pointer()->GetPointeeSet().size() == 0;
+}
+
+/**
+ * Determine whether a store through the specified pointer may write to memory that the solver does not track, i.e. to
+ * a pointee that cannot hold a pointer at offset zero.
+ */
+bool MayStoreUntracked(const ValueTree &valueTree, const llvm::Value *pointer) noexcept {
+  if (HasEmptyPointeeSet(valueTree, pointer)) {
+    return true;
+  }
+  for (auto pointee : valueTree.GetValueNode(pointer)->pointer()->GetPointeeSet()) {
+    if (!GetFirstScalarPointer(pointee)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* GetEscapeKindName(EscapeKind kind) noexcept {
+  switch (kind) {
+    case EscapeKind::NoEscape:
+      return "no-escape";
+    case EscapeKind::ArgEscape:
+      return "arg-escape";
+    case EscapeKind::GlobalEscape:
+      return "global-escape";
+  }
+  llvm_unreachable("unexpected escape kind");
+}
+
+} // namespace <anonymous>
+
+EscapeInfo::EscapeInfo(const llvm::Module &module, const ValueTree &valueTree) noexcept
+  : _kinds()
+{
+  EscapeSweep sweep { valueTree };
+
+  // Memory visible outside of the module, and the pointers returned to callers, are the roots of `GlobalEscape`.
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node) {
+      continue;
+    }
+    auto root = GetRootNode(node);
+    if (node == root && (node->isGlobalMemory() || node->isArgumentMemory())) {
+      sweep.AddObject(node, EscapeKind::GlobalEscape);
+    } else if (root->isFunctionReturnValue() && node->isPointer()) {
+      sweep.AddPointer(node->pointer(), EscapeKind::GlobalEscape);
+    }
+  }
+
+  const auto &dataLayout = module.getDataLayout();
+  auto summaries = valueTree.GetExternalSummaries();
+  std::vector<const llvm::Value *> callArguments;
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        if (llvm::isa<llvm::AllocaInst>(inst) || llvm::isa<llvm::GetElementPtrInst>(inst) ||
+            llvm::isa<llvm::BitCastInst>(inst) || llvm::isa<llvm::AddrSpaceCastInst>(inst) ||
+            llvm::isa<llvm::PHINode>(inst) || llvm::isa<llvm::SelectInst>(inst) || llvm::isa<llvm::ICmpInst>(inst)) {
+          // The pointers flowing through these instructions are fully described by the points-to relation.
+          continue;
+        }
+
+        if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+          if (!load->getType()->isPointerTy() && MayCarryPointer(load->getType(), dataLayout)) {
+            // The pointers in the loaded memory may be copied as integers, which the analysis cannot follow.
+            sweep.AddContents(load->getPointerOperand(), EscapeKind::GlobalEscape);
+          }
+          continue;
+        }
+
+        if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+          auto value = store->getValueOperand();
+          if (!value->getType()->isPointerTy()) {
+            if (MayCarryPointer(value->getType(), dataLayout)) {
+              sweep.AddContents(store->getPointerOperand(), EscapeKind::GlobalEscape);
+            }
+          } else if (MayStoreUntracked(valueTree, store->getPointerOperand())) {
+            // The store writes to memory the analysis knows nothing about, or to memory the solver skips.
+            sweep.AddValue(value, EscapeKind::GlobalEscape);
+          }
+          continue;
+        }
+
+        if (auto call = llvm::dyn_cast<llvm::CallBase>(&inst)) {
+          if (IsMarkerCall(*call)) {
+            continue;
+          }
+          for (const auto &arg : call->args()) {
+            callArguments.push_back(arg.get());
+          }
+          auto summary = summaries ? summaries->GetCalleeSummary(*call) : nullptr;
+          if (summary) {
+            for (const auto &effect : summary->effects) {
+              if (effect.kind == ExternalEffect::Kind::StoresArgument &&
+                  MayStoreUntracked(valueTree, call->getArgOperand(effect.target))) {
+                sweep.AddValue(call->getArgOperand(effect.source), EscapeKind::GlobalEscape);
+              }
+              if (effect.kind == ExternalEffect::Kind::CopiesArgumentPointee &&
+                  MayStoreUntracked(valueTree, call->getArgOperand(effect.target))) {
+                // The copy may move the pointers held by the source to memory the solver skips.
+                sweep.AddContents(call->getArgOperand(effect.source), EscapeKind::GlobalEscape);
+              }
+            }
+          }
+          continue;
+        }
+
+        for (const auto &operand : inst.operands()) {
+          sweep.AddValue(operand.get(), EscapeKind::GlobalEscape);
+        }
+      }
+    }
+  }
+
+  sweep.Sweep(EscapeKind::GlobalEscape);
+  for (auto arg : callArguments) {
+    sweep.AddValue(arg, EscapeKind::ArgEscape);
+  }
+  sweep.Sweep(EscapeKind::ArgEscape);
+
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+        if (!alloca) {
+          continue;
+        }
+        // An unknown pointer may point to any object, so every object may escape in a degraded solution.
+        auto node = valueTree.GetAllocaMemoryNode(alloca);
+        _kinds[alloca] = node && !valueTree.isDegraded() ? sweep.GetKind(node) : EscapeKind::GlobalEscape;
+      }
+    }
+  }
+}
+
+bool EscapeInfo::invalidate(llvm::Module &module,
+                            const llvm::PreservedAnalyses &preserved,
+                            llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept {
+  auto checker = preserved.getChecker<AndersonEscapeAnalysis>();
+  if (!checker.preserved() && !checker.preservedSet<llvm::AllAnalysesOn<llvm::Module>>()) {
+    return true;
+  }
+  return invalidator.invalidate<AndersonAnalysis>(module, preserved);
+}
+
+void EscapeInfo::print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+        if (!alloca) {
+          continue;
+        }
+        os << function.getName() << ".";
+        alloca->printAsOperand(os, false, slotTracker);
+        os << ": " << GetEscapeKindName(GetEscapeKind(*alloca)) << "\n";
+      }
+    }
+  }
+}
+
+llvm::AnalysisKey AndersonEscapeAnalysis::Key;
+
+AndersonEscapeAnalysis::Result AndersonEscapeAnalysis::run(llvm::Module &module,
+                                                           llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  return Result { module, *moduleAnalysisManager.getResult<AndersonAnalysis>(module).GetValueTree() };
+}
+
+llvm::PreservedAnalyses AndersonEscapePrinterPass::run(llvm::Module &module,
+                                                       llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  _os << "Anderson escape classification for module '" << module.getName() << "':\n";
+  moduleAnalysisManager.getResult<AndersonEscapeAnalysis>(module).print(_os, module);
+  return llvm::PreservedAnalyses::all();
+}
+
+} // namespace anderson
+
+} // namespace llvm
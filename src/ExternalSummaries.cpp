@@ -0,0 +1,264 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "ExternalSummaries.h"
+
+#include <algorithm>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/IR/Function.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+/**
+ * Built-in summaries of common C and C++ library functions.
+ *
+ * Functions that return pointers to storage they own, e.g. `getenv`, cannot be summarized with the available effects
+ * and are left out.
+ */
+const char DefaultSummaries[] =
+    "# Allocation\n"
+    "malloc ret=new\n"
+    "calloc ret=new\n"
+    "aligned_alloc ret=new\n"
+    "strdup ret=new\n"
+    "strndup ret=new\n"
+    "fopen ret=new\n"
+    "fdopen ret=new\n"
+    "tmpfile ret=new\n"
+    "_Znwm ret=new\n"
+    "_Znam ret=new\n"
+    "_ZnwmRKSt9nothrow_t ret=new\n"
+    "_ZnamRKSt9nothrow_t ret=new\n"
+    "# The reallocated block may be the original block, together with its contents, or a fresh block, e.g. when the\n"
+    "# original block is NULL.\n"
+    "realloc ret=new ret=arg0\n"
+    "free\n"
+    "_ZdlPv\n"
+    "_ZdaPv\n"
+    "fclose\n"
+    "# Strings and memory\n"
+    "strcpy ret=arg0\n"
+    "strncpy ret=arg0\n"
+    "stpcpy ret=arg0\n"
+    "strcat ret=arg0\n"
+    "strncat ret=arg0\n"
+    "memset ret=arg0\n"
+    "# The copied memory may hold pointers.\n"
+    "memcpy ret=arg0 *arg0=*arg1\n"
+    "memmove ret=arg0 *arg0=*arg1\n"
+    "memccpy ret=arg0 *arg0=*arg1\n"
+    "strchr ret=arg0\n"
+    "strrchr ret=arg0\n"
+    "strstr ret=arg0\n"
+    "strpbrk ret=arg0\n"
+    "memchr ret=arg0\n"
+    "strlen\n"
+    "strnlen\n"
+    "strcmp\n"
+    "strncmp\n"
+    "strcasecmp\n"
+    "strncasecmp\n"
+    "memcmp\n"
+    "strspn\n"
+    "strcspn\n"
+    "# Conversions\n"
+    "atoi\n"
+    "atol\n"
+    "atoll\n"
+    "atof\n"
+    "strtol *arg1=arg0\n"
+    "strtoul *arg1=arg0\n"
+    "strtoll *arg1=arg0\n"
+    "strtoull *arg1=arg0\n"
+    "strtof *arg1=arg0\n"
+    "strtod *arg1=arg0\n"
+    "strtold *arg1=arg0\n"
+    "# Input and output\n"
+    "puts\n"
+    "putchar\n"
+    "printf\n"
+    "fprintf\n"
+    "sprintf\n"
+    "snprintf\n"
+    "fputs\n"
+    "fputc\n"
+    "fgets ret=arg0\n"
+    "fread\n"
+    "fwrite\n"
+    "fflush\n"
+    "fseek\n"
+    "ftell\n"
+    "# Process\n"
+    "abort\n"
+    "exit\n";
+
+bool ParseArgumentIndex(llvm::StringRef text, unsigned &index) noexcept {
+  return text.consume_front("arg") && !text.empty() && !text.getAsInteger(10, index);
+}
+
+bool ParseEffect(llvm::StringRef text, ExternalEffect &effect) noexcept {
+  auto sides = text.split('=');
+  auto lhs = sides.first;
+  auto rhs = sides.second;
+  effect.source = 0;
+  effect.target = 0;
+
+  if (lhs == "ret") {
+    if (rhs == "new") {
+      effect.kind = ExternalEffect::Kind::ReturnsNew;
+      return true;
+    }
+    effect.kind = rhs.consume_front("*")
+        ? ExternalEffect::Kind::ReturnsArgumentPointee
+        : ExternalEffect::Kind::ReturnsArgument;
+    return ParseArgumentIndex(rhs, effect.source);
+  }
+
+  effect.kind = rhs.consume_front("*")
+      ? ExternalEffect::Kind::CopiesArgumentPointee
+      : ExternalEffect::Kind::StoresArgument;
+  return lhs.consume_front("*") && ParseArgumentIndex(lhs, effect.target) && ParseArgumentIndex(rhs, effect.source);
+}
+
+} // namespace <anonymous>
+
+ExternalSummaries ExternalSummaries::CreateDefault() noexcept {
+  ExternalSummaries summaries;
+  auto wellFormed = summaries.Parse(DefaultSummaries, "<default>", llvm::errs());
+  assert(wellFormed && "malformed default summaries");
+  (void)wellFormed;
+  return summaries;
+}
+
+bool ExternalSummaries::Parse(llvm::StringRef text, llvm::StringRef source, llvm::raw_ostream &errs) noexcept {
+  auto wellFormed = true;
+  unsigned lineNumber = 0;
+  while (!text.empty()) {
+    auto split = text.split('\n');
+    text = split.second;
+    ++lineNumber;
+
+    auto line = split.first.split('#').first.trim();
+    if (line.empty()) {
+      continue;
+    }
+
+    llvm::SmallVector<llvm::StringRef, 4> tokens;
+    llvm::SplitString(line, tokens);
+    ExternalSummary summary;
+    auto lineWellFormed = true;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+      auto token = tokens[i];
+      ExternalEffect effect;
+      if (!ParseEffect(token, effect)) {
+        errs << "anderson: " << source << ":" << lineNumber << ": malformed effect \"" << token << "\" of function "
+             << tokens[0] << "\n";
+        lineWellFormed = false;
+        break;
+      }
+      summary.effects.push_back(effect);
+    }
+
+    if (lineWellFormed) {
+      _summaries[tokens[0]] = std::move(summary);
+    }
+    wellFormed &= lineWellFormed;
+  }
+  return wellFormed;
+}
+
+bool ExternalSummaries::ReadFile(const std::string &path, llvm::raw_ostream &errs) noexcept {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    errs << "anderson: cannot read external summaries from " << path << ": " << buffer.getError().message() << "\n";
+    return false;
+  }
+  return Parse((*buffer)->getBuffer(), path, errs);
+}
+
+const ExternalSummary* ExternalSummaries::GetCalleeSummary(const llvm::CallBase &call) const noexcept {
+  auto callee = call.getCalledFunction();
+  if (!callee || !callee->isDeclaration() || callee->isIntrinsic()) {
+    return nullptr;
+  }
+  auto it = _summaries.find(callee->getName());
+  if (it == _summaries.end()) {
+    return nullptr;
+  }
+
+  auto isPointer = [&call](unsigned index) noexcept {
+    return index < call.arg_size() && call.getArgOperand(index)->getType()->isPointerTy();
+  };
+  auto isPointerToPointer = [&call, &isPointer](unsigned index) noexcept {
+    return isPointer(index) && call.getArgOperand(index)->getType()->getPointerElementType()->isPointerTy();
+  };
+  for (const auto &effect : it->second.effects) {
+    auto applies = false;
+    switch (effect.kind) {
+      case ExternalEffect::Kind::ReturnsNew:
+        applies = call.getType()->isPointerTy();
+        break;
+      case ExternalEffect::Kind::ReturnsArgument:
+        applies = call.getType()->isPointerTy() && isPointer(effect.source);
+        break;
+      case ExternalEffect::Kind::ReturnsArgumentPointee:
+        applies = call.getType()->isPointerTy() && isPointerToPointer(effect.source);
+        break;
+      case ExternalEffect::Kind::StoresArgument:
+        applies = isPointerToPointer(effect.target) && isPointer(effect.source);
+        break;
+      case ExternalEffect::Kind::CopiesArgumentPointee:
+        applies = isPointer(effect.target) && isPointer(effect.source);
+        break;
+    }
+    if (!applies) {
+      return nullptr;
+    }
+  }
+  return &it->second;
+}
+
+void ExternalSummaries::Print(llvm::raw_ostream &os) const noexcept {
+  std::vector<llvm::StringRef> names;
+  names.reserve(_summaries.size());
+  for (const auto &entry : _summaries) {
+    names.push_back(entry.getKey());
+  }
+  std::sort(names.begin(), names.end());
+
+  for (auto name : names) {
+    os << name;
+    for (const auto &effect : _summaries.find(name)->second.effects) {
+      switch (effect.kind) {
+        case ExternalEffect::Kind::ReturnsNew:
+          os << " ret=new";
+          break;
+        case ExternalEffect::Kind::ReturnsArgument:
+          os << " ret=arg" << effect.source;
+          break;
+        case ExternalEffect::Kind::ReturnsArgumentPointee:
+          os << " ret=*arg" << effect.source;
+          break;
+        case ExternalEffect::Kind::StoresArgument:
+          os << " *arg" << effect.target << "=arg" << effect.source;
+          break;
+        case ExternalEffect::Kind::CopiesArgumentPointee:
+          os << " *arg" << effect.target << "=*arg" << effect.source;
+          break;
+      }
+    }
+    os << "\n";
+  }
+}
+
+} // namespace anderson
+
+} // namespace llvm
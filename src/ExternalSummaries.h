@@ -0,0 +1,170 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_EXTERNAL_SUMMARIES_H
+#define LLVM_ANDERSON_SRC_EXTERNAL_SUMMARIES_H
+
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * A pointer effect of an external function on its arguments and its return value.
+ */
+struct ExternalEffect {
+  enum class Kind {
+    /**
+     * `ret=new`: the function returns a pointer to an object allocated by the call.
+     */
+    ReturnsNew,
+
+    /**
+     * `ret=argN`: the function returns a pointer derived from its N-th argument.
+     */
+    ReturnsArgument,
+
+    /**
+     * `ret=*argN`: the function returns a pointer loaded from the memory its N-th argument points to.
+     */
+    ReturnsArgumentPointee,
+
+    /**
+     * `*argN=argM`: the function stores its M-th argument into the memory its N-th argument points to.
+     */
+    StoresArgument,
+
+    /**
+     * `*argN=*argM`: the function copies the memory its M-th argument points to, together with the pointers it holds,
+     * into the memory its N-th argument points to, e.g. `memcpy`.
+     */
+    CopiesArgumentPointee,
+  };
+
+  Kind kind;
+
+  /**
+   * The index of the argument read by the effect, i.e. N of `ret=argN` and `ret=*argN`, and M of `*argN=argM` and
+   * `*argN=*argM`.
+   */
+  unsigned source;
+
+  /**
+   * The index of the argument written through by a `*argN=argM` or a `*argN=*argM` effect. Always 0 for other kinds.
+   */
+  unsigned target;
+};
+
+/**
+ * The pointer effects of an external function.
+ *
+ * A summary is complete: the function neither captures its arguments nor returns pointers in any other way. A summary
+ * without effects describes a function that does not touch pointers at all, e.g. `free`.
+ */
+struct ExternalSummary {
+  std::vector<ExternalEffect> effects;
+
+  /**
+   * Determine whether the function returns a pointer to an object allocated by the call.
+   *
+   * @return whether the function returns a pointer to an object allocated by the call.
+   */
+  bool returnsNew() const noexcept {
+    for (const auto &effect : effects) {
+      if (effect.kind == ExternalEffect::Kind::ReturnsNew) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * Summaries of the pointer effects of functions declared but not defined in a module, keyed by function name.
+ *
+ * Summaries are read from text, one function per line:
+ *
+ *     # comment
+ *     malloc ret=new
+ *     strchr ret=arg0
+ *     strtol *arg1=arg0
+ *     memcpy ret=arg0 *arg0=*arg1
+ *     free
+ *
+ * The effects are `ret=new`, `ret=argN`, `ret=*argN`, `*argN=argM` and `*argN=*argM`. A later summary of a function
+ * replaces the earlier one.
+ */
+class ExternalSummaries {
+public:
+  /**
+   * Create the built-in summaries of common C library functions.
+   *
+   * @return the built-in summaries.
+   */
+  static ExternalSummaries CreateDefault() noexcept;
+
+  /**
+   * Add the summaries in the specified text.
+   *
+   * @param text the summaries.
+   * @param source the name of the text in error messages.
+   * @param errs the stream that malformed lines are reported to.
+   * @return whether every line is well-formed. Malformed lines are skipped.
+   */
+  bool Parse(llvm::StringRef text, llvm::StringRef source, llvm::raw_ostream &errs) noexcept;
+
+  /**
+   * Add the summaries in the specified file.
+   *
+   * @param path path to the file.
+   * @param errs the stream that errors are reported to.
+   * @return whether the file has been read and every line is well-formed.
+   */
+  bool ReadFile(const std::string &path, llvm::raw_ostream &errs) noexcept;
+
+  /**
+   * Get the summary of the function directly called by the specified call, if the function is only declared.
+   *
+   * A summary only applies to calls that pass pointers for every argument its effects refer to, pointers to pointers
+   * for every argument they store a pointer through or load a pointer from, and that return a pointer if it has effects
+   * on the return value. Copies accept pointers of any type, e.g. `i8*`. Other calls are treated as calls to functions without a summary.
+   *
+   * @param call the call.
+   * @return the summary of the callee, or nullptr if the call is indirect, the callee is defined in the module, the
+   * callee has no summary, or the summary does not apply to the call.
+   */
+  const ExternalSummary* GetCalleeSummary(const llvm::CallBase &call) const noexcept;
+
+  /**
+   * Print the summaries in the text format, sorted by function name.
+   *
+   * @param os the output stream.
+   */
+  void Print(llvm::raw_ostream &os) const noexcept;
+
+  /**
+   * Get the number of summarized functions.
+   *
+   * @return the number of summarized functions.
+   */
+  size_t GetNumSummaries() const noexcept {
+    return _summaries.size();
+  }
+
+private:
+  llvm::StringMap<ExternalSummary> _summaries;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_EXTERNAL_SUMMARIES_H
@@ -0,0 +1,277 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "IncrementalSolver.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constant.h>
+#include <llvm/IR/Instruction.h>
+
+#include "PointsToSolver.h"
+#include "Reachability.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+llvm::hash_code ComputeGlobalsFingerprint(const llvm::Module &module) noexcept {
+  auto hash = llvm::hash_value(module.global_size());
+  for (const auto &globalVariable : module.globals()) {
+    hash = llvm::hash_combine(hash, &globalVariable, globalVariable.getValueType(), globalVariable.getLinkage());
+  }
+  return hash;
+}
+
+/**
+ * Compute a fingerprint of everything in the specified function that may affect the generated constraints.
+ *
+ * The fingerprint covers the identities of the function, its arguments and instructions, together with the opcode,
+ * type and operand identities of each instruction. A function whose instructions have been replaced, even by identical
+ * ones, gets a different fingerprint, so its stale value trees are never kept.
+ */
+llvm::hash_code ComputeFunctionFingerprint(const llvm::Function &function) noexcept {
+  auto hash = llvm::hash_combine(&function, function.getFunctionType(), function.getLinkage());
+  for (const auto &arg : function.args()) {
+    hash = llvm::hash_combine(hash, &arg);
+  }
+  for (const auto &bb : function) {
+    hash = llvm::hash_combine(hash, &bb);
+    for (const auto &inst : bb) {
+      hash = llvm::hash_combine(hash, &inst, inst.getOpcode(), inst.getType());
+      for (const auto &operand : inst.operands()) {
+        hash = llvm::hash_combine(hash, operand.get());
+      }
+    }
+  }
+  return hash;
+}
+
+/**
+ * Collect the functions containing instructions that use the specified value, directly or through constants.
+ */
+void CollectUserFunctions(const llvm::Value *value, llvm::SmallPtrSetImpl<const llvm::Function *> &functions) noexcept {
+  llvm::SmallPtrSet<const llvm::Value *, 8> visited;
+  llvm::SmallVector<const llvm::Value *, 8> stack { value };
+  while (!stack.empty()) {
+    auto current = stack.pop_back_val();
+    for (auto user : current->users()) {
+      if (auto inst = llvm::dyn_cast<llvm::Instruction>(user)) {
+        functions.insert(inst->getFunction());
+      } else if (llvm::isa<llvm::Constant>(user) && visited.insert(user).second) {
+        stack.push_back(user);
+      }
+    }
+  }
+}
+
+/**
+ * Collect the functions and global variables whose constraints may be held by the specified pointer.
+ */
+void CollectEmitters(const ValueTreeNode &node,
+                     llvm::SmallPtrSetImpl<const llvm::Function *> &functions,
+                     llvm::SmallPtrSetImpl<const llvm::GlobalVariable *> &globalVariables) noexcept {
+  if (!node.isRoot()) {
+    // Constraints are only ever generated on the roots of value trees.
+    return;
+  }
+
+  if (node.isFunctionReturnValue()) {
+    functions.insert(node.GetFunction());
+    return;
+  }
+  if (!node.isNormalValue()) {
+    // Memory values only hold constraints derived by the solver.
+    return;
+  }
+
+  auto value = node.value();
+  if (auto inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+    functions.insert(inst->getFunction());
+  } else if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+    functions.insert(arg->getParent());
+    CollectUserFunctions(arg->getParent(), functions);
+  } else if (auto globalVariable = llvm::dyn_cast<llvm::GlobalVariable>(value)) {
+    globalVariables.insert(globalVariable);
+    CollectUserFunctions(globalVariable, functions);
+  } else {
+    CollectUserFunctions(value, functions);
+  }
+}
+
+} // namespace <anonymous>
+
+void IncrementalSolver::Initialize(const llvm::Module &module, ValueTree &valueTree,
+                                   std::vector<std::string> entryPoints) noexcept {
+  _dependencies.Build(valueTree);
+  _entryPoints = std::move(entryPoints);
+
+  _globalsFingerprint = ComputeGlobalsFingerprint(module);
+  _functionFingerprints.clear();
+  for (const auto &function : module) {
+    // Only the functions in the value tree are tracked; pruned functions are added once they become reachable.
+    if (valueTree.GetValueNode(&function)) {
+      _functionFingerprints[&function] = ComputeFunctionFingerprint(function);
+    }
+  }
+}
+
+std::unique_ptr<ValueTree> IncrementalSolver::Update(const llvm::Module &module,
+                                                     std::unique_ptr<ValueTree> valueTree) noexcept {
+  if (ComputeGlobalsFingerprint(module) != _globalsFingerprint) {
+    return nullptr;
+  }
+
+  std::unordered_set<const llvm::GlobalValue *> reachable;
+  if (!_entryPoints.empty()) {
+    reachable = ComputeReachableGlobals(module, _entryPoints);
+    for (const auto &globalVariable : module.globals()) {
+      // The value trees of global variables are only built from scratch.
+      if (reachable.count(&globalVariable) != (valueTree->GetValueNode(&globalVariable) != nullptr)) {
+        return nullptr;
+      }
+    }
+  }
+
+  // Identify the functions whose value trees are stale and the functions whose value trees need to be built. A function
+  // that is no longer reachable is not present, so its value trees are removed.
+  std::vector<const llvm::Function *> removedFunctions;
+  std::vector<const llvm::Function *> addedFunctions;
+  std::unordered_set<const llvm::Function *> presentFunctions;
+  for (const auto &function : module) {
+    if (!_entryPoints.empty() && !reachable.count(&function)) {
+      continue;
+    }
+    presentFunctions.insert(&function);
+    auto fingerprint = ComputeFunctionFingerprint(function);
+    auto it = _functionFingerprints.find(&function);
+    if (it != _functionFingerprints.end()) {
+      if (it->second == fingerprint) {
+        continue;
+      }
+      removedFunctions.push_back(&function);
+    }
+    addedFunctions.push_back(&function);
+    _functionFingerprints[&function] = fingerprint;
+  }
+  for (auto it = _functionFingerprints.begin(); it != _functionFingerprints.end(); ) {
+    if (presentFunctions.count(it->first)) {
+      ++it;
+      continue;
+    }
+    removedFunctions.push_back(it->first);
+    it = _functionFingerprints.erase(it);
+  }
+
+  if (removedFunctions.empty() && addedFunctions.empty()) {
+    return valueTree;
+  }
+
+  // Over-approximate the region affected by the change: every pointer whose constraints refer to an affected pointer,
+  // and every pointee of an affected pointer that holds store constraints, since the constraints derived from those
+  // stores may no longer hold.
+  std::unordered_set<Pointer *> removedPointers;
+  for (auto function : removedFunctions) {
+    valueTree->VisitFunction(function, [&removedPointers](ValueTreeNode &node) noexcept -> bool {
+      if (node.isPointer()) {
+        removedPointers.insert(node.pointer());
+      }
+      return true;
+    });
+  }
+
+  std::unordered_set<Pointer *> affected { removedPointers };
+  std::vector<Pointer *> stack { removedPointers.begin(), removedPointers.end() };
+  auto markAffected = [&affected, &stack](Pointer *pointer) noexcept {
+    if (affected.insert(pointer).second) {
+      stack.push_back(pointer);
+    }
+  };
+  while (!stack.empty()) {
+    auto pointer = stack.back();
+    stack.pop_back();
+
+    _dependencies.ForEachUser(pointer, markAffected);
+    DependencyIndex::ForEachStoreTarget(pointer, markAffected);
+  }
+
+  // Retract the affected region.
+  for (auto pointer : affected) {
+    _dependencies.RemoveEdgesFrom(pointer);
+  }
+
+  std::vector<Pointer *> retracted;
+  std::vector<Pointer *> storeOrigins;
+  for (auto pointer : affected) {
+    if (removedPointers.count(pointer)) {
+      _dependencies.RemoveEdgesTo(pointer);
+      continue;
+    }
+
+    // Stores outside of the affected region have derived constraints on this pointer, which are lost on reset.
+    _dependencies.ForEachStoreOrigin(pointer, [&affected, &storeOrigins](Pointer *origin) noexcept {
+      if (!affected.count(origin)) {
+        storeOrigins.push_back(origin);
+      }
+    });
+
+    pointer->Reset();
+    retracted.push_back(pointer);
+  }
+
+  for (auto function : removedFunctions) {
+    valueTree->RemoveFunction(function);
+  }
+  for (auto function : addedFunctions) {
+    valueTree->AddFunction(*function);
+  }
+
+  // Regenerate the constraints of the rebuilt value trees and of the retracted pointers. Constraints are deduplicated,
+  // so re-running the whole emitting function does not change the pointers outside of the affected region.
+  llvm::SmallPtrSet<const llvm::Function *, 8> emitterFunctions;
+  llvm::SmallPtrSet<const llvm::GlobalVariable *, 8> emitterGlobalVariables;
+  for (auto function : addedFunctions) {
+    emitterFunctions.insert(function);
+    CollectUserFunctions(function, emitterFunctions);
+  }
+  for (auto pointer : retracted) {
+    CollectEmitters(*pointer->node(), emitterFunctions, emitterGlobalVariables);
+  }
+
+  PointsToSolver solver { module, std::move(valueTree) };
+  solver.SetDependencyIndex(&_dependencies);
+  solver.SetTypeFilter(GetRequestedTypeFilter());
+
+  for (auto globalVariable : emitterGlobalVariables) {
+    solver.AddTrivialPointerAssignments(*globalVariable);
+  }
+  for (auto function : emitterFunctions) {
+    solver.AddTrivialPointerAssignments(*function);
+    for (const auto &bb : *function) {
+      for (const auto &inst : bb) {
+        UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+
+  for (auto pointer : retracted) {
+    solver.Enqueue(pointer);
+  }
+  for (auto pointer : storeOrigins) {
+    solver.Enqueue(pointer);
+  }
+  solver.SolveWorklist();
+
+  solver.SetDependencyIndex(nullptr);
+  return solver.TakeValueTree();
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,71 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_INCREMENTAL_SOLVER_H
+#define LLVM_ANDERSON_SRC_INCREMENTAL_SOLVER_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/ADT/Hashing.h>
+#include <llvm/IR/Module.h>
+
+#include "DependencyIndex.h"
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Keep the constraint graph of a solved module so that the solution can be updated after some functions in the module
+ * have been changed, without solving the whole module again.
+ *
+ * On update, the changed functions are identified by comparing per-function fingerprints. The value trees of the
+ * changed functions are rebuilt, and every pointer whose points-to set may depend on them is retracted: its
+ * constraints and points-to set are cleared and its constraints are regenerated from the functions that emit them.
+ * Finally the retracted pointers are re-solved with a worklist seeded by them. Pointers outside of the retracted
+ * region keep their constraints and points-to sets.
+ *
+ * If the value tree only covers the globals reachable from some entry points, reachability is recomputed on update.
+ * Functions that become reachable are added like new functions and functions that become unreachable are removed.
+ */
+class IncrementalSolver {
+public:
+  /**
+   * Record the state of the specified module and its solved value tree.
+   *
+   * @param module the module.
+   * @param valueTree the value tree solved from scratch for the module.
+   * @param entryPoints the entry points the value tree was pruned to, or empty if it covers the whole module.
+   */
+  void Initialize(const llvm::Module &module, ValueTree &valueTree,
+                  std::vector<std::string> entryPoints = { }) noexcept;
+
+  /**
+   * Update the solution in the specified value tree to match the current state of the specified module.
+   *
+   * @param module the module, possibly changed since the last call to `Initialize` or `Update`.
+   * @param valueTree the value tree of the module.
+   * @return the updated value tree. If the module cannot be updated incrementally, for example because its global
+   * variables have been changed or have become reachable or unreachable from the entry points, return nullptr; the
+   * caller should then solve the module from scratch.
+   */
+  std::unique_ptr<ValueTree> Update(const llvm::Module &module, std::unique_ptr<ValueTree> valueTree) noexcept;
+
+private:
+  DependencyIndex _dependencies;
+  std::vector<std::string> _entryPoints;
+  llvm::hash_code _globalsFingerprint;
+  std::unordered_map<const llvm::Function *, llvm::hash_code> _functionFingerprints;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_INCREMENTAL_SOLVER_H
@@ -0,0 +1,393 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/ModRefSummary.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+
+#include "PointsToSolver.h"
+#include "TaintAnalysis.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+/**
+ * Get the functions defined in the module that are called directly by the specified function.
+ */
+std::vector<const llvm::Function *> GetDefinedCallees(const llvm::Function &function) noexcept {
+  std::vector<const llvm::Function *> callees;
+  for (const auto &bb : function) {
+    for (const auto &inst : bb) {
+      auto call = llvm::dyn_cast<llvm::CallBase>(&inst);
+      if (!call) {
+        continue;
+      }
+      auto callee = call->getCalledFunction();
+      if (callee && !callee->isDeclaration()) {
+        callees.push_back(callee);
+      }
+    }
+  }
+  std::sort(callees.begin(), callees.end());
+  callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+  return callees;
+}
+
+/**
+ * Compute the strongly connected components of the direct call graph among the functions defined in the module.
+ *
+ * @return the components in reverse topological order, i.e. every component comes after all components it calls.
+ */
+std::vector<std::vector<const llvm::Function *>> GetCallGraphSCCs(const llvm::Module &module) noexcept {
+  struct Frame {
+    const llvm::Function *function;
+    std::vector<const llvm::Function *> callees;
+    size_t nextCallee;
+  };
+
+  llvm::DenseMap<const llvm::Function *, unsigned> indices;
+  llvm::DenseMap<const llvm::Function *, unsigned> lowLinks;
+  llvm::DenseMap<const llvm::Function *, bool> onStack;
+  std::vector<const llvm::Function *> stack;
+  std::vector<std::vector<const llvm::Function *>> sccs;
+
+  // Iterative version of Tarjan's algorithm, so that deep call chains do not overflow the native stack.
+  for (const auto &root : module) {
+    if (root.isDeclaration() || indices.count(&root)) {
+      continue;
+    }
+
+    std::vector<Frame> frames;
+    auto push = [&](const llvm::Function *function) noexcept {
+      auto index = static_cast<unsigned>(indices.size());
+      indices[function] = index;
+      lowLinks[function] = index;
+      onStack[function] = true;
+      stack.push_back(function);
+      frames.push_back(Frame { function, GetDefinedCallees(*function), 0 });
+    };
+    push(&root);
+
+    while (!frames.empty()) {
+      auto &frame = frames.back();
+      if (frame.nextCallee < frame.callees.size()) {
+        auto callee = frame.callees[frame.nextCallee++];
+        if (!indices.count(callee)) {
+          push(callee);
+        } else if (onStack[callee]) {
+          lowLinks[frame.function] = std::min(lowLinks[frame.function], indices[callee]);
+        }
+        continue;
+      }
+
+      auto function = frame.function;
+      frames.pop_back();
+      if (!frames.empty()) {
+        auto caller = frames.back().function;
+        lowLinks[caller] = std::min(lowLinks[caller], lowLinks[function]);
+      }
+
+      if (lowLinks[function] == indices[function]) {
+        std::vector<const llvm::Function *> scc;
+        const llvm::Function *member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member] = false;
+          scc.push_back(member);
+        } while (member != function);
+        sccs.push_back(std::move(scc));
+      }
+    }
+  }
+
+  return sccs;
+}
+
+/**
+ * Determine whether the specified call is a marker that does not access memory as far as clients are concerned.
+ */
+bool IsMarkerCall(const llvm::CallBase &call) noexcept {
+  if (llvm::isa<llvm::DbgInfoIntrinsic>(call)) {
+    return true;
+  }
+  auto intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(&call);
+  return intrinsic && intrinsic->isLifetimeStartOrEnd();
+}
+
+/**
+ * Determine whether the specified call only writes memory. The attribute is queried directly since the name of the
+ * corresponding `CallBase` member differs between LLVM versions.
+ */
+bool OnlyWritesMemory(const llvm::CallBase &call) noexcept {
+  return call.doesNotAccessMemory() || call.hasFnAttr(llvm::Attribute::WriteOnly);
+}
+
+} // namespace <anonymous>
+
+constexpr unsigned ModRefSummary::InvalidObject;
+
+ModRefSummary::ModRefSummary(const llvm::Module &module, const ValueTree &valueTree) noexcept
+  : _valueTree(&valueTree),
+    _taint(std::make_unique<TaintAnalysis>(module, valueTree)),
+    _objectNodes(),
+    _objectIds(),
+    _escapedObjects(),
+    _summaries(),
+    _pointerObjects()
+{
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (node && node->isRoot() && (node->isStackMemory() || node->isGlobalMemory() || node->isArgumentMemory() ||
+                                   node->isHeapMemory())) {
+      _objectIds[node] = static_cast<unsigned>(_objectNodes.size());
+      _objectNodes.push_back(node);
+    }
+  }
+
+  for (auto id : _taint->GetEscapedObjects()) {
+    auto it = _objectIds.find(valueTree.GetNode(id));
+    if (it != _objectIds.end()) {
+      _escapedObjects.set(it->second);
+    }
+  }
+
+  for (const auto &scc : GetCallGraphSCCs(module)) {
+    FunctionSummary summary;
+    for (auto function : scc) {
+      summary.MergeFrom(ComputeLocalSummary(*function));
+    }
+
+    // Callees outside of the component come earlier in the order and have already been summarized.
+    for (auto function : scc) {
+      for (auto callee : GetDefinedCallees(*function)) {
+        auto it = _summaries.find(callee);
+        if (it != _summaries.end()) {
+          summary.MergeFrom(it->second);
+        }
+      }
+    }
+
+    for (auto function : scc) {
+      _summaries[function] = summary;
+    }
+  }
+}
+
+ModRefSummary::ModRefSummary(ModRefSummary &&) noexcept = default;
+
+ModRefSummary& ModRefSummary::operator=(ModRefSummary &&) noexcept = default;
+
+ModRefSummary::~ModRefSummary() noexcept = default;
+
+unsigned ModRefSummary::GetObjectId(const ValueTreeNode &node) const noexcept {
+  auto root = &node;
+  while (!root->isRoot()) {
+    root = root->parent();
+  }
+  auto it = _objectIds.find(root);
+  return it == _objectIds.end() ? InvalidObject : it->second;
+}
+
+const ModRefSummary::PointerObjects& ModRefSummary::GetPointerObjects(const llvm::Value *pointer) const noexcept {
+  auto it = _pointerObjects.find(pointer);
+  if (it != _pointerObjects.end()) {
+    return it->second;
+  }
+
+  PointerObjects result;
+  auto value = pointer;
+  if (!_taint->GetObjects(value) && llvm::isa<llvm::Constant>(pointer)) {
+    // Constant expressions have no value tree nodes, but all objects are roots, so offsets from a global do not matter.
+    value = pointer->stripInBoundsOffsets();
+  }
+  auto objects = _taint->GetObjects(value);
+  if (!objects || objects->empty()) {
+    result.unknown = !llvm::isa<llvm::ConstantPointerNull>(pointer) && !llvm::isa<llvm::UndefValue>(pointer);
+  } else {
+    for (auto id : *objects) {
+      auto objectId = GetObjectId(*_valueTree->GetNode(id));
+      if (objectId != InvalidObject) {
+        result.objects.set(objectId);
+      }
+    }
+    if (_taint->isTainted(value)) {
+      result.objects |= _escapedObjects;
+    }
+  }
+
+  return _pointerObjects.insert(std::make_pair(pointer, std::move(result))).first->second;
+}
+
+ModRefSummary::FunctionSummary ModRefSummary::ComputeLocalSummary(const llvm::Function &function) const noexcept {
+  FunctionSummary summary;
+  auto addMod = [this, &summary](const llvm::Value *pointer) noexcept {
+    const auto &objects = GetPointerObjects(pointer);
+    summary.modAny |= objects.unknown;
+    summary.mod |= objects.objects;
+  };
+  auto addRef = [this, &summary](const llvm::Value *pointer) noexcept {
+    const auto &objects = GetPointerObjects(pointer);
+    summary.refAny |= objects.unknown;
+    summary.ref |= objects.objects;
+  };
+
+  for (const auto &bb : function) {
+    for (const auto &inst : bb) {
+      if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+        addRef(load->getPointerOperand());
+      } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+        addMod(store->getPointerOperand());
+      } else if (auto rmw = llvm::dyn_cast<llvm::AtomicRMWInst>(&inst)) {
+        addMod(rmw->getPointerOperand());
+        addRef(rmw->getPointerOperand());
+      } else if (auto cmpxchg = llvm::dyn_cast<llvm::AtomicCmpXchgInst>(&inst)) {
+        addMod(cmpxchg->getPointerOperand());
+        addRef(cmpxchg->getPointerOperand());
+      } else if (auto vaArg = llvm::dyn_cast<llvm::VAArgInst>(&inst)) {
+        addMod(vaArg->getPointerOperand());
+        addRef(vaArg->getPointerOperand());
+      } else if (auto memTransfer = llvm::dyn_cast<llvm::MemTransferInst>(&inst)) {
+        addMod(memTransfer->getRawDest());
+        addRef(memTransfer->getRawSource());
+      } else if (auto memSet = llvm::dyn_cast<llvm::MemSetInst>(&inst)) {
+        addMod(memSet->getRawDest());
+      } else if (auto call = llvm::dyn_cast<llvm::CallBase>(&inst)) {
+        auto callee = call->getCalledFunction();
+        if ((callee && !callee->isDeclaration()) || IsMarkerCall(*call) || call->doesNotAccessMemory()) {
+          // Calls to defined functions are accounted for when the summaries are propagated over the call graph.
+          continue;
+        }
+
+        auto mayWrite = !call->onlyReadsMemory();
+        auto mayRead = !OnlyWritesMemory(*call);
+        if (!call->onlyAccessesArgMemory()) {
+          summary.modAny |= mayWrite;
+          summary.refAny |= mayRead;
+          continue;
+        }
+        for (const auto &arg : call->args()) {
+          if (!arg->getType()->isPointerTy()) {
+            continue;
+          }
+          if (mayWrite) {
+            addMod(arg.get());
+          }
+          if (mayRead) {
+            addRef(arg.get());
+          }
+        }
+      }
+    }
+  }
+
+  return summary;
+}
+
+llvm::ModRefInfo ModRefSummary::GetModRefInfo(const llvm::Function &function,
+                                              const llvm::Value *pointer) const noexcept {
+  auto summary = GetSummary(function);
+  if (!summary) {
+    return llvm::ModRefInfo::ModRef;
+  }
+
+  const auto &objects = GetPointerObjects(pointer);
+  auto mayMod = summary->modAny || (objects.unknown ? !summary->mod.empty() : summary->mod.intersects(objects.objects));
+  auto mayRef = summary->refAny || (objects.unknown ? !summary->ref.empty() : summary->ref.intersects(objects.objects));
+
+  auto result = llvm::ModRefInfo::NoModRef;
+  if (mayMod) {
+    result = llvm::setMod(result);
+  }
+  if (mayRef) {
+    result = llvm::setRef(result);
+  }
+  return result;
+}
+
+llvm::ModRefInfo ModRefSummary::GetModRefInfo(const llvm::CallBase &call, const llvm::Value *pointer) const noexcept {
+  if (call.doesNotAccessMemory()) {
+    return llvm::ModRefInfo::NoModRef;
+  }
+
+  auto callee = call.getCalledFunction();
+  auto result = callee && !callee->isDeclaration() ? GetModRefInfo(*callee, pointer) : llvm::ModRefInfo::ModRef;
+  if (call.onlyReadsMemory()) {
+    result = llvm::clearMod(result);
+  }
+  if (OnlyWritesMemory(call)) {
+    result = llvm::clearRef(result);
+  }
+  return result;
+}
+
+bool ModRefSummary::invalidate(llvm::Module &module,
+                               const llvm::PreservedAnalyses &preserved,
+                               llvm::ModuleAnalysisManager::Invalidator &invalidator) noexcept {
+  auto checker = preserved.getChecker<AndersonModRefAnalysis>();
+  if (!checker.preserved() && !checker.preservedSet<llvm::AllAnalysesOn<llvm::Module>>()) {
+    return true;
+  }
+  return invalidator.invalidate<AndersonAnalysis>(module, preserved);
+}
+
+void ModRefSummary::print(llvm::raw_ostream &os, const llvm::Module &module) const noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+
+  auto printObjects = [this, &os, &slotTracker](const llvm::SparseBitVector<> &objects, bool any) noexcept {
+    if (any) {
+      os << " *";
+      return;
+    }
+    std::set<std::string> names;
+    for (auto objectId : objects) {
+      names.insert(GetNodeName(*_objectNodes[objectId], slotTracker));
+    }
+    for (const auto &name : names) {
+      os << " " << name;
+    }
+  };
+
+  for (const auto &function : module) {
+    auto summary = GetSummary(function);
+    if (!summary) {
+      continue;
+    }
+
+    os << function.getName() << ": mod";
+    printObjects(summary->mod, summary->modAny);
+    os << "; ref";
+    printObjects(summary->ref, summary->refAny);
+    os << "\n";
+  }
+}
+
+llvm::AnalysisKey AndersonModRefAnalysis::Key;
+
+AndersonModRefAnalysis::Result AndersonModRefAnalysis::run(llvm::Module &module,
+                                                           llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  return Result { module, *moduleAnalysisManager.getResult<AndersonAnalysis>(module).GetValueTree() };
+}
+
+llvm::PreservedAnalyses AndersonModRefPrinterPass::run(llvm::Module &module,
+                                                       llvm::ModuleAnalysisManager &moduleAnalysisManager) noexcept {
+  _os << "Anderson mod/ref summaries for module '" << module.getName() << "':\n";
+  moduleAnalysisManager.getResult<AndersonModRefAnalysis>(module).print(_os, module);
+  return llvm::PreservedAnalyses::all();
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,142 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/PointsToQuery.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+namespace anderson {
+
+constexpr uint32_t PointsToQuery::InvalidNode;
+
+PointsToQuery::PointsToQuery() noexcept
+  : _valueNodes(),
+    _nodeRoots(),
+    _nodeKinds(),
+    _nodeValues(),
+    _pointeeOffsets(),
+    _pointees(),
+    _pointerOffsets(),
+    _pointers(),
+    _unknown()
+{ }
+
+std::shared_ptr<const PointsToQuery> PointsToQuery::Build(const ValueTree &valueTree) noexcept {
+  auto numNodes = valueTree.GetNumNodes();
+  assert(numNodes < InvalidNode && "too many nodes for the query snapshot");
+
+  std::shared_ptr<PointsToQuery> query { new PointsToQuery() };
+  query->_nodeRoots.assign(numNodes, InvalidNode);
+  query->_nodeKinds.assign(numNodes, ValueKind::Normal);
+  query->_nodeValues.assign(numNodes, nullptr);
+  query->_pointeeOffsets.assign(numNodes + 1, 0);
+  query->_pointerOffsets.assign(numNodes + 1, 0);
+  query->_unknown.resize(static_cast<unsigned>(numNodes));
+
+  for (size_t id = 0; id < numNodes; ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node) {
+      continue;
+    }
+
+    auto root = node;
+    while (!root->isRoot()) {
+      root = root->parent();
+    }
+    query->_nodeRoots[id] = static_cast<uint32_t>(root->id());
+    query->_nodeKinds[id] = node->kind();
+
+    if (node->isRoot() && node->value()) {
+      query->_nodeValues[id] = node->value();
+      if (node->isNormalValue()) {
+        query->_valueNodes[node->value()] = static_cast<uint32_t>(id);
+      }
+    }
+
+    if (!node->isPointer()) {
+      query->_pointeeOffsets[id + 1] = query->_pointees.size();
+      continue;
+    }
+
+    if (node->pointer()->isUnknown()) {
+      query->_unknown.set(static_cast<unsigned>(id));
+    }
+
+    auto rowBegin = query->_pointees.size();
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      auto pointeeId = pointee->node()->id();
+      query->_pointees.push_back(static_cast<uint32_t>(pointeeId));
+      ++query->_pointerOffsets[pointeeId + 1];
+    }
+    std::sort(query->_pointees.begin() + rowBegin, query->_pointees.end());
+    query->_pointeeOffsets[id + 1] = query->_pointees.size();
+  }
+
+  // Build the reverse relation from the forward one. Pointers are visited in ascending order, so every row of the
+  // reverse relation ends up sorted.
+  auto &pointerOffsets = query->_pointerOffsets;
+  for (size_t i = 1; i < pointerOffsets.size(); ++i) {
+    pointerOffsets[i] += pointerOffsets[i - 1];
+  }
+  query->_pointers.resize(pointerOffsets.back());
+  std::vector<size_t> cursors { pointerOffsets.begin(), pointerOffsets.end() - 1 };
+  for (size_t id = 0; id < numNodes; ++id) {
+    for (auto pointee : query->GetPointees(static_cast<uint32_t>(id))) {
+      query->_pointers[cursors[pointee]++] = static_cast<uint32_t>(id);
+    }
+  }
+
+  return query;
+}
+
+bool PointsToQuery::MayPointTo(uint32_t pointer, uint32_t pointee) const noexcept {
+  if (isUnknown(pointer)) {
+    return true;
+  }
+  auto pointees = GetPointees(pointer);
+  return std::binary_search(pointees.begin(), pointees.end(), pointee);
+}
+
+bool PointsToQuery::MayAlias(const llvm::Value *lhs, const llvm::Value *rhs) const noexcept {
+  auto lhsNode = GetValueNode(lhs);
+  auto rhsNode = GetValueNode(rhs);
+  if (lhsNode == InvalidNode || rhsNode == InvalidNode || isUnknown(lhsNode) || isUnknown(rhsNode)) {
+    return true;
+  }
+
+  auto lhsObjects = GetPointeeObjects(lhsNode);
+  auto rhsObjects = GetPointeeObjects(rhsNode);
+  if (lhsObjects.empty() || rhsObjects.empty()) {
+    return true;
+  }
+
+  auto lhsIt = lhsObjects.begin();
+  auto rhsIt = rhsObjects.begin();
+  while (lhsIt != lhsObjects.end() && rhsIt != rhsObjects.end()) {
+    if (*lhsIt < *rhsIt) {
+      ++lhsIt;
+    } else if (*rhsIt < *lhsIt) {
+      ++rhsIt;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+llvm::SmallVector<uint32_t, 8> PointsToQuery::GetPointeeObjects(uint32_t node) const noexcept {
+  llvm::SmallVector<uint32_t, 8> objects;
+  for (auto pointee : GetPointees(node)) {
+    objects.push_back(GetRootNode(pointee));
+  }
+  std::sort(objects.begin(), objects.end());
+  objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+  return objects;
+}
+
+} // namespace anderson
+
+} // namespace llvm
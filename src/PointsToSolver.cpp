@@ -4,44 +4,757 @@
 
 #include "PointsToSolver.h"
 
+#include <algorithm>
 #include <list>
+#include <string>
+#include <utility>
+
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/TimeProfiler.h>
+
+#include "SteensgaardAnalysis.h"
+
+#define DEBUG_TYPE "anderson"
+
+STATISTIC(NumSolveIterations, "Number of outer iterations of the exhaustive solver");
+STATISTIC(NumWorklistPops, "Number of pointers popped from the solver worklist");
+STATISTIC(NumIdleWorklistPops, "Number of pointers popped from the solver worklist whose points-to sets did not grow");
+STATISTIC(NumScheduleRounds, "Number of rounds of the two-phase worklist order");
+STATISTIC(NumCopyGraphComponents, "Number of strongly connected components of the copy graph ranked by the "
+                                  "topological worklist order");
+STATISTIC(NumAssignedPointeeRelaxed, "Number of load constraints relaxed");
+STATISTIC(NumElementPtrRelaxed, "Number of assignment and getelementptr constraints relaxed");
+STATISTIC(NumPointeeAssignedRelaxed, "Number of store constraints relaxed");
+STATISTIC(NumPointeeCopiedRelaxed, "Number of memory copy constraints relaxed");
+STATISTIC(NumAddressOfPointees, "Number of pointees added by address-of constraints");
+STATISTIC(NumElementPtrPointees, "Number of pointees added by assignment and getelementptr constraints");
+STATISTIC(NumLoadAssignments, "Number of assignments added by relaxing load constraints");
+STATISTIC(NumStoreAssignments, "Number of assignments added by relaxing store constraints");
+STATISTIC(NumCopyAssignments, "Number of assignments added by relaxing memory copy constraints");
+STATISTIC(NumFilteredPointees, "Number of pointees skipped or rejected by the type filter when relaxing loads and "
+                               "stores");
+STATISTIC(NumSetUnions, "Number of pointee set unions");
+STATISTIC(NumBytesMerged, "Number of bytes of pointee sets merged by set unions");
+STATISTIC(NumBudgetsExceeded, "Number of solver runs stopped because the budget was exceeded");
+STATISTIC(NumCancellations, "Number of solver runs stopped because they were cancelled");
+STATISTIC(NumRegions, "Number of independent regions found by the unification pre-pass");
+STATISTIC(NumFallbackRegions, "Number of regions whose points-to sets are taken from the unification pre-pass");
+STATISTIC(NumUnknownPointers, "Number of pointers marked as unknown after the budget was exceeded");
+
+namespace {
+
+/**
+ * Number of relaxed pointers between two checks of the solver budget and of the cancellation token.
+ */
+constexpr size_t BudgetCheckInterval = 256;
+
+/**
+ * Number of relaxed pointers between two progress reports.
+ */
+constexpr size_t ProgressInterval = 16 * BudgetCheckInterval;
+
+/**
+ * Worklist order policy that pops the oldest pointer first.
+ */
+struct FifoOrder {
+  static llvm::anderson::Pointer* Pop(std::deque<llvm::anderson::Pointer *> &worklist,
+                                      llvm::anderson::WorklistSchedule &) noexcept {
+    auto pointer = worklist.front();
+    worklist.pop_front();
+    return pointer;
+  }
+};
+
+/**
+ * Worklist order policy that pops the newest pointer first, following a chain of changes depth-first.
+ */
+struct LifoOrder {
+  static llvm::anderson::Pointer* Pop(std::deque<llvm::anderson::Pointer *> &worklist,
+                                      llvm::anderson::WorklistSchedule &) noexcept {
+    auto pointer = worklist.back();
+    worklist.pop_back();
+    return pointer;
+  }
+};
+
+void Fire(const llvm::anderson::Pointer *pointer, llvm::anderson::WorklistSchedule &schedule) noexcept {
+  schedule.lastFired[pointer->node()->id()] = ++schedule.clock;
+}
+
+/**
+ * Pop the pointer with the highest priority off the worklist, whose front `schedule.heapSize` pointers form a binary
+ * heap. The pointers enqueued since the last pop are added to the heap first.
+ *
+ * @param lowerPriority the comparison that determines whether the first pointer has a lower priority than the second.
+ */
+template <typename Compare>
+llvm::anderson::Pointer* PopHeap(std::deque<llvm::anderson::Pointer *> &worklist,
+                                 llvm::anderson::WorklistSchedule &schedule, Compare lowerPriority) noexcept {
+  while (schedule.heapSize < worklist.size()) {
+    ++schedule.heapSize;
+    std::push_heap(worklist.begin(), worklist.begin() + schedule.heapSize, lowerPriority);
+  }
+  std::pop_heap(worklist.begin(), worklist.end(), lowerPriority);
+  auto pointer = worklist.back();
+  worklist.pop_back();
+  --schedule.heapSize;
+  return pointer;
+}
+
+/**
+ * Worklist order policy that pops the least recently fired pointer first.
+ */
+struct LrfOrder {
+  static llvm::anderson::Pointer* Pop(std::deque<llvm::anderson::Pointer *> &worklist,
+                                      llvm::anderson::WorklistSchedule &schedule) noexcept {
+    const auto &lastFired = schedule.lastFired;
+    auto pointer = PopHeap(worklist, schedule, [&lastFired](const llvm::anderson::Pointer *lhs,
+                                                            const llvm::anderson::Pointer *rhs) noexcept {
+      return lastFired[lhs->node()->id()] > lastFired[rhs->node()->id()];
+    });
+    Fire(pointer, schedule);
+    return pointer;
+  }
+};
+
+/**
+ * Worklist order policy that pops the pointer with the lowest topological rank in the collapsed copy graph first, so
+ * that a pointer is relaxed after the pointers it copies from.
+ */
+struct TopologicalOrder {
+  static llvm::anderson::Pointer* Pop(std::deque<llvm::anderson::Pointer *> &worklist,
+                                      llvm::anderson::WorklistSchedule &schedule) noexcept {
+    const auto &ranks = schedule.ranks;
+    return PopHeap(worklist, schedule, [&ranks](const llvm::anderson::Pointer *lhs,
+                                                const llvm::anderson::Pointer *rhs) noexcept {
+      return ranks[lhs->node()->id()] > ranks[rhs->node()->id()];
+    });
+  }
+};
+
+/**
+ * Worklist order policy that relaxes the worklist in rounds, each in least recently fired order.
+ */
+struct TwoPhaseOrder {
+  static llvm::anderson::Pointer* Pop(std::deque<llvm::anderson::Pointer *> &worklist,
+                                      llvm::anderson::WorklistSchedule &schedule) noexcept {
+    if (schedule.roundLeft == 0) {
+      // The pointers enqueued during the last round form the next one.
+      const auto &lastFired = schedule.lastFired;
+      std::stable_sort(worklist.begin(), worklist.end(), [&lastFired](const llvm::anderson::Pointer *lhs,
+                                                                      const llvm::anderson::Pointer *rhs) noexcept {
+        return lastFired[lhs->node()->id()] < lastFired[rhs->node()->id()];
+      });
+      schedule.roundLeft = worklist.size();
+      ++NumScheduleRounds;
+    }
+    --schedule.roundLeft;
+    auto pointer = worklist.front();
+    worklist.pop_front();
+    Fire(pointer, schedule);
+    return pointer;
+  }
+};
+
+/**
+ * Instrumentation policy of a solver run that profiles, reports progress, polls a cancellation token or tracks a
+ * budget.
+ */
+struct Instrumented {
+  static constexpr bool Enabled = true;
+};
+
+/**
+ * Instrumentation policy of a solver run that needs none of the instrumentation, so that the checks are compiled out
+ * of the hot loop.
+ */
+struct Uninstrumented {
+  static constexpr bool Enabled = false;
+};
+
+} // namespace <anonymous>
 
 namespace llvm {
 
 namespace anderson {
 
+void PointsToSolver::SetTypeFilter(TypeFilterMode mode) noexcept {
+  if (mode == TypeFilterMode::None) {
+    _typeFilter.reset();
+  } else {
+    _typeFilter = std::make_unique<TypeFilter>(*_valueTree);
+  }
+}
+
+bool PointsToSolver::AddAssignedAddressOf(Pointer *pointer, Pointee *pointee) noexcept {
+  if (!pointer->AssignedAddressOf(pointee)) {
+    return false;
+  }
+  if (_dependencies) {
+    Enqueue(pointer);
+  }
+  return true;
+}
+
+bool PointsToSolver::AddAssignedPointer(Pointer *pointer, Pointer *rhs) noexcept {
+  return AddAssignedPointer<Instrumented>(pointer, rhs);
+}
+
+template <typename Instrumentation>
+bool PointsToSolver::AddAssignedPointer(Pointer *pointer, Pointer *rhs) noexcept {
+  if (!pointer->AssignedPointer(rhs)) {
+    return false;
+  }
+  if (Instrumentation::Enabled) {
+    Touch(pointer);
+  }
+  OnConstraintAdded(pointer, rhs);
+  return true;
+}
+
+bool PointsToSolver::AddAssignedElementPtr(Pointer *pointer, Pointer *rhs,
+                                           std::vector<PointerIndex> indexSequence) noexcept {
+  if (!pointer->AssignedElementPtr(rhs, std::move(indexSequence))) {
+    return false;
+  }
+  OnConstraintAdded(pointer, rhs);
+  return true;
+}
+
+bool PointsToSolver::AddAssignedPointee(Pointer *pointer, Pointer *rhs) noexcept {
+  if (!pointer->AssignedPointee(rhs)) {
+    return false;
+  }
+  OnConstraintAdded(pointer, rhs);
+  return true;
+}
+
+bool PointsToSolver::AddPointeeAssigned(Pointer *pointer, Pointer *rhs) noexcept {
+  if (!pointer->PointeeAssigned(rhs)) {
+    return false;
+  }
+  OnConstraintAdded(pointer, rhs);
+  return true;
+}
+
+bool PointsToSolver::AddPointeeCopied(Pointer *pointer, Pointer *rhs) noexcept {
+  if (!pointer->PointeeCopied(rhs)) {
+    return false;
+  }
+  OnConstraintAdded(pointer, rhs);
+  return true;
+}
+
+void PointsToSolver::OnConstraintAdded(Pointer *pointer, Pointer *rhs) noexcept {
+  if (!_dependencies) {
+    return;
+  }
+  _dependencies->AddUser(rhs, pointer);
+  Enqueue(pointer);
+}
+
 void PointsToSolver::Solve() noexcept {
-  AddTrivialPointerAssignments();
+  llvm::TimeTraceScope timeScope { "AndersonSolve" };
+
+  if (_module) {
+    AddTrivialPointerAssignments();
+  }
   RelaxPointsToConstraints();
+  StartBudget();
+  _numPointers = _valueTree->GetNumPointers();
+  ReportProgress(SolverPhase::Solve);
 
+  auto exceeded = isInstrumented() ? !RunSweeps<Instrumented>() : !RunSweeps<Uninstrumented>();
+
+  if (exceeded) {
+    // Every change made before the previous iteration has been seen by all pointers depending on it, since all
+    // pointers have been relaxed since then.
+    std::vector<Pointer *> seeds;
+    for (size_t id = 0; id < _valueTree->GetNumNodes(); ++id) {
+      auto node = _valueTree->GetNode(id);
+      if (node && node->isPointer() && _lastTouched[id] + 1 >= _iteration) {
+        seeds.push_back(node->pointer());
+      }
+    }
+    Degrade(seeds);
+  }
+  _lastTouched.clear();
+  _numPointers = 0;
+  _numVisited = 0;
+  ReportProgress(SolverPhase::Done);
+}
+
+template <typename Instrumentation>
+bool PointsToSolver::RunSweeps() noexcept {
   auto converged = false;
-  auto visitor = [&converged](ValueTreeNode &node) noexcept -> bool {
-    converged = true;
-    if (!RelaxNode(node)) {
+  auto exceeded = false;
+  auto visitor = [this, &converged, &exceeded](ValueTreeNode &node) noexcept -> bool {
+    if (!node.isPointer()) {
+      return true;
+    }
+    if (Instrumentation::Enabled) {
+      if (ShouldStop()) {
+        exceeded = true;
+        return false;
+      }
+      ++_numVisited;
+    }
+    if (!RelaxNode<Instrumentation>(node)) {
       converged = false;
     }
     return true;
   };
 
-  while (!converged) {
+  while (!converged && !exceeded) {
+    llvm::TimeTraceScope iterationScope { "AndersonSolveIteration", [this]() {
+      return std::to_string(_iteration);
+    } };
+    ++NumSolveIterations;
+    ++_iteration;
+    _numVisited = 0;
+
+    converged = true;
     _valueTree->Visit(visitor);
   }
+  return !exceeded;
 }
 
-void PointsToSolver::AddTrivialPointerAssignments() const noexcept {
-  // Add points-to constraints from global variables to corresponding global memory values.
-  for (const auto &globalVariable : _module.globals()) {
-    auto globalVariableNode = _valueTree->GetValueNode(&globalVariable);
-    auto globalVariableMemoryNode = _valueTree->GetGlobalMemoryNode(&globalVariable);
-    assert(globalVariableNode->isPointer());
-    globalVariableNode->pointer()->AssignedAddressOf(globalVariableMemoryNode->pointee());
+void PointsToSolver::SolveWorklist() noexcept {
+  assert(_dependencies && "dependency index is not attached");
+  llvm::TimeTraceScope timeScope { "AndersonSolveWorklist" };
+  StartBudget();
+  ReportProgress(SolverPhase::Solve);
+
+  if (!RunWorklist()) {
+    // Only the pointers on the worklist have operands that changed since they were last relaxed.
+    std::vector<Pointer *> seeds { _worklist.begin(), _worklist.end() };
+    _worklist.clear();
+    _worklistSet.clear();
+    Degrade(seeds);
   }
+  _lastTouched.clear();
+  ReportProgress(SolverPhase::Done);
+}
 
-  // Add points-to constraints from exported function arguments to corresponding argument memory values.
-  for (const auto &function : _module) {
-    if (!llvm::GlobalValue::isExternalLinkage(function.getLinkage())) {
+void PointsToSolver::Solve(SolverMode mode) noexcept {
+  switch (mode) {
+    case SolverMode::Exhaustive:
+      Solve();
+      break;
+    case SolverMode::Worklist: {
+      // Solve and SolvePartitioned add the trivial pointer assignments themselves.
+      if (_module) {
+        AddTrivialPointerAssignments();
+      }
+      DependencyIndex dependencies;
+      dependencies.Build(*_valueTree);
+      auto previousDependencies = _dependencies;
+      SetDependencyIndex(&dependencies);
+      _valueTree->Visit([this](ValueTreeNode &node) noexcept -> bool {
+        if (node.isPointer()) {
+          Enqueue(node.pointer());
+        }
+        return true;
+      });
+      SolveWorklist();
+      SetDependencyIndex(previousDependencies);
+      break;
+    }
+    case SolverMode::Partitioned:
+      SolvePartitioned();
+      break;
+  }
+}
+
+void PointsToSolver::SolvePartitioned() noexcept {
+  llvm::TimeTraceScope timeScope { "AndersonSolvePartitioned" };
+
+  if (_module) {
+    AddTrivialPointerAssignments();
+  }
+
+  SteensgaardAnalysis unification { *_valueTree };
+  auto regions = unification.GetRegions();
+  NumRegions += regions.size();
+
+  // Seed the worklist of each region in the order the value tree visits its nodes, as `Solve` relaxes them.
+  std::vector<uint32_t> order(_valueTree->GetNumNodes());
+  uint32_t position = 0;
+  _valueTree->Visit([&order, &position](ValueTreeNode &node) noexcept -> bool {
+    order[node.id()] = position++;
+    return true;
+  });
+  for (auto &pointers : regions) {
+    std::sort(pointers.begin(), pointers.end(), [&order](const Pointer *lhs, const Pointer *rhs) noexcept {
+      return order[lhs->node()->id()] < order[rhs->node()->id()];
+    });
+  }
+
+  DependencyIndex dependencies;
+  dependencies.Build(*_valueTree);
+  auto savedDependencies = _dependencies;
+  auto savedRegion = _region;
+  _dependencies = &dependencies;
+
+  StartBudget();
+  ReportProgress(SolverPhase::Solve);
+
+  // No user of a pointer lies outside of its region, so the worklist stays within the region being solved without
+  // filtering. Small regions are solved first, so that the budget runs out on the large ones.
+  _region = nullptr;
+  auto exceeded = false;
+  for (const auto &pointers : regions) {
+    if (!exceeded) {
+      for (auto pointer : pointers) {
+        Enqueue(pointer);
+      }
+      if (RunWorklist()) {
+        continue;
+      }
+      exceeded = true;
+      _worklist.clear();
+      _worklistSet.clear();
+      _valueTree->MarkApproximate();
+    }
+
+    // No constraint crosses the boundary of a region, so the rest of the solution is unaffected by the fallback.
+    ++NumFallbackRegions;
+    for (auto pointer : pointers) {
+      unification.AssignFallbackPointees(*pointer);
+    }
+  }
+
+  _dependencies = savedDependencies;
+  _region = savedRegion;
+  _lastTouched.clear();
+  ReportProgress(SolverPhase::Done);
+}
+
+bool PointsToSolver::RunWorklist() noexcept {
+  // The worklist may have been changed by other means since the last run.
+  _schedule.heapSize = 0;
+  _schedule.roundLeft = 0;
+  if (_worklistOrder == WorklistOrder::Lrf || _worklistOrder == WorklistOrder::TwoPhase) {
+    _schedule.lastFired.resize(_valueTree->GetNumNodes(), 0);
+  } else if (_worklistOrder == WorklistOrder::Topological && _schedule.ranks.size() != _valueTree->GetNumNodes()) {
+    RankCopyGraph();
+  }
+
+  auto instrumented = isInstrumented();
+  switch (_worklistOrder) {
+    case WorklistOrder::Fifo:
+      return instrumented ? RunWorklist<FifoOrder, Instrumented>() : RunWorklist<FifoOrder, Uninstrumented>();
+    case WorklistOrder::Lifo:
+      return instrumented ? RunWorklist<LifoOrder, Instrumented>() : RunWorklist<LifoOrder, Uninstrumented>();
+    case WorklistOrder::Lrf:
+      return instrumented ? RunWorklist<LrfOrder, Instrumented>() : RunWorklist<LrfOrder, Uninstrumented>();
+    case WorklistOrder::Topological:
+      return instrumented ? RunWorklist<TopologicalOrder, Instrumented>()
+                          : RunWorklist<TopologicalOrder, Uninstrumented>();
+    case WorklistOrder::TwoPhase:
+      return instrumented ? RunWorklist<TwoPhaseOrder, Instrumented>() : RunWorklist<TwoPhaseOrder, Uninstrumented>();
+  }
+  llvm_unreachable("unknown worklist order");
+}
+
+template <typename Order, typename Instrumentation>
+bool PointsToSolver::RunWorklist() noexcept {
+  while (!_worklist.empty()) {
+    if (Instrumentation::Enabled && ShouldStop()) {
+      return false;
+    }
+
+    auto pointer = Order::Pop(_worklist, _schedule);
+    _worklistSet.erase(pointer);
+    ++NumWorklistPops;
+    if (Instrumentation::Enabled) {
+      _numRelaxed += pointer->GetNumAssignedAddressOf();
+    }
+
+    auto &pointees = pointer->GetPointeeSet();
+    auto oldSize = pointees.size();
+    for (auto &e : pointer->assigned_address_of()) {
+      if (pointees.insert(e.pointee())) {
+        ++NumAddressOfPointees;
+      }
+    }
+    RelaxNode<Instrumentation>(*pointer->node());
+
+    if (pointees.size() != oldSize) {
+      _dependencies->ForEachUser(pointer, [this](Pointer *user) noexcept {
+        Enqueue(user);
+      });
+    } else {
+      ++NumIdleWorklistPops;
+    }
+  }
+  return true;
+}
+
+void PointsToSolver::RankCopyGraph() noexcept {
+  constexpr uint32_t Unvisited = UINT32_MAX;
+  using EdgeIterator = decltype(std::declval<const Pointer &>().assigned_element_ptr().begin());
+  struct Frame {
+    const Pointer *pointer;
+    EdgeIterator edge;
+  };
+
+  // Tarjan's algorithm over the reversed copy graph, which emits the components in topological order of the copy graph.
+  auto numNodes = _valueTree->GetNumNodes();
+  _schedule.ranks.assign(numNodes, 0);
+  std::vector<uint32_t> indices(numNodes, Unvisited);
+  std::vector<uint32_t> lowLinks(numNodes, 0);
+  std::vector<bool> onStack(numNodes, false);
+  std::vector<uint32_t> stack;
+  std::vector<Frame> frames;
+  uint32_t nextIndex = 0;
+  uint32_t nextRank = 0;
+
+  auto push = [&](const Pointer *pointer) noexcept {
+    auto id = pointer->node()->id();
+    indices[id] = lowLinks[id] = nextIndex++;
+    stack.push_back(id);
+    onStack[id] = true;
+    frames.push_back(Frame { pointer, pointer->assigned_element_ptr().begin() });
+  };
+
+  for (size_t root = 0; root < numNodes; ++root) {
+    auto node = _valueTree->GetNode(root);
+    if (!node || !node->isPointer() || indices[root] != Unvisited) {
       continue;
     }
+
+    push(node->pointer());
+    while (!frames.empty()) {
+      auto &frame = frames.back();
+      auto id = frame.pointer->node()->id();
+      if (frame.edge != frame.pointer->assigned_element_ptr().end()) {
+        auto rhsId = frame.edge->pointer()->node()->id();
+        auto rhs = frame.edge->pointer();
+        ++frame.edge;
+        if (indices[rhsId] == Unvisited) {
+          push(rhs);
+        } else if (onStack[rhsId]) {
+          lowLinks[id] = std::min(lowLinks[id], indices[rhsId]);
+        }
+        continue;
+      }
+
+      frames.pop_back();
+      if (!frames.empty()) {
+        auto parentId = frames.back().pointer->node()->id();
+        lowLinks[parentId] = std::min(lowLinks[parentId], lowLinks[id]);
+      }
+      if (lowLinks[id] != indices[id]) {
+        continue;
+      }
+      uint32_t member;
+      do {
+        member = stack.back();
+        stack.pop_back();
+        onStack[member] = false;
+        _schedule.ranks[member] = nextRank;
+      } while (member != id);
+      ++nextRank;
+    }
+  }
+  NumCopyGraphComponents += nextRank;
+}
+
+void PointsToSolver::Abandon() noexcept {
+  std::vector<Pointer *> seeds;
+  _valueTree->Visit([&seeds](ValueTreeNode &node) noexcept -> bool {
+    if (node.isPointer()) {
+      seeds.push_back(node.pointer());
+    }
+    return true;
+  });
+  Degrade(seeds);
+  ReportProgress(SolverPhase::Done);
+}
+
+void PointsToSolver::StartBudget() noexcept {
+  _budgetCounter = 0;
+  _iteration = 0;
+  _numRelaxed = 0;
+  _numPointers = 0;
+  _numVisited = 0;
+  _lastTouched.clear();
+  if (_budget.isUnlimited() && !_cancellation) {
+    return;
+  }
+
+  _budgetStart = std::chrono::steady_clock::now();
+  _budgetHeap = static_cast<int64_t>(llvm::sys::Process::GetMallocUsage());
+  _lastTouched.resize(_valueTree->GetNumNodes(), 0);
+}
+
+bool PointsToSolver::ShouldStop() noexcept {
+  if (++_budgetCounter % BudgetCheckInterval != 0) {
+    return false;
+  }
+  if (_budgetCounter % ProgressInterval == 0) {
+    ReportProgress(SolverPhase::Solve);
+  }
+
+  if (_cancellation && _cancellation->isCancelled()) {
+    ++NumCancellations;
+    return true;
+  }
+  if (_budget.isUnlimited()) {
+    return false;
+  }
+
+  if (_budget.time.count() != 0 && std::chrono::steady_clock::now() - _budgetStart > _budget.time) {
+    ++NumBudgetsExceeded;
+    return true;
+  }
+  auto heapGrowth = static_cast<int64_t>(llvm::sys::Process::GetMallocUsage()) - _budgetHeap;
+  if (_budget.memory != 0 && heapGrowth > static_cast<int64_t>(_budget.memory)) {
+    ++NumBudgetsExceeded;
+    return true;
+  }
+  return false;
+}
+
+void PointsToSolver::ReportProgress(SolverPhase phase) const noexcept {
+  if (!_observer) {
+    return;
+  }
+
+  SolverProgress progress;
+  progress.phase = phase;
+  progress.iteration = _iteration;
+  progress.worklistSize = _worklist.size();
+  progress.constraintsProcessed = _numRelaxed;
+  progress.estimatedRemaining = _worklist.size() + (_numPointers > _numVisited ? _numPointers - _numVisited : 0);
+  _observer->OnProgress(progress);
+}
+
+void PointsToSolver::Degrade(const std::vector<Pointer *> &seeds) noexcept {
+  llvm::TimeTraceScope timeScope { "AndersonDegrade" };
+  _valueTree->MarkDegraded();
+
+  DependencyIndex dependencies;
+  dependencies.Build(*_valueTree);
+
+  std::vector<Pointer *> unknownPointers;
+  auto markUnknown = [&unknownPointers](Pointer *pointer) noexcept {
+    if (!pointer->isUnknown()) {
+      pointer->MarkUnknown();
+      ++NumUnknownPointers;
+      unknownPointers.push_back(pointer);
+    }
+  };
+
+  // A store through an unknown pointer may write to any memory object.
+  auto collapsed = false;
+  auto collapseMemory = [this, &collapsed, &markUnknown]() noexcept {
+    if (collapsed) {
+      return;
+    }
+    collapsed = true;
+    for (size_t id = 0; id < _valueTree->GetNumNodes(); ++id) {
+      auto node = _valueTree->GetNode(id);
+      if (!node || !node->isPointer()) {
+        continue;
+      }
+      auto root = node;
+      while (!root->isRoot()) {
+        root = root->parent();
+      }
+      if (root->isStackMemory() || root->isGlobalMemory() || root->isArgumentMemory() || root->isHeapMemory()) {
+        markUnknown(node->pointer());
+      }
+    }
+  };
+
+  for (auto seed : seeds) {
+    markUnknown(seed);
+  }
+  while (!unknownPointers.empty()) {
+    auto pointer = unknownPointers.back();
+    unknownPointers.pop_back();
+
+    for (const auto &e : pointer->pointee_assigned()) {
+      if (e.pointer()->isUnknown() || e.pointer()->GetPointeeSet().size() != 0) {
+        collapseMemory();
+        break;
+      }
+    }
+    // A copy from or into unknown memory may move any pointer to any memory object.
+    if (pointer->GetNumPointeeCopied()) {
+      collapseMemory();
+    }
+
+    dependencies.ForEachUser(pointer, [pointer, &markUnknown, &collapseMemory](Pointer *user) noexcept {
+      for (const auto &e : user->pointee_assigned()) {
+        if (e.pointer() != pointer) {
+          continue;
+        }
+        if (user->isUnknown()) {
+          collapseMemory();
+          continue;
+        }
+        for (auto pointee : user->GetPointeeSet()) {
+          if (auto stored = GetFirstScalarPointer(pointee)) {
+            markUnknown(stored);
+          }
+        }
+      }
+      for (const auto &e : user->pointee_copied()) {
+        if (e.pointer() == pointer) {
+          collapseMemory();
+        }
+      }
+
+      auto assignedFromPointer = std::any_of(
+          user->assigned_element_ptr().begin(), user->assigned_element_ptr().end(),
+          [pointer](const PointerAssignedElementPtr &e) noexcept { return e.pointer() == pointer; });
+      assignedFromPointer = assignedFromPointer || std::any_of(
+          user->assigned_pointee().begin(), user->assigned_pointee().end(),
+          [pointer](const PointerAssignedPointee &e) noexcept { return e.pointer() == pointer; });
+      if (assignedFromPointer) {
+        markUnknown(user);
+      }
+    });
+  }
+}
+
+void PointsToSolver::AddTrivialPointerAssignments() noexcept {
+  assert(_module && "the solver is not bound to any module");
+  llvm::TimeTraceScope timeScope { "AndersonTrivialAssignments" };
+
+  for (const auto &globalVariable : _module->globals()) {
+    AddTrivialPointerAssignments(globalVariable);
+  }
+  for (const auto &function : *_module) {
+    AddTrivialPointerAssignments(function);
+  }
+}
+
+void PointsToSolver::AddTrivialPointerAssignments(const llvm::GlobalVariable &globalVariable) noexcept {
+  // Add points-to constraints from global variables to corresponding global memory values.
+  auto globalVariableNode = _valueTree->GetValueNode(&globalVariable);
+  if (!globalVariableNode) {
+    // The global variable is unreachable from the entry points.
+    return;
+  }
+  auto globalVariableMemoryNode = _valueTree->GetGlobalMemoryNode(&globalVariable);
+  assert(globalVariableNode->isPointer());
+  AddAssignedAddressOf(globalVariableNode->pointer(), globalVariableMemoryNode->pointee());
+}
+
+void PointsToSolver::AddTrivialPointerAssignments(const llvm::Function &function) noexcept {
+  if (!_valueTree->GetValueNode(&function)) {
+    // The function is unreachable from the entry points.
+    return;
+  }
+
+  // Add points-to constraints from exported function arguments to corresponding argument memory values.
+  if (llvm::GlobalValue::isExternalLinkage(function.getLinkage())) {
     for (const auto &arg : function.args()) {
       if (!arg.getType()->isPointerTy()) {
         continue;
@@ -49,26 +762,24 @@ void PointsToSolver::AddTrivialPointerAssignments() const noexcept {
       auto argNode = _valueTree->GetValueNode(&arg);
       auto argMemoryNode = _valueTree->GetArgumentMemoryNode(&arg);
       assert(argNode->isPointer());
-      argNode->pointer()->AssignedAddressOf(argMemoryNode->pointee());
+      AddAssignedAddressOf(argNode->pointer(), argMemoryNode->pointee());
     }
   }
 
   // Add points-to constraints from `alloca` pointers to corresponding stack memory values.
-  for (const auto &function : _module) {
-    for (const auto &bb : function) {
-      for (const auto &inst : bb) {
-        auto allocaInst = llvm::dyn_cast<llvm::AllocaInst>(&inst);
-        if (!allocaInst) {
-          continue;
-        }
+  for (const auto &bb : function) {
+    for (const auto &inst : bb) {
+      auto allocaInst = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+      if (!allocaInst) {
+        continue;
+      }
 
-        auto ptrValue = static_cast<const llvm::Value *>(&inst);
-        auto ptrNode = _valueTree->GetValueNode(ptrValue);
-        auto stackMemoryNode = _valueTree->GetAllocaMemoryNode(allocaInst);
-        assert(ptrNode->isPointer());
+      auto ptrValue = static_cast<const llvm::Value *>(&inst);
+      auto ptrNode = _valueTree->GetValueNode(ptrValue);
+      auto stackMemoryNode = _valueTree->GetAllocaMemoryNode(allocaInst);
+      assert(ptrNode->isPointer());
 
-        ptrNode->pointer()->AssignedAddressOf(stackMemoryNode->pointee());
-      }
+      AddAssignedAddressOf(ptrNode->pointer(), stackMemoryNode->pointee());
     }
   }
 }
@@ -81,7 +792,9 @@ void PointsToSolver::RelaxPointsToConstraints() const noexcept {
 
     auto pointer = node.pointer();
     for (auto &e : pointer->assigned_address_of()) {
-      pointer->GetPointeeSet().insert(e.pointee());
+      if (pointer->GetPointeeSet().insert(e.pointee())) {
+        ++NumAddressOfPointees;
+      }
     }
 
     return true;
@@ -90,6 +803,7 @@ void PointsToSolver::RelaxPointsToConstraints() const noexcept {
   _valueTree->Visit(visitor);
 }
 
+template <typename Instrumentation>
 bool PointsToSolver::RelaxNode(ValueTreeNode &node) noexcept {
   if (!node.isPointer()) {
     return true;
@@ -97,9 +811,18 @@ bool PointsToSolver::RelaxNode(ValueTreeNode &node) noexcept {
 
   auto nodeConverged = true;
   auto pointer = node.pointer();
+  size_t oldSize = 0;
+  if (Instrumentation::Enabled) {
+    if (_profile) {
+      _profile->OnPointerRelaxed(pointer);
+    }
+    oldSize = _lastTouched.empty() ? 0 : pointer->GetPointeeSet().size();
+    _numRelaxed += pointer->GetNumAssignedPointee() + pointer->GetNumAssignedElementPtr() +
+                   pointer->GetNumPointeeAssigned() + pointer->GetNumPointeeCopied();
+  }
 
   for (auto &e : pointer->assigned_pointee()) {
-    if (!RelaxAssignedPointee(pointer, e)) {
+    if (!RelaxAssignedPointee<Instrumentation>(pointer, e)) {
       nodeConverged = false;
     }
   }
@@ -111,21 +834,38 @@ bool PointsToSolver::RelaxNode(ValueTreeNode &node) noexcept {
   }
 
   for (auto &e : pointer->pointee_assigned()) {
-    if (!RelaxPointeeAssigned(pointer, e)) {
+    if (!RelaxPointeeAssigned<Instrumentation>(pointer, e)) {
+      nodeConverged = false;
+    }
+  }
+
+  for (auto &e : pointer->pointee_copied()) {
+    if (!RelaxPointeeCopied<Instrumentation>(pointer, e)) {
       nodeConverged = false;
     }
   }
 
+  if (Instrumentation::Enabled && !_lastTouched.empty() && pointer->GetPointeeSet().size() != oldSize) {
+    Touch(pointer);
+  }
+
   return nodeConverged;
 }
 
+template <typename Instrumentation>
 bool PointsToSolver::RelaxAssignedPointee(Pointer *pointer, const PointerAssignedPointee &edge) noexcept {
+  ++NumAssignedPointeeRelaxed;
   auto converged = true;
 
   auto rhsPointer = edge.pointer();
   for (auto pointee : rhsPointer->GetPointeeSet()) {
-    assert(pointee->isPointer());
-    if (pointer->AssignedPointer(pointee->pointer())) {
+    auto loaded = GetAccessedPointer(pointee, pointer);
+    if (!loaded) {
+      ++NumFilteredPointees;
+      continue;
+    }
+    if (AddAssignedPointer<Instrumentation>(pointer, loaded)) {
+      ++NumLoadAssignments;
       converged = false;
     }
   }
@@ -134,19 +874,60 @@ bool PointsToSolver::RelaxAssignedPointee(Pointer *pointer, const PointerAssigne
 }
 
 bool PointsToSolver::RelaxAssignedElementPtr(Pointer *pointer, const PointerAssignedElementPtr &edge) noexcept {
+  ++NumElementPtrRelaxed;
   auto rhsPointer = edge.pointer();
+  if (edge.isTrivialAssignment()) {
+    auto &pointees = pointer->GetPointeeSet();
+    const auto &rhsPointees = rhsPointer->GetPointeeSet();
+    auto oldSize = pointees.size();
+    ++NumSetUnions;
+    NumBytesMerged += rhsPointees.size() * sizeof(Pointee *);
+
+    auto changed = pointees.MergeFrom(rhsPointees);
+    NumElementPtrPointees += pointees.size() - oldSize;
+    return !changed;
+  }
 
   std::list<ValueTreeNode *> elementNodes;
   for (auto pointee : rhsPointer->GetPointeeSet()) {
     elementNodes.push_back(pointee->node());
   }
 
+  auto firstIndex = true;
   for (const auto &index : edge.index_sequence()) {
+    if (firstIndex) {
+      // The first index steps over the pointee as if it is an element of an array. Only pointees that are array
+      // elements have siblings to step to; other pointees are kept as is.
+      firstIndex = false;
+      if (index.isConstant() && index.index() == 0) {
+        continue;
+      }
+
+      std::list<ValueTreeNode *> nextElementNodes;
+      for (auto node : elementNodes) {
+        auto parent = node->parent();
+        if (!parent || !parent->type()->isArrayTy()) {
+          nextElementNodes.push_back(node);
+        } else if (index.isConstant()) {
+          auto siblingIndex = node->offset() + index.index();
+          if (siblingIndex < parent->GetNumChildren()) {
+            nextElementNodes.push_back(parent->GetChild(siblingIndex));
+          }
+        } else {
+          for (size_t i = 0; i < parent->GetNumChildren(); ++i) {
+            nextElementNodes.push_back(parent->GetChild(i));
+          }
+        }
+      }
+      elementNodes.swap(nextElementNodes);
+      continue;
+    }
+
     if (index.isConstant()) {
       auto indexValue = index.index();
       for (auto it = elementNodes.begin(); it != elementNodes.end(); ) {
         auto &node = *it;
-        if (node->type()->isArrayTy() || node->type()->isStructTy()) {
+        if ((node->type()->isArrayTy() || node->type()->isStructTy()) && indexValue < node->GetNumChildren()) {
           node = node->GetChild(indexValue);
         } else {
           it = elementNodes.erase(it);
@@ -170,10 +951,8 @@ bool PointsToSolver::RelaxAssignedElementPtr(Pointer *pointer, const PointerAssi
 
   auto converged = true;
   for (auto node : elementNodes) {
-    if (!node->isPointer()) {
-      continue;
-    }
-    if (pointer->GetPointeeSet().MergeFrom(node->pointer()->GetPointeeSet())) {
+    if (pointer->GetPointeeSet().insert(node->pointee())) {
+      ++NumElementPtrPointees;
       converged = false;
     }
   }
@@ -181,18 +960,71 @@ bool PointsToSolver::RelaxAssignedElementPtr(Pointer *pointer, const PointerAssi
   return converged;
 }
 
+template <typename Instrumentation>
 bool PointsToSolver::RelaxPointeeAssigned(Pointer *pointer, const PointeeAssignedPointer &edge) noexcept {
-  auto converged = true;
+  ++NumPointeeAssignedRelaxed;
+  size_t numAssignments = 0;
 
   auto rhsPointer = edge.pointer();
   for (auto pointee : pointer->GetPointeeSet()) {
-    assert(pointee->isPointer());
-    if (pointee->pointer()->AssignedPointer(rhsPointer)) {
-      converged = false;
+    auto stored = GetAccessedPointer(pointee, rhsPointer);
+    if (!stored) {
+      ++NumFilteredPointees;
+      continue;
+    }
+    if (AddAssignedPointer<Instrumentation>(stored, rhsPointer)) {
+      ++NumStoreAssignments;
+      ++numAssignments;
+    }
+    if (_dependencies) {
+      _dependencies->AddStoreOrigin(stored, pointer);
     }
   }
 
-  return converged;
+  if (Instrumentation::Enabled && _profile) {
+    _profile->OnStoreRelaxed(pointer, rhsPointer, numAssignments);
+  }
+
+  return numAssignments == 0;
+}
+
+template <typename Instrumentation>
+bool PointsToSolver::RelaxPointeeCopied(Pointer *pointer, const PointeeAssignedPointee &edge) noexcept {
+  ++NumPointeeCopiedRelaxed;
+  size_t numAssignments = 0;
+
+  // The copied memory carries no type that could be checked against the pointers it holds, so copies are not filtered.
+  auto rhsPointer = edge.pointer();
+  for (auto pointee : pointer->GetPointeeSet()) {
+    for (auto source : rhsPointer->GetPointeeSet()) {
+      ForEachCopiedPointer(*pointee->node(), *source->node(),
+                           [this, pointer, &numAssignments](Pointer *copied, Pointer *original) noexcept {
+        if (AddAssignedPointer<Instrumentation>(copied, original)) {
+          ++NumCopyAssignments;
+          ++numAssignments;
+        }
+        if (_dependencies) {
+          _dependencies->AddStoreOrigin(copied, pointer);
+        }
+      });
+    }
+  }
+
+  return numAssignments == 0;
+}
+
+const char* GetSolverPhaseName(SolverPhase phase) noexcept {
+  switch (phase) {
+    case SolverPhase::BuildValueTree:
+      return "value tree";
+    case SolverPhase::GenerateConstraints:
+      return "constraints";
+    case SolverPhase::Solve:
+      return "solve";
+    case SolverPhase::Done:
+      return "done";
+  }
+  llvm_unreachable("unknown solver phase");
 }
 
 } // namespace anderson
@@ -6,23 +6,213 @@
 #define LLVM_ANDERSON_SRC_POINTS_TO_SOLVER_H
 
 #include "llvm-anderson/AndersonPointsToAnalysis.h"
+#include "llvm-anderson/SolverProgress.h"
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+
+#include "DependencyIndex.h"
+#include "SolverProfile.h"
+#include "TypeFilter.h"
 
 namespace llvm {
 
 namespace anderson {
 
+/**
+ * Limits on the resources spent by `PointsToSolver::Solve` and `PointsToSolver::SolveWorklist`. A zero limit means
+ * unlimited.
+ */
+struct SolverBudget {
+  /**
+   * Wall clock time.
+   */
+  std::chrono::milliseconds time { 0 };
+
+  /**
+   * Growth of the heap in bytes.
+   */
+  size_t memory = 0;
+
+  bool isUnlimited() const noexcept {
+    return time.count() == 0 && memory == 0;
+  }
+};
+
+/**
+ * Order in which `PointsToSolver::SolveWorklist` pops the pointers off the worklist.
+ */
+enum class WorklistOrder {
+  /**
+   * Pop the pointer enqueued first.
+   */
+  Fifo,
+
+  /**
+   * Pop the pointer enqueued last.
+   */
+  Lifo,
+
+  /**
+   * Pop the pointer relaxed least recently (least recently fired), using a binary heap.
+   */
+  Lrf,
+
+  /**
+   * Pop the pointer that comes first in the topological order of the copy graph, whose strongly connected components
+   * are collapsed, using a binary heap. The order is computed from the constraints present when solving starts.
+   */
+  Topological,
+
+  /**
+   * Relax the worklist in rounds. Each round relaxes the pointers present when it starts, least recently fired first,
+   * while the pointers enqueued during the round wait in FIFO order for the next round.
+   */
+  TwoPhase,
+};
+
+/**
+ * Algorithm used by `PointsToSolver::Solve(SolverMode)` to solve all constraints of a module.
+ */
+enum class SolverMode {
+  /**
+   * Relax all pointers in rounds until a fixpoint is reached, with `Solve()`.
+   */
+  Exhaustive,
+
+  /**
+   * Seed the worklist with every pointer and relax the pointers whose operands have changed, with `SolveWorklist`.
+   */
+  Worklist,
+
+  /**
+   * Split the constraints into independent regions by unification and solve each with the worklist, with
+   * `SolvePartitioned`.
+   */
+  Partitioned,
+};
+
+/**
+ * Scheduling state of the worklist orders that prioritize pointers.
+ */
+struct WorklistSchedule {
+  /**
+   * The value of `clock` when each pointer was last popped, indexed by node ID. Zero if never popped.
+   */
+  std::vector<uint32_t> lastFired;
+
+  /**
+   * The topological rank of the component of each pointer in the collapsed copy graph, indexed by node ID.
+   */
+  std::vector<uint32_t> ranks;
+
+  /**
+   * Number of pointers popped so far.
+   */
+  uint32_t clock = 0;
+
+  /**
+   * Number of pointers at the front of the worklist that form a binary heap.
+   */
+  size_t heapSize = 0;
+
+  /**
+   * Number of pointers left in the current round.
+   */
+  size_t roundLeft = 0;
+};
+
 class PointsToSolver {
 public:
   explicit PointsToSolver(const llvm::Module &module) noexcept
-    : _module(module),
-      _valueTree(std::make_unique<ValueTree>(module))
+    : _module(&module),
+      _valueTree(std::make_unique<ValueTree>(module)),
+      _dependencies(nullptr),
+      _region(nullptr),
+      _profile(nullptr),
+      _worklist(),
+      _worklistSet(),
+      _worklistOrder(WorklistOrder::Fifo),
+      _schedule(),
+      _typeFilter(),
+      _budget(),
+      _budgetStart(),
+      _budgetHeap(0),
+      _budgetCounter(0),
+      _lastTouched(),
+      _iteration(0),
+      _observer(nullptr),
+      _cancellation(nullptr),
+      _numRelaxed(0),
+      _numPointers(0),
+      _numVisited(0)
   { }
 
+  explicit PointsToSolver(const llvm::Module &module, std::unique_ptr<ValueTree> valueTree) noexcept
+    : _module(&module),
+      _valueTree(std::move(valueTree)),
+      _dependencies(nullptr),
+      _region(nullptr),
+      _profile(nullptr),
+      _worklist(),
+      _worklistSet(),
+      _worklistOrder(WorklistOrder::Fifo),
+      _schedule(),
+      _typeFilter(),
+      _budget(),
+      _budgetStart(),
+      _budgetHeap(0),
+      _budgetCounter(0),
+      _lastTouched(),
+      _iteration(0),
+      _observer(nullptr),
+      _cancellation(nullptr),
+      _numRelaxed(0),
+      _numPointers(0),
+      _numVisited(0)
+  {
+    assert(_valueTree && "valueTree cannot be null");
+  }
+
+  /**
+   * Construct a solver for a value tree that is not bound to any module, e.g. a value tree linked from constraint
+   * summaries. All constraints, including the trivial ones, must already be present in the value tree.
+   */
+  explicit PointsToSolver(std::unique_ptr<ValueTree> valueTree) noexcept
+    : _module(nullptr),
+      _valueTree(std::move(valueTree)),
+      _dependencies(nullptr),
+      _region(nullptr),
+      _profile(nullptr),
+      _worklist(),
+      _worklistSet(),
+      _worklistOrder(WorklistOrder::Fifo),
+      _schedule(),
+      _typeFilter(),
+      _budget(),
+      _budgetStart(),
+      _budgetHeap(0),
+      _budgetCounter(0),
+      _lastTouched(),
+      _iteration(0),
+      _observer(nullptr),
+      _cancellation(nullptr),
+      _numRelaxed(0),
+      _numPointers(0),
+      _numVisited(0)
+  {
+    assert(_valueTree && "valueTree cannot be null");
+  }
+
   ValueTree* GetValueTree() const noexcept {
     return _valueTree.get();
   }
@@ -31,25 +221,398 @@ public:
     return std::move(_valueTree);
   }
 
+  /**
+   * Track the dependencies between pointers in the specified index.
+   *
+   * While a dependency index is attached, every fresh constraint is recorded in the index and the pointer holding the
+   * constraint is pushed onto the worklist consumed by `SolveWorklist`.
+   *
+   * @param dependencies the dependency index, or nullptr to stop tracking dependencies.
+   */
+  void SetDependencyIndex(DependencyIndex *dependencies) noexcept {
+    _dependencies = dependencies;
+  }
+
+  /**
+   * Collect the relaxation counts of pointers and store constraints in the specified profile.
+   *
+   * @param profile the profile, or nullptr to stop profiling.
+   */
+  void SetProfile(SolverProfile *profile) noexcept {
+    _profile = profile;
+  }
+
+  /**
+   * Limit the resources spent by `Solve` and `SolveWorklist`.
+   *
+   * When the budget is exceeded, the solver stops and marks the pointers whose pointee sets may be incomplete as
+   * unknown, together with every pointer depending on them, and records in the value tree that the solution is
+   * degraded. A store through an unknown pointer makes all pointers in memory unknown.
+   *
+   * @param budget the budget.
+   */
+  void SetBudget(const SolverBudget &budget) noexcept {
+    _budget = budget;
+  }
+
+  /**
+   * Set the order in which `SolveWorklist` and `SolvePartitioned` pop the pointers off the worklist. The order only
+   * affects the running time, not the solution.
+   *
+   * @param order the order.
+   */
+  void SetWorklistOrder(WorklistOrder order) noexcept {
+    _worklistOrder = order;
+  }
+
+  /**
+   * Filter the pointees of the pointers that loads and stores go through by their types, as specified by the mode.
+   *
+   * The types of the value tree nodes are precomputed, so the filter should be set after the value tree is complete.
+   *
+   * @param mode the strictness of the filter.
+   */
+  void SetTypeFilter(TypeFilterMode mode) noexcept;
+
+  /**
+   * Report the progress of `Solve` and `SolveWorklist` to the specified observer.
+   *
+   * @param observer the observer, or nullptr to stop reporting.
+   */
+  void SetProgressObserver(SolverProgressObserver *observer) noexcept {
+    _observer = observer;
+  }
+
+  /**
+   * Poll the specified token while solving, and stop as if the budget had been exceeded once it is cancelled.
+   *
+   * @param cancellation the token, or nullptr to stop polling.
+   */
+  void SetCancellationToken(const CancellationToken *cancellation) noexcept {
+    _cancellation = cancellation;
+  }
+
+  /**
+   * Mark every pointer as unknown, e.g. when the generation of the constraints has been cancelled.
+   */
+  void Abandon() noexcept;
+
+  bool AddAssignedAddressOf(Pointer *pointer, Pointee *pointee) noexcept;
+
+  bool AddAssignedPointer(Pointer *pointer, Pointer *rhs) noexcept;
+
+  bool AddAssignedElementPtr(Pointer *pointer, Pointer *rhs, std::vector<PointerIndex> indexSequence) noexcept;
+
+  bool AddAssignedPointee(Pointer *pointer, Pointer *rhs) noexcept;
+
+  bool AddPointeeAssigned(Pointer *pointer, Pointer *rhs) noexcept;
+
+  bool AddPointeeCopied(Pointer *pointer, Pointer *rhs) noexcept;
+
+  /**
+   * Restrict the pointers relaxed by `SolveWorklist` to the specified region.
+   *
+   * Pointers outside of the region are never pushed onto the worklist, so their pointee sets are left untouched.
+   *
+   * @param region the set of pointers to relax, or nullptr to relax all pointers.
+   */
+  void SetRegion(const std::unordered_set<Pointer *> *region) noexcept {
+    _region = region;
+  }
+
+  /**
+   * Add the constraints implied by the definitions of all global variables and functions in the module.
+   */
+  void AddTrivialPointerAssignments() noexcept;
+
+  /**
+   * Add the constraints implied by the definition of the specified global variable.
+   */
+  void AddTrivialPointerAssignments(const llvm::GlobalVariable &globalVariable) noexcept;
+
+  /**
+   * Add the constraints implied by the definition of the specified function and of its `alloca` instructions.
+   */
+  void AddTrivialPointerAssignments(const llvm::Function &function) noexcept;
+
   void Solve() noexcept;
 
-private:
-  static bool RelaxNode(ValueTreeNode &node) noexcept;
+  /**
+   * Push the specified pointer onto the worklist, unless it is outside of the region set by `SetRegion`.
+   */
+  void Enqueue(Pointer *pointer) noexcept {
+    if (_region && _region->find(pointer) == _region->end()) {
+      return;
+    }
+    if (_worklistSet.insert(pointer).second) {
+      _worklist.push_back(pointer);
+    }
+  }
 
-  static bool RelaxAssignedPointee(Pointer *pointer, const PointerAssignedPointee &edge) noexcept;
+  /**
+   * Relax the pointers on the worklist, and the pointers depending on them, until the worklist is empty.
+   *
+   * A dependency index that covers all constraints in the value tree must be attached.
+   */
+  void SolveWorklist() noexcept;
 
-  static bool RelaxAssignedElementPtr(Pointer *pointer, const PointerAssignedElementPtr &edge) noexcept;
+  /**
+   * Partition the constraints into independent regions with a unification-based (Steensgaard) pre-pass, and solve the
+   * regions one by one with the worklist solver.
+   *
+   * If the budget is exceeded, the points-to sets of the region being solved and of the regions left are taken from the
+   * pre-pass instead, which is sound but less precise, and the value tree is marked as approximate. The solved regions
+   * keep their exact solution.
+   */
+  void SolvePartitioned() noexcept;
 
-  static bool RelaxPointeeAssigned(Pointer *pointer, const PointeeAssignedPointer &edge) noexcept;
+  /**
+   * Solve all constraints with the specified algorithm.
+   *
+   * @param mode the algorithm.
+   */
+  void Solve(SolverMode mode) noexcept;
 
-  const llvm::Module &_module;
+private:
+  const llvm::Module *_module;
   std::unique_ptr<ValueTree> _valueTree;
+  DependencyIndex *_dependencies;
+  const std::unordered_set<Pointer *> *_region;
+  SolverProfile *_profile;
+  std::deque<Pointer *> _worklist;
+  std::unordered_set<Pointer *> _worklistSet;
+  WorklistOrder _worklistOrder;
+  WorklistSchedule _schedule;
+  std::unique_ptr<TypeFilter> _typeFilter;
+  SolverBudget _budget;
+  std::chrono::steady_clock::time_point _budgetStart;
+  int64_t _budgetHeap;
+  size_t _budgetCounter;
+  std::vector<uint32_t> _lastTouched;
+  uint32_t _iteration;
+  SolverProgressObserver *_observer;
+  const CancellationToken *_cancellation;
+  uint64_t _numRelaxed;
+  size_t _numPointers;
+  size_t _numVisited;
+
+  void OnConstraintAdded(Pointer *pointer, Pointer *rhs) noexcept;
+
+  void StartBudget() noexcept;
+
+  /**
+   * Determine whether the solver should stop because the budget has been exceeded or the cancellation token has been
+   * cancelled. The checks, and the progress reports, only happen at bounded intervals.
+   */
+  bool ShouldStop() noexcept;
+
+  /**
+   * Determine whether any instrumentation (profile, progress observer, cancellation token or budget) is attached.
+   */
+  bool isInstrumented() const noexcept {
+    return _profile || _observer || _cancellation || !_budget.isUnlimited();
+  }
+
+  /**
+   * Relax every pointer in the order the value tree visits them, sweep after sweep, until a sweep changes nothing.
+   *
+   * `Solve` dispatches once to the specialization for whether any instrumentation is attached, as `RunWorklist` does.
+   *
+   * @return false if the solver stopped early because of `ShouldStop`.
+   */
+  template <typename Instrumentation>
+  bool RunSweeps() noexcept;
+
+  /**
+   * Relax the pointers on the worklist until it is empty.
+   *
+   * Dispatches once to the specialization of the loop for the worklist order and for whether any instrumentation
+   * (profile, progress observer, cancellation token or budget) is attached, so that the loop itself does not test for
+   * them.
+   *
+   * @return false if the solver stopped early because of `ShouldStop`, leaving the worklist non-empty.
+   */
+  bool RunWorklist() noexcept;
+
+  template <typename Order, typename Instrumentation>
+  bool RunWorklist() noexcept;
+
+  /**
+   * Compute the topological ranks of the strongly connected components of the copy graph, whose edges lead from the
+   * right-hand side of each assignment and getelementptr constraint to its left-hand side.
+   */
+  void RankCopyGraph() noexcept;
+
+  template <typename Instrumentation>
+  bool AddAssignedPointer(Pointer *pointer, Pointer *rhs) noexcept;
+
+  void ReportProgress(SolverPhase phase) const noexcept;
+
+  /**
+   * Record that the pointee set or the constraints of the specified pointer changed in the current iteration.
+   */
+  void Touch(const Pointer *pointer) noexcept {
+    if (!_lastTouched.empty()) {
+      _lastTouched[pointer->node()->id()] = _iteration;
+    }
+  }
 
-  void AddTrivialPointerAssignments() const noexcept;
+  /**
+   * Mark the specified pointers, and the pointers whose pointee sets depend on them, as unknown.
+   */
+  void Degrade(const std::vector<Pointer *> &seeds) noexcept;
+
+  template <typename Instrumentation>
+  bool RelaxNode(ValueTreeNode &node) noexcept;
+
+  /**
+   * Get the pointer that a load or a store of the specified pointer reaches through the specified pointee.
+   *
+   * @return the pointer reached, or nullptr if the pointee cannot hold a pointer or the type filter rejects it.
+   */
+  Pointer* GetAccessedPointer(Pointee *pointee, const Pointer *access) const noexcept {
+    if (!_typeFilter) {
+      return GetFirstScalarPointer(pointee);
+    }
+    return _typeFilter->GetAccessedPointer(pointee, access);
+  }
+
+  template <typename Instrumentation>
+  bool RelaxAssignedPointee(Pointer *pointer, const PointerAssignedPointee &edge) noexcept;
+
+  static bool RelaxAssignedElementPtr(Pointer *pointer, const PointerAssignedElementPtr &edge) noexcept;
+
+  template <typename Instrumentation>
+  bool RelaxPointeeAssigned(Pointer *pointer, const PointeeAssignedPointer &edge) noexcept;
+
+  template <typename Instrumentation>
+  bool RelaxPointeeCopied(Pointer *pointer, const PointeeAssignedPointee &edge) noexcept;
 
   void RelaxPointsToConstraints() const noexcept;
 };
 
+/**
+ * Add the constraints generated by the specified instruction to the solver.
+ *
+ * @param solver the solver.
+ * @param inst the instruction.
+ */
+void UpdateAndersonSolverOnInst(PointsToSolver &solver, const llvm::Instruction &inst) noexcept;
+
+/**
+ * Get a human readable name of the specified value tree node, e.g. `stack:f.%a[0][1]`.
+ *
+ * @param node the value tree node. Its root must be associated with a value.
+ * @param slotTracker the slot tracker of the module, used to name unnamed values.
+ * @return the name of the node.
+ */
+std::string GetNodeName(const ValueTreeNode &node, llvm::ModuleSlotTracker &slotTracker) noexcept;
+
+/**
+ * Build the value tree of the specified module, pruned to the functions and global variables reachable from the entry
+ * points requested with `-anderson-entry-points`, if any, and with the requested external summaries.
+ *
+ * @param module the module.
+ * @return the value tree.
+ */
+std::unique_ptr<ValueTree> CreateRequestedValueTree(const llvm::Module &module) noexcept;
+
+/**
+ * Get the entry points requested with `-anderson-entry-points`.
+ *
+ * @return the names of the entry point functions, or an empty list if the whole module is analyzed.
+ */
+std::vector<std::string> GetRequestedEntryPoints() noexcept;
+
+/**
+ * Get the summaries of external functions requested with `-anderson-default-summaries` and
+ * `-anderson-external-summaries`. The summary files are read once for each combination of the options.
+ *
+ * @return the summaries, or nullptr if calls to external functions are not summarized.
+ */
+const ExternalSummaries* GetRequestedExternalSummaries() noexcept;
+
+/**
+ * Build the value tree of the specified module and solve it with the options requested on the command line.
+ *
+ * The solution is loaded from and stored into the cache requested with `-anderson-cache-dir`, checked with
+ * `-anderson-verify`, and a constraint summary and a profile are written if requested. Cancellations and budget
+ * overruns are reported on stderr.
+ *
+ * @param module the module.
+ * @param mode the solver algorithm, usually `GetRequestedSolverMode()`.
+ * @param keepConstraints whether the constraints should be kept in the solved value tree. If this is true, the solution
+ * is never loaded from the on-disk cache since cached solutions carry no constraints.
+ * @param observer the observer receiving the progress of the analysis, or nullptr.
+ * @param cancellation the token polled to cancel the analysis, or nullptr.
+ * @return the solved value tree.
+ */
+std::unique_ptr<ValueTree> SolveRequestedModule(const llvm::Module &module, SolverMode mode, bool keepConstraints,
+                                                SolverProgressObserver *observer,
+                                                const CancellationToken *cancellation) noexcept;
+
+/**
+ * Get a description of the options requested on the command line that change the solution, such as the entry points,
+ * the type filter and the external summaries, so that solutions computed under different options are told apart.
+ *
+ * @return the description.
+ */
+std::string GetRequestedConfiguration() noexcept;
+
+/**
+ * Determine whether a profile or a DOT export of the solver has been requested with `-anderson-profile-out` or
+ * `-anderson-dot-out`.
+ *
+ * @return whether a profile has been requested.
+ */
+bool IsProfileRequested() noexcept;
+
+/**
+ * Get the solver budget requested with `-anderson-time-budget` and `-anderson-memory-budget`.
+ *
+ * @return the requested budget.
+ */
+SolverBudget GetRequestedBudget() noexcept;
+
+/**
+ * Get the worklist order requested with `-anderson-worklist-order`.
+ *
+ * @return the requested worklist order.
+ */
+WorklistOrder GetRequestedWorklistOrder() noexcept;
+
+/**
+ * Determine whether a worklist order has been requested explicitly with `-anderson-worklist-order`.
+ *
+ * @return whether a worklist order has been requested.
+ */
+bool IsWorklistOrderRequested() noexcept;
+
+/**
+ * Get the solver algorithm requested on the command line: the partitioned solver with `-anderson-steensgaard`, the
+ * worklist solver if a worklist order is requested, and the exhaustive solver otherwise.
+ *
+ * @return the requested solver algorithm.
+ */
+SolverMode GetRequestedSolverMode() noexcept;
+
+/**
+ * Get the type filter mode requested with `-anderson-type-filter`.
+ *
+ * @return the requested type filter mode.
+ */
+TypeFilterMode GetRequestedTypeFilter() noexcept;
+
+/**
+ * Write the profile and the DOT export requested on the command line. Errors are reported on stderr.
+ *
+ * @param module the analyzed module.
+ * @param valueTree the solved value tree of the module, with its constraints.
+ * @param profile the counters collected while solving.
+ */
+void WriteRequestedProfile(const llvm::Module &module, const ValueTree &valueTree,
+                           const SolverProfile &profile) noexcept;
+
 } // namespace anderson
 
 } // namespace llvm
@@ -0,0 +1,136 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "Reachability.h"
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/Statistic.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/Support/raw_ostream.h>
+
+#define DEBUG_TYPE "anderson"
+
+STATISTIC(NumPrunedFunctions, "Number of functions pruned as unreachable from the entry points");
+STATISTIC(NumPrunedGlobalVariables, "Number of global variables pruned as unreachable from the entry points");
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+class ReachabilityWalker {
+public:
+  explicit ReachabilityWalker(std::unordered_set<const llvm::GlobalValue *> &reachable) noexcept
+    : _reachable(reachable),
+      _worklist(),
+      _visitedConstants()
+  { }
+
+  void AddRoot(const llvm::GlobalValue *value) noexcept {
+    if (_reachable.insert(value).second) {
+      _worklist.push_back(value);
+    }
+  }
+
+  void Run() noexcept {
+    while (!_worklist.empty()) {
+      auto value = _worklist.back();
+      _worklist.pop_back();
+
+      if (auto function = llvm::dyn_cast<llvm::Function>(value)) {
+        for (const auto &bb : *function) {
+          for (const auto &inst : bb) {
+            for (const auto &operand : inst.operands()) {
+              AddOperand(operand.get());
+            }
+          }
+        }
+      } else if (auto globalVariable = llvm::dyn_cast<llvm::GlobalVariable>(value)) {
+        if (globalVariable->hasInitializer()) {
+          AddOperand(globalVariable->getInitializer());
+        }
+      } else if (auto alias = llvm::dyn_cast<llvm::GlobalAlias>(value)) {
+        AddOperand(alias->getAliasee());
+      } else if (auto ifunc = llvm::dyn_cast<llvm::GlobalIFunc>(value)) {
+        AddOperand(ifunc->getResolver());
+      }
+    }
+  }
+
+private:
+  std::unordered_set<const llvm::GlobalValue *> &_reachable;
+  std::vector<const llvm::GlobalValue *> _worklist;
+  llvm::SmallPtrSet<const llvm::Constant *, 16> _visitedConstants;
+
+  void AddOperand(const llvm::Value *operand) noexcept {
+    if (auto globalValue = llvm::dyn_cast<llvm::GlobalValue>(operand)) {
+      AddRoot(globalValue);
+      return;
+    }
+
+    // Constant expressions and aggregates may refer to global values; they are shared, so each is scanned once.
+    auto constant = llvm::dyn_cast<llvm::Constant>(operand);
+    if (!constant || llvm::isa<llvm::ConstantData>(constant) || !_visitedConstants.insert(constant).second) {
+      return;
+    }
+    std::vector<const llvm::Constant *> stack { constant };
+    while (!stack.empty()) {
+      auto current = stack.back();
+      stack.pop_back();
+      for (const auto &use : current->operands()) {
+        if (auto globalValue = llvm::dyn_cast<llvm::GlobalValue>(use.get())) {
+          AddRoot(globalValue);
+        } else if (auto child = llvm::dyn_cast<llvm::Constant>(use.get())) {
+          if (!llvm::isa<llvm::ConstantData>(child) && _visitedConstants.insert(child).second) {
+            stack.push_back(child);
+          }
+        }
+      }
+    }
+  }
+};
+
+} // namespace <anonymous>
+
+std::unordered_set<const llvm::GlobalValue *> ComputeReachableGlobals(const llvm::Module &module,
+                                                                      const std::vector<std::string> &entryPoints)
+                                                                      noexcept {
+  std::unordered_set<const llvm::GlobalValue *> reachable;
+  ReachabilityWalker walker { reachable };
+
+  for (const auto &name : entryPoints) {
+    auto function = module.getFunction(name);
+    if (!function) {
+      llvm::errs() << "anderson: entry point " << name << " is not a function of module " << module.getName() << "\n";
+      continue;
+    }
+    walker.AddRoot(function);
+  }
+  for (auto name : { "llvm.global_ctors", "llvm.global_dtors" }) {
+    if (auto globalVariable = module.getNamedGlobal(name)) {
+      walker.AddRoot(globalVariable);
+    }
+  }
+  walker.Run();
+
+  for (const auto &function : module) {
+    if (!reachable.count(&function)) {
+      ++NumPrunedFunctions;
+    }
+  }
+  for (const auto &globalVariable : module.globals()) {
+    if (!reachable.count(&globalVariable)) {
+      ++NumPrunedGlobalVariables;
+    }
+  }
+  return reachable;
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,39 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_REACHABILITY_H
+#define LLVM_ANDERSON_SRC_REACHABILITY_H
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <llvm/IR/GlobalValue.h>
+#include <llvm/IR/Module.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Compute the global variables and functions reachable from the specified entry points.
+ *
+ * A function reaches every global value referenced by its instructions, including the functions whose addresses it
+ * takes, and a global variable reaches every global value referenced by its initializer. The functions run by
+ * `llvm.global_ctors` and `llvm.global_dtors` are entry points as well. Entry points not defined in the module are
+ * reported on stderr.
+ *
+ * @param module the module.
+ * @param entryPoints the names of the entry point functions.
+ * @return the reachable global variables and functions.
+ */
+std::unordered_set<const llvm::GlobalValue *> ComputeReachableGlobals(const llvm::Module &module,
+                                                                      const std::vector<std::string> &entryPoints)
+                                                                      noexcept;
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_REACHABILITY_H
@@ -0,0 +1,306 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "SolutionCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/EndianStream.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+constexpr const char CacheEntryMagic[8] = { 'L', 'L', 'V', 'M', 'A', 'P', 'T', 'S' };
+
+/**
+ * Version of the cache entry format. Bump this whenever the format or the semantics of the solution changes so that
+ * stale entries are never loaded.
+ */
+constexpr const uint32_t CacheEntryVersion = 2;
+
+constexpr const size_t CacheEntryHeaderSize = sizeof(CacheEntryMagic) + 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+/**
+ * A raw_ostream that feeds everything written to it into a MD5 hash, except for the leading lines of a printed module
+ * that name the module identifier and the source file.
+ */
+class HashingOStream : public llvm::raw_ostream {
+public:
+  explicit HashingOStream(llvm::MD5 &hash) noexcept
+    : _hash(hash),
+      _pos(0),
+      _inHeader(true),
+      _line()
+  { }
+
+  ~HashingOStream() noexcept override {
+    flush();
+    if (_inHeader) {
+      _hash.update(_line);
+    }
+  }
+
+private:
+  llvm::MD5 &_hash;
+  uint64_t _pos;
+  bool _inHeader;
+  std::string _line;
+
+  void write_impl(const char *ptr, size_t size) override {
+    _pos += size;
+    llvm::StringRef data { ptr, size };
+    while (_inHeader && !data.empty()) {
+      auto newline = data.find('\n');
+      if (newline == llvm::StringRef::npos) {
+        _line.append(data.begin(), data.end());
+        return;
+      }
+      _line.append(data.begin(), data.begin() + newline + 1);
+      data = data.drop_front(newline + 1);
+
+      llvm::StringRef line { _line };
+      if (!line.startswith("; ModuleID = ") && !line.startswith("source_filename = ")) {
+        _hash.update(line);
+        _inHeader = false;
+      }
+      _line.clear();
+    }
+    _hash.update(data);
+  }
+
+  uint64_t current_pos() const override {
+    return _pos;
+  }
+};
+
+/**
+ * Layout of a cache entry, as a view over the mapped file.
+ *
+ * A cache entry consists of a header followed by three arrays:
+ * - the IDs of all pointer nodes in ascending order (`uint32_t[numPointers]`);
+ * - the offsets of the pointee lists of each pointer (`uint64_t[numPointers + 1]`);
+ * - the concatenated pointee lists, as pointee node IDs (`uint32_t[numEntries]`).
+ *
+ * All integers are little endian and not necessarily aligned.
+ */
+struct CacheEntryLayout {
+  uint64_t numNodes;
+  uint64_t numPointers;
+  uint64_t numEntries;
+  const char *pointerIds;
+  const char *offsets;
+  const char *entries;
+
+  bool Parse(llvm::StringRef data) noexcept {
+    if (data.size() < CacheEntryHeaderSize) {
+      return false;
+    }
+    if (!std::equal(std::begin(CacheEntryMagic), std::end(CacheEntryMagic), data.begin())) {
+      return false;
+    }
+
+    auto p = data.data() + sizeof(CacheEntryMagic);
+    if (ReadUInt32(p) != CacheEntryVersion) {
+      return false;
+    }
+    p += 2 * sizeof(uint32_t);
+
+    numNodes = ReadUInt64(p);
+    numPointers = ReadUInt64(p + sizeof(uint64_t));
+    numEntries = ReadUInt64(p + 2 * sizeof(uint64_t));
+
+    auto expectedSize = CacheEntryHeaderSize + numPointers * sizeof(uint32_t) +
+        (numPointers + 1) * sizeof(uint64_t) + numEntries * sizeof(uint32_t);
+    if (data.size() != expectedSize) {
+      return false;
+    }
+
+    pointerIds = data.data() + CacheEntryHeaderSize;
+    offsets = pointerIds + numPointers * sizeof(uint32_t);
+    entries = offsets + (numPointers + 1) * sizeof(uint64_t);
+    return GetOffset(numPointers) == numEntries;
+  }
+
+  uint32_t GetPointerId(uint64_t index) const noexcept {
+    return ReadUInt32(pointerIds + index * sizeof(uint32_t));
+  }
+
+  uint64_t GetOffset(uint64_t index) const noexcept {
+    return ReadUInt64(offsets + index * sizeof(uint64_t));
+  }
+
+  uint32_t GetEntry(uint64_t index) const noexcept {
+    return ReadUInt32(entries + index * sizeof(uint32_t));
+  }
+
+  static uint32_t ReadUInt32(const char *p) noexcept {
+    return llvm::support::endian::read<uint32_t, llvm::support::little, llvm::support::unaligned>(p);
+  }
+
+  static uint64_t ReadUInt64(const char *p) noexcept {
+    return llvm::support::endian::read<uint64_t, llvm::support::little, llvm::support::unaligned>(p);
+  }
+};
+
+} // namespace <anonymous>
+
+std::string SolutionCache::ComputeKey(const llvm::Module &module, llvm::StringRef configuration) noexcept {
+  llvm::MD5 hash;
+  hash.update(llvm::StringRef { CacheEntryMagic, sizeof(CacheEntryMagic) });
+  hash.update(std::to_string(CacheEntryVersion));
+  hash.update(configuration);
+
+  {
+    // Print the module in one go, so the slot numbers and the named types are collected only once. The printed module
+    // includes the bodies of the identified struct types, the data layout and the target triple.
+    HashingOStream os { hash };
+    module.print(os, nullptr);
+  }
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  return std::string { result.digest().str() };
+}
+
+std::string SolutionCache::GetEntryPath(const std::string &key) const noexcept {
+  llvm::SmallString<128> path { _directory };
+  // pruneCache only considers files whose names start with "llvmcache-".
+  llvm::sys::path::append(path, "llvmcache-anderson-" + key);
+  return std::string { path.str() };
+}
+
+bool SolutionCache::Load(const std::string &key, ValueTree &valueTree) const noexcept {
+  auto path = GetEntryPath(key);
+
+  int fd;
+  if (llvm::sys::fs::openFileForRead(path, fd)) {
+    return false;
+  }
+
+  // Refresh the access time of the entry so that the pruner evicts the least recently used entries first.
+  llvm::sys::fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now());
+
+  auto buffer = llvm::MemoryBuffer::getOpenFile(fd, path, -1, false);
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  if (!buffer) {
+    return false;
+  }
+
+  CacheEntryLayout layout { };
+  if (!layout.Parse((*buffer)->getBuffer())) {
+    return false;
+  }
+  if (layout.numNodes != valueTree.GetNumNodes() || layout.numPointers != valueTree.GetNumPointers()) {
+    return false;
+  }
+
+  // Check every pointer ID before touching the value tree, so that a malformed entry leaves it unchanged.
+  for (uint64_t i = 0; i < layout.numPointers; ++i) {
+    auto id = layout.GetPointerId(i);
+    if (id >= layout.numNodes || !valueTree.GetNode(id) || !valueTree.GetNode(id)->isPointer() ||
+        layout.GetOffset(i) > layout.GetOffset(i + 1)) {
+      return false;
+    }
+  }
+
+  // Decode all pointee sets eagerly, so that the loaded value tree is safe to read from several threads like a solved
+  // one.
+  for (uint64_t i = 0; i < layout.numPointers; ++i) {
+    auto &pointees = valueTree.GetNode(layout.GetPointerId(i))->pointer()->GetPointeeSet();
+    auto end = layout.GetOffset(i + 1);
+    for (auto j = layout.GetOffset(i); j < end; ++j) {
+      auto pointeeId = layout.GetEntry(j);
+      if (pointeeId < valueTree.GetNumNodes() && valueTree.GetNode(pointeeId)) {
+        pointees.insert(valueTree.GetNode(pointeeId)->pointee());
+      }
+    }
+  }
+  return true;
+}
+
+void SolutionCache::Store(const std::string &key, const ValueTree &valueTree) const noexcept {
+  if (valueTree.isDegraded() || valueTree.isApproximate()) {
+    // A later analysis of the same module may run with a larger budget.
+    return;
+  }
+  if (llvm::sys::fs::create_directories(_directory)) {
+    return;
+  }
+
+  std::vector<uint32_t> pointerIds;
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> entries;
+  pointerIds.reserve(valueTree.GetNumPointers());
+  offsets.reserve(valueTree.GetNumPointers() + 1);
+
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+
+    pointerIds.push_back(static_cast<uint32_t>(id));
+    offsets.push_back(entries.size());
+
+    auto begin = entries.size();
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      entries.push_back(static_cast<uint32_t>(pointee->node()->id()));
+    }
+    std::sort(entries.begin() + begin, entries.end());
+  }
+  offsets.push_back(entries.size());
+
+  llvm::SmallString<128> tempPath;
+  int fd;
+  llvm::SmallString<128> tempModel { _directory };
+  llvm::sys::path::append(tempModel, "anderson-%%%%%%%%.tmp");
+  if (llvm::sys::fs::createUniqueFile(tempModel, fd, tempPath)) {
+    return;
+  }
+
+  {
+    llvm::raw_fd_ostream os { fd, true };
+    llvm::support::endian::Writer writer { os, llvm::support::little };
+    os.write(CacheEntryMagic, sizeof(CacheEntryMagic));
+    writer.write<uint32_t>(CacheEntryVersion);
+    writer.write<uint32_t>(0);
+    writer.write<uint64_t>(valueTree.GetNumNodes());
+    writer.write<uint64_t>(pointerIds.size());
+    writer.write<uint64_t>(entries.size());
+    writer.write<uint32_t>(pointerIds);
+    writer.write<uint64_t>(offsets);
+    writer.write<uint32_t>(entries);
+
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tempPath);
+      return;
+    }
+  }
+
+  if (llvm::sys::fs::rename(tempPath, GetEntryPath(key))) {
+    llvm::sys::fs::remove(tempPath);
+    return;
+  }
+
+  llvm::pruneCache(_directory, _policy);
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,88 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_SOLUTION_CACHE_H
+#define LLVM_ANDERSON_SRC_SOLUTION_CACHE_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <string>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CachePruning.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * An on-disk cache of solved points-to relations, keyed by the content hash of the analyzed module.
+ *
+ * Each cache entry stores the pointee sets of all pointers in the value tree in compressed sparse row form, indexed by
+ * node IDs. On a cache hit the entry is memory mapped and the pointee sets of all pointers are decoded in a single
+ * sequential pass.
+ */
+class SolutionCache {
+public:
+  /**
+   * Construct a new SolutionCache object.
+   *
+   * @param directory path to the cache directory.
+   * @param policy the pruning policy of the cache directory.
+   */
+  explicit SolutionCache(std::string directory, llvm::CachePruningPolicy policy) noexcept
+    : _directory(std::move(directory)),
+      _policy(policy)
+  { }
+
+  /**
+   * Compute the cache key of the specified module.
+   *
+   * The key is a hash of the textual IR of the module, which includes the data layout, the target triple and the bodies
+   * of the identified struct types. The module is printed once, so the cost of the key is linear in the size of the
+   * module. The lines naming the module identifier and the source file are not hashed, so the key does not change with
+   * them.
+   *
+   * @param module the module.
+   * @param configuration the options that change the solution, as given by `GetRequestedConfiguration`.
+   * @return the cache key of the module.
+   */
+  static std::string ComputeKey(const llvm::Module &module, llvm::StringRef configuration) noexcept;
+
+  /**
+   * Load the solution stored under the specified key into the specified value tree.
+   *
+   * The value tree must be built from the module whose key is given. On success, the pointee sets of the value tree
+   * are populated from the cache entry before this function returns, so the value tree can then be read like a solved
+   * one. On failure, the value tree is left unchanged.
+   *
+   * @param key the cache key.
+   * @param valueTree the value tree.
+   * @return whether the cache entry exists and has been loaded into the value tree.
+   */
+  bool Load(const std::string &key, ValueTree &valueTree) const noexcept;
+
+  /**
+   * Store the solution contained in the specified value tree under the specified key, and then prune the cache
+   * directory according to the pruning policy. Degraded and approximate solutions are not stored.
+   *
+   * Failures to write the cache entry are silently ignored.
+   *
+   * @param key the cache key.
+   * @param valueTree the solved value tree.
+   */
+  void Store(const std::string &key, const ValueTree &valueTree) const noexcept;
+
+private:
+  std::string _directory;
+  llvm::CachePruningPolicy _policy;
+
+  std::string GetEntryPath(const std::string &key) const noexcept;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_SOLUTION_CACHE_H
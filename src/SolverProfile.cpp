@@ -0,0 +1,410 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "SolverProfile.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/Support/GraphWriter.h>
+#include <llvm/Support/JSON.h>
+
+#include "PointsToSolver.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+/**
+ * Flat view of the pointers of a value tree and of the constraints between them.
+ */
+class ConstraintGraph {
+public:
+  explicit ConstraintGraph(const ValueTree &valueTree) noexcept
+    : _pointers(),
+      _ids(),
+      _copySuccessors(),
+      _inDegrees(),
+      _outDegrees()
+  {
+    for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+      auto node = valueTree.GetNode(id);
+      if (node && node->isPointer()) {
+        _ids[node->pointer()] = static_cast<unsigned>(_pointers.size());
+        _pointers.push_back(node->pointer());
+      }
+    }
+
+    _copySuccessors.resize(_pointers.size());
+    _inDegrees.resize(_pointers.size());
+    _outDegrees.resize(_pointers.size());
+    for (unsigned id = 0; id < _pointers.size(); ++id) {
+      auto pointer = _pointers[id];
+      _inDegrees[id] = pointer->GetNumAssignedAddressOf() + pointer->GetNumAssignedElementPtr() +
+                       pointer->GetNumAssignedPointee() + pointer->GetNumPointeeAssigned() +
+                       pointer->GetNumPointeeCopied();
+      for (const auto &e : pointer->assigned_element_ptr()) {
+        if (e.isTrivialAssignment()) {
+          _copySuccessors[GetId(e.pointer())].push_back(id);
+        }
+        ++_outDegrees[GetId(e.pointer())];
+      }
+      for (const auto &e : pointer->assigned_pointee()) {
+        ++_outDegrees[GetId(e.pointer())];
+      }
+      for (const auto &e : pointer->pointee_assigned()) {
+        ++_outDegrees[GetId(e.pointer())];
+      }
+      for (const auto &e : pointer->pointee_copied()) {
+        ++_outDegrees[GetId(e.pointer())];
+      }
+    }
+  }
+
+  size_t GetNumPointers() const noexcept {
+    return _pointers.size();
+  }
+
+  const Pointer* GetPointer(unsigned id) const noexcept {
+    return _pointers[id];
+  }
+
+  unsigned GetId(const Pointer *pointer) const noexcept {
+    auto it = _ids.find(pointer);
+    assert(it != _ids.end() && "pointer is not in the value tree");
+    return it->second;
+  }
+
+  size_t GetInDegree(unsigned id) const noexcept {
+    return _inDegrees[id];
+  }
+
+  size_t GetOutDegree(unsigned id) const noexcept {
+    return _outDegrees[id];
+  }
+
+  /**
+   * Get the strongly connected components of the copy constraints that contain more than one pointer.
+   */
+  std::vector<std::vector<unsigned>> GetCopySCCs() const noexcept;
+
+private:
+  std::vector<const Pointer *> _pointers;
+  llvm::DenseMap<const Pointer *, unsigned> _ids;
+  std::vector<std::vector<unsigned>> _copySuccessors;
+  std::vector<size_t> _inDegrees;
+  std::vector<size_t> _outDegrees;
+};
+
+std::vector<std::vector<unsigned>> ConstraintGraph::GetCopySCCs() const noexcept {
+  struct Frame {
+    unsigned pointer;
+    size_t nextSuccessor;
+  };
+
+  constexpr unsigned Unvisited = UINT32_MAX;
+  std::vector<unsigned> indices(_pointers.size(), Unvisited);
+  std::vector<unsigned> lowLinks(_pointers.size(), 0);
+  std::vector<bool> onStack(_pointers.size(), false);
+  std::vector<unsigned> stack;
+  std::vector<std::vector<unsigned>> sccs;
+  unsigned nextIndex = 0;
+
+  // Iterative version of Tarjan's algorithm, so that long copy chains do not overflow the native stack.
+  for (unsigned root = 0; root < _pointers.size(); ++root) {
+    if (indices[root] != Unvisited) {
+      continue;
+    }
+
+    std::vector<Frame> frames;
+    auto push = [&](unsigned pointer) noexcept {
+      indices[pointer] = nextIndex;
+      lowLinks[pointer] = nextIndex;
+      ++nextIndex;
+      onStack[pointer] = true;
+      stack.push_back(pointer);
+      frames.push_back(Frame { pointer, 0 });
+    };
+    push(root);
+
+    while (!frames.empty()) {
+      auto &frame = frames.back();
+      const auto &successors = _copySuccessors[frame.pointer];
+      if (frame.nextSuccessor < successors.size()) {
+        auto successor = successors[frame.nextSuccessor++];
+        if (indices[successor] == Unvisited) {
+          push(successor);
+        } else if (onStack[successor]) {
+          lowLinks[frame.pointer] = std::min(lowLinks[frame.pointer], indices[successor]);
+        }
+        continue;
+      }
+
+      auto pointer = frame.pointer;
+      frames.pop_back();
+      if (!frames.empty()) {
+        auto predecessor = frames.back().pointer;
+        lowLinks[predecessor] = std::min(lowLinks[predecessor], lowLinks[pointer]);
+      }
+
+      if (lowLinks[pointer] == indices[pointer]) {
+        std::vector<unsigned> scc;
+        unsigned member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member] = false;
+          scc.push_back(member);
+        } while (member != pointer);
+        if (scc.size() > 1) {
+          sccs.push_back(std::move(scc));
+        }
+      }
+    }
+  }
+
+  return sccs;
+}
+
+/**
+ * Keep the `limit` entries with the highest non-zero keys, ordered by descending key.
+ */
+template <typename T, typename Key>
+void KeepTopEntries(std::vector<T> &entries, size_t limit, Key key) noexcept {
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [&key](const T &entry) noexcept {
+    return key(entry) == 0;
+  }), entries.end());
+  auto middle = entries.begin() + static_cast<std::ptrdiff_t>(std::min(limit, entries.size()));
+  std::partial_sort(entries.begin(), middle, entries.end(), [&key](const T &lhs, const T &rhs) noexcept {
+    return key(lhs) > key(rhs);
+  });
+  entries.erase(middle, entries.end());
+}
+
+} // namespace <anonymous>
+
+void SolverProfile::WriteJSON(llvm::raw_ostream &os, const llvm::Module &module, const ValueTree &valueTree,
+                              size_t limit) const noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+  ConstraintGraph graph { valueTree };
+  auto getName = [&graph, &slotTracker](unsigned id) noexcept {
+    return GetNodeName(*graph.GetPointer(id)->node(), slotTracker);
+  };
+
+  std::vector<unsigned> pointerIds(graph.GetNumPointers());
+  for (unsigned id = 0; id < pointerIds.size(); ++id) {
+    pointerIds[id] = id;
+  }
+  auto writePointerRanking = [&](llvm::json::OStream &json, llvm::StringRef attribute, llvm::StringRef countName,
+                                 auto key) noexcept {
+    auto ranking = pointerIds;
+    KeepTopEntries(ranking, limit, key);
+    json.attributeArray(attribute, [&]() {
+      for (auto id : ranking) {
+        json.object([&]() {
+          json.attribute("pointer", getName(id));
+          json.attribute(countName, static_cast<int64_t>(key(id)));
+        });
+      }
+    });
+  };
+
+  size_t numAddressOf = 0;
+  size_t numElementPtr = 0;
+  size_t numLoads = 0;
+  size_t numStores = 0;
+  size_t numCopies = 0;
+  size_t numPointsToFacts = 0;
+  uint64_t numRelaxations = 0;
+  for (unsigned id = 0; id < graph.GetNumPointers(); ++id) {
+    auto pointer = graph.GetPointer(id);
+    numAddressOf += pointer->GetNumAssignedAddressOf();
+    numElementPtr += pointer->GetNumAssignedElementPtr();
+    numLoads += pointer->GetNumAssignedPointee();
+    numStores += pointer->GetNumPointeeAssigned();
+    numCopies += pointer->GetNumPointeeCopied();
+    numPointsToFacts += pointer->GetPointeeSet().size();
+    numRelaxations += GetNumRelaxations(pointer);
+  }
+
+  auto sccs = graph.GetCopySCCs();
+  size_t numPointersInSCCs = 0;
+  for (const auto &scc : sccs) {
+    numPointersInSCCs += scc.size();
+  }
+  KeepTopEntries(sccs, limit, [](const std::vector<unsigned> &scc) noexcept {
+    return scc.size();
+  });
+
+  std::vector<std::pair<std::pair<const Pointer *, const Pointer *>, StoreCounters>> stores {
+    _stores.begin(), _stores.end()
+  };
+  KeepTopEntries(stores, limit, [](const decltype(stores)::value_type &store) noexcept {
+    return store.second.assignments;
+  });
+
+  llvm::json::OStream json { os, 2 };
+  json.object([&]() {
+    json.attribute("module", module.getName());
+    json.attribute("pointers", static_cast<int64_t>(graph.GetNumPointers()));
+    json.attribute("pointees", static_cast<int64_t>(valueTree.GetNumPointees()));
+    json.attributeObject("constraints", [&]() {
+      json.attribute("addressOf", static_cast<int64_t>(numAddressOf));
+      json.attribute("assign", static_cast<int64_t>(numElementPtr));
+      json.attribute("load", static_cast<int64_t>(numLoads));
+      json.attribute("store", static_cast<int64_t>(numStores));
+      json.attribute("copy", static_cast<int64_t>(numCopies));
+    });
+    json.attribute("pointsToFacts", static_cast<int64_t>(numPointsToFacts));
+    json.attribute("relaxations", static_cast<int64_t>(numRelaxations));
+    json.attribute("copySCCs", static_cast<int64_t>(sccs.size()));
+    json.attribute("pointersInCopySCCs", static_cast<int64_t>(numPointersInSCCs));
+
+    json.attributeArray("largestCopySCCs", [&]() {
+      for (const auto &scc : sccs) {
+        json.object([&]() {
+          json.attribute("size", static_cast<int64_t>(scc.size()));
+          json.attributeArray("members", [&]() {
+            for (size_t i = 0; i < std::min(limit, scc.size()); ++i) {
+              json.value(getName(scc[i]));
+            }
+          });
+        });
+      }
+    });
+
+    writePointerRanking(json, "highestInDegree", "degree", [&graph](unsigned id) noexcept {
+      return graph.GetInDegree(id);
+    });
+    writePointerRanking(json, "highestOutDegree", "degree", [&graph](unsigned id) noexcept {
+      return graph.GetOutDegree(id);
+    });
+    writePointerRanking(json, "largestPointsToSets", "size", [&graph](unsigned id) noexcept {
+      return graph.GetPointer(id)->GetPointeeSet().size();
+    });
+
+    json.attributeArray("hottestStores", [&]() {
+      for (const auto &store : stores) {
+        json.object([&]() {
+          json.attribute("pointer", getName(graph.GetId(store.first.first)));
+          json.attribute("value", getName(graph.GetId(store.first.second)));
+          json.attribute("fired", static_cast<int64_t>(store.second.fired));
+          json.attribute("assignments", static_cast<int64_t>(store.second.assignments));
+        });
+      }
+    });
+
+    writePointerRanking(json, "mostRelaxed", "relaxations", [this, &graph](unsigned id) noexcept {
+      return GetNumRelaxations(graph.GetPointer(id));
+    });
+  });
+  os << "\n";
+}
+
+bool WriteConstraintGraphDOT(llvm::raw_ostream &os, const llvm::Module &module, const ValueTree &valueTree,
+                             llvm::StringRef centerName, size_t depth) noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+  ConstraintGraph graph { valueTree };
+
+  std::vector<std::string> names(graph.GetNumPointers());
+  unsigned center = UINT32_MAX;
+  for (unsigned id = 0; id < graph.GetNumPointers(); ++id) {
+    names[id] = GetNodeName(*graph.GetPointer(id)->node(), slotTracker);
+    if (names[id] == centerName) {
+      center = id;
+    }
+  }
+  if (center == UINT32_MAX) {
+    return false;
+  }
+
+  // Constraints connect a pointer with its operands, and are followed in both directions.
+  std::vector<std::vector<unsigned>> neighbors(graph.GetNumPointers());
+  for (unsigned id = 0; id < graph.GetNumPointers(); ++id) {
+    DependencyIndex::ForEachOperand(const_cast<Pointer *>(graph.GetPointer(id)), [&](Pointer *operand) noexcept {
+      auto operandId = graph.GetId(operand);
+      neighbors[id].push_back(operandId);
+      neighbors[operandId].push_back(id);
+    });
+  }
+
+  llvm::DenseMap<unsigned, size_t> distances;
+  std::deque<unsigned> queue { center };
+  distances[center] = 0;
+  while (!queue.empty()) {
+    auto id = queue.front();
+    queue.pop_front();
+    if (distances[id] == depth) {
+      continue;
+    }
+    for (auto neighbor : neighbors[id]) {
+      if (distances.insert(std::make_pair(neighbor, distances[id] + 1)).second) {
+        queue.push_back(neighbor);
+      }
+    }
+  }
+
+  std::vector<unsigned> included;
+  for (const auto &entry : distances) {
+    included.push_back(entry.first);
+  }
+  std::sort(included.begin(), included.end());
+
+  // Edges point in the direction in which pointees flow.
+  os << "digraph \"anderson\" {\n";
+  llvm::DenseSet<const Pointee *> addressOfPointees;
+  for (auto id : included) {
+    auto pointer = graph.GetPointer(id);
+    os << "  p" << id << " [label=\"" << llvm::DOT::EscapeString(names[id]) << "\\n|pts| = "
+       << pointer->GetPointeeSet().size() << "\"" << (id == center ? ", style=bold" : "") << "];\n";
+
+    for (const auto &e : pointer->assigned_address_of()) {
+      auto pointee = e.pointee();
+      if (addressOfPointees.insert(pointee).second) {
+        os << "  o" << pointee->node()->id() << " [shape=box, label=\""
+           << llvm::DOT::EscapeString(GetNodeName(*pointee->node(), slotTracker)) << "\"];\n";
+      }
+      os << "  o" << pointee->node()->id() << " -> p" << id << " [label=\"addr\", color=gray];\n";
+    }
+
+    for (const auto &e : pointer->assigned_element_ptr()) {
+      auto operandId = graph.GetId(e.pointer());
+      if (distances.count(operandId)) {
+        os << "  p" << operandId << " -> p" << id << " [label=\"" << (e.isTrivialAssignment() ? "copy" : "gep")
+           << "\"];\n";
+      }
+    }
+    for (const auto &e : pointer->assigned_pointee()) {
+      auto operandId = graph.GetId(e.pointer());
+      if (distances.count(operandId)) {
+        os << "  p" << operandId << " -> p" << id << " [label=\"load\", style=dashed];\n";
+      }
+    }
+    for (const auto &e : pointer->pointee_assigned()) {
+      auto operandId = graph.GetId(e.pointer());
+      if (distances.count(operandId)) {
+        os << "  p" << operandId << " -> p" << id << " [label=\"store\", style=dotted];\n";
+      }
+    }
+    for (const auto &e : pointer->pointee_copied()) {
+      auto operandId = graph.GetId(e.pointer());
+      if (distances.count(operandId)) {
+        os << "  p" << operandId << " -> p" << id << " [label=\"memcpy\", style=dotted];\n";
+      }
+    }
+  }
+  os << "}\n";
+
+  return true;
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,119 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_SOLVER_PROFILE_H
+#define LLVM_ANDERSON_SRC_SOLVER_PROFILE_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstdint>
+#include <utility>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Counters collected by `PointsToSolver` while solving, and dumps of the shape of the solved constraint graph.
+ */
+class SolverProfile {
+public:
+  /**
+   * Counters of a single store constraint `*p = q`.
+   */
+  struct StoreCounters {
+    /**
+     * Number of relaxations of the constraint that added at least one assignment.
+     */
+    uint64_t fired = 0;
+
+    /**
+     * Number of assignments `o = q` added by relaxing the constraint.
+     */
+    uint64_t assignments = 0;
+  };
+
+  /**
+   * Record that the constraints of the specified pointer have been relaxed.
+   *
+   * @param pointer the pointer.
+   */
+  void OnPointerRelaxed(const Pointer *pointer) noexcept {
+    ++_relaxations[pointer];
+  }
+
+  /**
+   * Record that relaxing the store constraint `*pointer = rhs` added the specified number of assignments.
+   *
+   * @param pointer the pointer stored through.
+   * @param rhs the stored pointer.
+   * @param numAssignments the number of assignments added.
+   */
+  void OnStoreRelaxed(const Pointer *pointer, const Pointer *rhs, size_t numAssignments) noexcept {
+    if (numAssignments == 0) {
+      return;
+    }
+    auto &counters = _stores[std::make_pair(pointer, rhs)];
+    ++counters.fired;
+    counters.assignments += numAssignments;
+  }
+
+  /**
+   * Get the number of times the constraints of the specified pointer have been relaxed.
+   *
+   * @param pointer the pointer.
+   * @return the number of relaxations.
+   */
+  uint64_t GetNumRelaxations(const Pointer *pointer) const noexcept {
+    auto it = _relaxations.find(pointer);
+    return it == _relaxations.end() ? 0 : it->second;
+  }
+
+  /**
+   * Write the profile of the solved constraint graph as a JSON object.
+   *
+   * The object holds the sizes of the graph and, for each of the following rankings, the `limit` highest ranked
+   * entries: the largest strongly connected components of copy constraints, the pointers holding the most constraints
+   * (in-degree), the pointers used as an operand by the most constraints (out-degree), the largest points-to sets, the
+   * store constraints that added the most assignments, and the pointers relaxed most often.
+   *
+   * @param os the output stream.
+   * @param module the analyzed module.
+   * @param valueTree the solved value tree of the module.
+   * @param limit the maximal number of entries of each ranking.
+   */
+  void WriteJSON(llvm::raw_ostream &os, const llvm::Module &module, const ValueTree &valueTree,
+                 size_t limit) const noexcept;
+
+private:
+  llvm::DenseMap<const Pointer *, uint64_t> _relaxations;
+  llvm::DenseMap<std::pair<const Pointer *, const Pointer *>, StoreCounters> _stores;
+};
+
+/**
+ * Write the constraint graph around the specified pointer in GraphViz DOT format.
+ *
+ * The subgraph contains the pointers reachable from the center within `depth` constraints in either direction, the
+ * constraints between them, and the pointees of their address-of constraints.
+ *
+ * @param os the output stream.
+ * @param module the analyzed module.
+ * @param valueTree the value tree of the module.
+ * @param centerName the name of the center pointer, as printed by `GetNodeName`, e.g. `f.%p`.
+ * @param depth the maximal distance of a pointer from the center.
+ * @return whether a pointer with the specified name exists.
+ */
+bool WriteConstraintGraphDOT(llvm::raw_ostream &os, const llvm::Module &module, const ValueTree &valueTree,
+                             llvm::StringRef centerName, size_t depth) noexcept;
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_SOLVER_PROFILE_H
@@ -0,0 +1,249 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "SolverVerifier.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+
+#include "PointsToSolver.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+constexpr size_t InvalidId = static_cast<size_t>(-1);
+
+/**
+ * Maximal number of pointees listed in the missing and extra sets of a counterexample.
+ */
+constexpr size_t MaxListedPointees = 8;
+
+struct Mismatch {
+  size_t id;
+  std::vector<size_t> missing;
+  std::vector<size_t> extra;
+};
+
+std::vector<size_t> GetSortedPointees(const Pointer &pointer, const std::vector<size_t> &toReference) noexcept {
+  std::vector<size_t> ids;
+  ids.reserve(pointer.GetPointeeSet().size());
+  for (auto pointee : pointer.GetPointeeSet()) {
+    ids.push_back(toReference[pointee->node()->id()]);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+void PrintPointees(llvm::raw_ostream &os, const char *title, const std::vector<size_t> &ids,
+                   const std::vector<std::string> &names) noexcept {
+  if (ids.empty()) {
+    return;
+  }
+  os << "    " << title << ":";
+  for (size_t i = 0; i < ids.size() && i < MaxListedPointees; ++i) {
+    os << " " << names[ids[i]];
+  }
+  if (ids.size() > MaxListedPointees) {
+    os << " (+" << ids.size() - MaxListedPointees << " more)";
+  }
+  os << "\n";
+}
+
+} // namespace <anonymous>
+
+std::unique_ptr<ValueTree> SolveReference(const llvm::Module &module) noexcept {
+  PointsToSolver solver { module, CreateRequestedValueTree(module) };
+  // The type filter changes the solution, so the reference applies the same filter as the checked solver.
+  solver.SetTypeFilter(GetRequestedTypeFilter());
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+  solver.Solve();
+  return solver.TakeValueTree();
+}
+
+bool VerifySolution(const llvm::Module &module, const ValueTree &candidate, const ValueTree &reference,
+                    llvm::raw_ostream &os) noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+
+  std::vector<std::string> names(reference.GetNumNodes());
+  llvm::StringMap<size_t> referenceIds;
+  for (size_t id = 0; id < reference.GetNumNodes(); ++id) {
+    if (auto node = reference.GetNode(id)) {
+      names[id] = GetNodeName(*node, slotTracker);
+      referenceIds[names[id]] = id;
+    }
+  }
+
+  std::vector<size_t> toReference(candidate.GetNumNodes(), InvalidId);
+  for (size_t id = 0; id < candidate.GetNumNodes(); ++id) {
+    auto node = candidate.GetNode(id);
+    if (!node) {
+      continue;
+    }
+    auto name = GetNodeName(*node, slotTracker);
+    auto it = referenceIds.find(name);
+    if (it == referenceIds.end() || reference.GetNode(it->second)->isPointer() != node->isPointer()) {
+      os << "anderson: verify: node " << name << " has no counterpart in the reference solution\n";
+      return false;
+    }
+    toReference[id] = it->second;
+  }
+
+  // Compare the pointee sets, in terms of the reference node IDs.
+  std::vector<Mismatch> mismatches;
+  std::vector<bool> mismatched(reference.GetNumNodes(), false);
+  size_t numPointers = 0;
+  size_t numUnknown = 0;
+  for (size_t id = 0; id < candidate.GetNumNodes(); ++id) {
+    auto node = candidate.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    ++numPointers;
+    if (node->pointer()->isUnknown()) {
+      ++numUnknown;
+      continue;
+    }
+
+    auto referenceId = toReference[id];
+    auto candidatePointees = GetSortedPointees(*node->pointer(), toReference);
+    auto referencePointer = reference.GetNode(referenceId)->pointer();
+    std::vector<size_t> referencePointees;
+    referencePointees.reserve(referencePointer->GetPointeeSet().size());
+    for (auto pointee : referencePointer->GetPointeeSet()) {
+      referencePointees.push_back(pointee->node()->id());
+    }
+    std::sort(referencePointees.begin(), referencePointees.end());
+    if (candidatePointees == referencePointees) {
+      continue;
+    }
+
+    Mismatch mismatch { referenceId, { }, { } };
+    std::set_difference(referencePointees.begin(), referencePointees.end(),
+                        candidatePointees.begin(), candidatePointees.end(), std::back_inserter(mismatch.missing));
+    std::set_difference(candidatePointees.begin(), candidatePointees.end(),
+                        referencePointees.begin(), referencePointees.end(), std::back_inserter(mismatch.extra));
+    mismatched[referenceId] = true;
+    mismatches.push_back(std::move(mismatch));
+  }
+
+  if (mismatches.empty()) {
+    return true;
+  }
+
+  // The stores `*w = u` and the copies `*w = *u` that may write to each mismatched pointer, according to the reference
+  // solution.
+  std::vector<std::vector<std::pair<const Pointer *, const Pointer *>>> stores(reference.GetNumNodes());
+  for (size_t id = 0; id < reference.GetNumNodes(); ++id) {
+    auto node = reference.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    auto pointer = node->pointer();
+    for (auto pointee : pointer->GetPointeeSet()) {
+      if (pointee->isPointer() && mismatched[pointee->node()->id()]) {
+        for (const auto &e : pointer->pointee_assigned()) {
+          stores[pointee->node()->id()].emplace_back(pointer, e.pointer());
+        }
+      }
+      for (const auto &e : pointer->pointee_copied()) {
+        for (auto source : e.pointer()->GetPointeeSet()) {
+          ForEachCopiedPointer(*pointee->node(), *source->node(), [&](Pointer *copied, Pointer *) noexcept {
+            if (mismatched[copied->node()->id()]) {
+              stores[copied->node()->id()].emplace_back(pointer, e.pointer());
+            }
+          });
+        }
+      }
+    }
+  }
+
+  // A mismatched pointer whose operands all agree with the reference is where the solutions start to diverge.
+  auto hasMismatchedOperand = [&](const Mismatch &mismatch) noexcept -> bool {
+    auto pointer = reference.GetNode(mismatch.id)->pointer();
+    for (const auto &e : pointer->assigned_element_ptr()) {
+      if (mismatched[e.pointer()->node()->id()]) {
+        return true;
+      }
+    }
+    for (const auto &e : pointer->assigned_pointee()) {
+      if (mismatched[e.pointer()->node()->id()]) {
+        return true;
+      }
+      for (auto pointee : e.pointer()->GetPointeeSet()) {
+        if (pointee->isPointer() && mismatched[pointee->node()->id()]) {
+          return true;
+        }
+      }
+    }
+    for (const auto &store : stores[mismatch.id]) {
+      if (mismatched[store.first->node()->id()] || mismatched[store.second->node()->id()]) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto size = [&](const Mismatch &mismatch) noexcept -> size_t {
+    auto pointer = reference.GetNode(mismatch.id)->pointer();
+    return pointer->GetNumAssignedAddressOf() + pointer->GetNumAssignedElementPtr() +
+           pointer->GetNumAssignedPointee() + stores[mismatch.id].size() +
+           mismatch.missing.size() + mismatch.extra.size();
+  };
+
+  const Mismatch *counterexample = nullptr;
+  auto diverging = false;
+  for (const auto &mismatch : mismatches) {
+    auto isDiverging = !hasMismatchedOperand(mismatch);
+    if (!counterexample || (isDiverging && !diverging) ||
+        (isDiverging == diverging && size(mismatch) < size(*counterexample))) {
+      counterexample = &mismatch;
+      diverging = isDiverging;
+    }
+  }
+
+  os << "anderson: verify: points-to sets differ for " << mismatches.size() << " of " << numPointers << " pointers";
+  if (numUnknown != 0) {
+    os << " (" << numUnknown << " unknown pointers skipped)";
+  }
+  os << "\n";
+
+  const auto &name = names[counterexample->id];
+  os << "  counterexample: " << name
+     << (diverging ? ", whose operands all agree with the reference\n"
+                   : ", on a cycle of mismatched pointers\n");
+  auto pointer = reference.GetNode(counterexample->id)->pointer();
+  for (const auto &e : pointer->assigned_address_of()) {
+    os << "    " << name << " = &" << names[e.pointee()->node()->id()] << "\n";
+  }
+  for (const auto &e : pointer->assigned_element_ptr()) {
+    os << "    " << name << " = " << (e.isTrivialAssignment() ? "" : "&") << names[e.pointer()->node()->id()]
+       << (e.isTrivialAssignment() ? "" : "[...]") << "\n";
+  }
+  for (const auto &e : pointer->assigned_pointee()) {
+    os << "    " << name << " = *" << names[e.pointer()->node()->id()] << "\n";
+  }
+  for (const auto &store : stores[counterexample->id]) {
+    os << "    *" << names[store.first->node()->id()] << " = " << names[store.second->node()->id()] << "\n";
+  }
+  PrintPointees(os, "missing", counterexample->missing, names);
+  PrintPointees(os, "extra", counterexample->extra, names);
+  return false;
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,53 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_SOLVER_VERIFIER_H
+#define LLVM_ANDERSON_SRC_SOLVER_VERIFIER_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <memory>
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Solve the specified module with the plain fixpoint iteration of `PointsToSolver::Solve`, ignoring the budget, the
+ * profile and every other option but the entry points, the external summaries and the type filter, so that the result
+ * can serve as the reference for the other ways of solving.
+ *
+ * @param module the module.
+ * @return the solved value tree, with its constraints.
+ */
+std::unique_ptr<ValueTree> SolveReference(const llvm::Module &module) noexcept;
+
+/**
+ * Compare the points-to set of every pointer in the candidate solution with the reference solution.
+ *
+ * Nodes are matched by their names, so the candidate may come from a different value tree of the same module, e.g. one
+ * loaded from the cache or updated incrementally. Pointers that are unknown in the candidate are skipped, since unknown
+ * is a sound approximation of any set.
+ *
+ * On a mismatch, a counterexample is written to the output stream: a pointer whose set differs while the sets of all of
+ * its operands agree with the reference, together with its constraints and its missing and extra pointees. Relaxing
+ * that single pointer's constraints by hand tells which solution is wrong.
+ *
+ * @param module the analyzed module.
+ * @param candidate the solution to check.
+ * @param reference the solution of `SolveReference`.
+ * @param os the output stream of the report.
+ * @return whether the solutions agree.
+ */
+bool VerifySolution(const llvm::Module &module, const ValueTree &candidate, const ValueTree &reference,
+                    llvm::raw_ostream &os) noexcept;
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_SOLVER_VERIFIER_H
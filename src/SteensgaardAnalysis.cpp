@@ -0,0 +1,204 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "SteensgaardAnalysis.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/Support/TimeProfiler.h>
+
+namespace llvm {
+
+namespace anderson {
+
+constexpr uint32_t SteensgaardAnalysis::None;
+
+SteensgaardAnalysis::SteensgaardAnalysis(const ValueTree &valueTree) noexcept
+  : _valueTree(valueTree),
+    _roots(valueTree.GetNumNodes()),
+    _parents(valueTree.GetNumNodes()),
+    _ranks(valueTree.GetNumNodes(), 0),
+    _pointees(valueTree.GetNumNodes(), None),
+    _members()
+{
+  llvm::TimeTraceScope timeScope { "AndersonSteensgaard" };
+
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    _parents[id] = static_cast<uint32_t>(id);
+    auto node = valueTree.GetNode(id);
+    if (!node) {
+      _roots[id] = static_cast<uint32_t>(id);
+      continue;
+    }
+    while (!node->isRoot()) {
+      node = node->parent();
+    }
+    _roots[id] = static_cast<uint32_t>(node->id());
+  }
+
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+
+    auto pointer = node->pointer();
+    for (const auto &e : pointer->assigned_address_of()) {
+      // p = &o
+      auto pointee = GetPointee(GetCell(*node));
+      Join(pointee, GetCell(*e.pointee()->node()));
+    }
+    for (const auto &e : pointer->assigned_element_ptr()) {
+      // p = q, p = &q[...]
+      auto pointee = GetPointee(GetCell(*node));
+      Join(pointee, GetPointee(GetCell(*e.pointer()->node())));
+    }
+    for (const auto &e : pointer->assigned_pointee()) {
+      // p = *q
+      auto pointee = GetPointee(GetCell(*node));
+      Join(pointee, GetPointee(GetPointee(GetCell(*e.pointer()->node()))));
+    }
+    for (const auto &e : pointer->pointee_assigned()) {
+      // *p = q
+      auto pointee = GetPointee(GetPointee(GetCell(*node)));
+      Join(pointee, GetPointee(GetCell(*e.pointer()->node())));
+    }
+    for (const auto &e : pointer->pointee_copied()) {
+      // *p = *q
+      auto pointee = GetPointee(GetPointee(GetCell(*node)));
+      Join(pointee, GetPointee(GetPointee(GetCell(*e.pointer()->node()))));
+    }
+  }
+}
+
+size_t SteensgaardAnalysis::GetNumClasses() noexcept {
+  std::vector<bool> seen(_parents.size(), false);
+  size_t numClasses = 0;
+  for (size_t id = 0; id < _valueTree.GetNumNodes(); ++id) {
+    if (!_valueTree.GetNode(id)) {
+      continue;
+    }
+    auto cell = Find(_roots[id]);
+    if (!seen[cell]) {
+      seen[cell] = true;
+      ++numClasses;
+    }
+  }
+  return numClasses;
+}
+
+std::vector<std::vector<Pointer *>> SteensgaardAnalysis::GetRegions() noexcept {
+  // Regions are the connected components of the classes linked by points-to edges.
+  std::vector<uint32_t> components(_parents.size());
+  for (uint32_t cell = 0; cell < components.size(); ++cell) {
+    components[cell] = cell;
+  }
+  auto findComponent = [&components](uint32_t cell) noexcept {
+    while (components[cell] != cell) {
+      components[cell] = components[components[cell]];
+      cell = components[cell];
+    }
+    return cell;
+  };
+  for (uint32_t cell = 0; cell < _parents.size(); ++cell) {
+    if (Find(cell) == cell && _pointees[cell] != None) {
+      components[findComponent(cell)] = findComponent(Find(_pointees[cell]));
+    }
+  }
+
+  std::vector<std::vector<Pointer *>> regions;
+  llvm::DenseMap<uint32_t, size_t> regionIndices;
+  for (size_t id = 0; id < _valueTree.GetNumNodes(); ++id) {
+    auto node = _valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    auto component = findComponent(GetCell(*node));
+    auto it = regionIndices.try_emplace(component, regions.size()).first;
+    if (it->second == regions.size()) {
+      regions.emplace_back();
+    }
+    regions[it->second].push_back(node->pointer());
+  }
+
+  std::stable_sort(regions.begin(), regions.end(), [](const auto &lhs, const auto &rhs) noexcept {
+    return lhs.size() < rhs.size();
+  });
+  return regions;
+}
+
+void SteensgaardAnalysis::AssignFallbackPointees(Pointer &pointer) noexcept {
+  if (_members.empty()) {
+    _members.resize(_parents.size());
+    for (size_t id = 0; id < _valueTree.GetNumNodes(); ++id) {
+      if (auto node = _valueTree.GetNode(id)) {
+        _members[GetCell(*node)].push_back(node->pointee());
+      }
+    }
+  }
+
+  auto &pointees = pointer.GetPointeeSet();
+  pointees.clear();
+  auto cell = GetCell(*pointer.node());
+  if (_pointees[cell] == None) {
+    return;
+  }
+  for (auto pointee : _members[Find(_pointees[cell])]) {
+    pointees.insert(pointee);
+  }
+}
+
+uint32_t SteensgaardAnalysis::Find(uint32_t cell) noexcept {
+  while (_parents[cell] != cell) {
+    _parents[cell] = _parents[_parents[cell]];
+    cell = _parents[cell];
+  }
+  return cell;
+}
+
+uint32_t SteensgaardAnalysis::GetPointee(uint32_t cell) noexcept {
+  cell = Find(cell);
+  if (_pointees[cell] == None) {
+    auto pointee = static_cast<uint32_t>(_parents.size());
+    _parents.push_back(pointee);
+    _ranks.push_back(0);
+    _pointees.push_back(None);
+    _pointees[cell] = pointee;
+    return pointee;
+  }
+  return Find(_pointees[cell]);
+}
+
+void SteensgaardAnalysis::Join(uint32_t first, uint32_t second) noexcept {
+  std::vector<std::pair<uint32_t, uint32_t>> pending { { first, second } };
+  while (!pending.empty()) {
+    auto lhs = Find(pending.back().first);
+    auto rhs = Find(pending.back().second);
+    pending.pop_back();
+    if (lhs == rhs) {
+      continue;
+    }
+
+    if (_ranks[lhs] < _ranks[rhs]) {
+      std::swap(lhs, rhs);
+    }
+    _parents[rhs] = lhs;
+    if (_ranks[lhs] == _ranks[rhs]) {
+      ++_ranks[lhs];
+    }
+
+    // The merged class points to the union of the classes both of them point to.
+    if (_pointees[lhs] == None) {
+      _pointees[lhs] = _pointees[rhs];
+    } else if (_pointees[rhs] != None) {
+      pending.emplace_back(_pointees[lhs], _pointees[rhs]);
+    }
+  }
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,92 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_STEENSGAARD_ANALYSIS_H
+#define LLVM_ANDERSON_SRC_STEENSGAARD_ANALYSIS_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Unification-based (Steensgaard) points-to analysis over the constraints of a value tree.
+ *
+ * The analysis is field-insensitive: every root value together with all of its descendants forms a single cell, and
+ * cells are merged into equivalence classes, each pointing to at most one class. It runs in near-linear time in the
+ * number of constraints.
+ *
+ * The classes serve two purposes:
+ *
+ * - The classes linked by points-to edges form regions. No constraint relates pointers of different regions, so the
+ *   inclusion solver can solve each region on its own;
+ * - The class pointed to by the class of a pointer contains every pointee the inclusion solver can find for it, so it
+ *   is a sound fallback for regions the inclusion solver cannot afford to solve.
+ */
+class SteensgaardAnalysis {
+public:
+  /**
+   * Run the analysis on the constraints of the specified value tree.
+   *
+   * @param valueTree the value tree, holding all of its constraints including the trivial ones.
+   */
+  explicit SteensgaardAnalysis(const ValueTree &valueTree) noexcept;
+
+  /**
+   * Get the number of equivalence classes that contain at least one value tree node.
+   *
+   * @return the number of equivalence classes.
+   */
+  size_t GetNumClasses() noexcept;
+
+  /**
+   * Partition the pointers of the value tree into independent regions.
+   *
+   * @return the pointers of each region, in increasing order of the region sizes.
+   */
+  std::vector<std::vector<Pointer *>> GetRegions() noexcept;
+
+  /**
+   * Replace the pointee set of the specified pointer with all value tree nodes in the class pointed to by its class.
+   *
+   * @param pointer the pointer.
+   */
+  void AssignFallbackPointees(Pointer &pointer) noexcept;
+
+private:
+  static constexpr uint32_t None = UINT32_MAX;
+
+  const ValueTree &_valueTree;
+  std::vector<uint32_t> _roots;
+  std::vector<uint32_t> _parents;
+  std::vector<uint32_t> _ranks;
+  std::vector<uint32_t> _pointees;
+  std::vector<std::vector<Pointee *>> _members;
+
+  uint32_t Find(uint32_t cell) noexcept;
+
+  uint32_t GetCell(const ValueTreeNode &node) noexcept {
+    return Find(_roots[node.id()]);
+  }
+
+  /**
+   * Get the class pointed to by the specified class, creating an empty class if there is none yet.
+   */
+  uint32_t GetPointee(uint32_t cell) noexcept;
+
+  /**
+   * Merge the specified classes, and recursively the classes they point to.
+   */
+  void Join(uint32_t first, uint32_t second) noexcept;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_STEENSGAARD_ANALYSIS_H
@@ -0,0 +1,388 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "TaintAnalysis.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+#include "ExternalSummaries.h"
+#include "TypeFilter.h"
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+const ValueTreeNode* GetRootNode(const ValueTreeNode *node) noexcept {
+  while (!node->isRoot()) {
+    node = node->parent();
+  }
+  return node;
+}
+
+bool ContainsPointer(const llvm::Type *type) noexcept {
+  if (type->isPointerTy()) {
+    return true;
+  }
+  for (auto elementType : type->subtypes()) {
+    if (ContainsPointer(elementType)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Determine whether the constraints generated for the specified call pass its arguments to the callee and its return
+ * value back to the caller.
+ *
+ * Direct calls to functions defined in the module are modeled, except for the arguments passed through a variable
+ * argument list, and so are calls to external functions with a summary, which describes every pointer they capture or
+ * return. Arguments of other calls escape into unknown code, and the pointers they return may point to any escaped
+ * object.
+ */
+bool IsModeledCall(const llvm::CallBase &call, const ValueTree &valueTree) noexcept {
+  auto callee = call.getCalledFunction();
+  if (!llvm::isa<llvm::CallInst>(call) || !callee || callee->isIntrinsic()) {
+    return false;
+  }
+  if (callee->isDeclaration()) {
+    auto summaries = valueTree.GetExternalSummaries();
+    return summaries && summaries->GetCalleeSummary(call);
+  }
+  return !callee->isVarArg() && valueTree.GetValueNode(callee);
+}
+
+/**
+ * Determine whether every caller of the specified function is a call modeled by the constraint generator.
+ */
+bool HasOnlyModeledCallers(const llvm::Function &function, const ValueTree &valueTree) noexcept {
+  if (!function.hasLocalLinkage()) {
+    return false;
+  }
+  for (auto user : function.users()) {
+    auto call = llvm::dyn_cast<llvm::CallBase>(user);
+    if (!call || call->getCalledOperand() != &function || !IsModeledCall(*call, valueTree)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace <anonymous>
+
+bool MayCarryPointer(const llvm::Type *type, const llvm::DataLayout &dataLayout) noexcept {
+  if (ContainsPointer(type)) {
+    return true;
+  }
+  if (!type->isSized()) {
+    return false;
+  }
+  auto storeSize = dataLayout.getTypeStoreSizeInBits(const_cast<llvm::Type *>(type)).getKnownMinSize();
+  return storeSize >= dataLayout.getPointerSizeInBits();
+}
+
+TaintAnalysis::TaintAnalysis(const llvm::Module &module, const ValueTree &valueTree) noexcept
+  : _valueTree(valueTree),
+    _objects(),
+    _unmodeledAccesses(),
+    _contents(),
+    _taintedValues(),
+    _taintedContents(),
+    _escaped(),
+    _changed(false)
+{
+  // Reduce the points-to sets to object sets.
+  ObjectSet externalObjects;
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node) {
+      continue;
+    }
+
+    auto root = GetRootNode(node);
+    // An unknown pointer may point to any object, so no object is known not to escape in a degraded solution.
+    if (node->isRoot() && (node->isGlobalMemory() || node->isArgumentMemory() ||
+                           (valueTree.isDegraded() && (node->isStackMemory() || node->isHeapMemory())))) {
+      externalObjects.set(static_cast<unsigned>(id));
+    }
+    if (!node->isPointer() || !root->value()) {
+      continue;
+    }
+    if (node->pointer()->isUnknown()) {
+      // Values without an object set are tainted, and so are pointers loaded from tainted contents.
+      if (!root->isNormalValue() && !root->isFunctionReturnValue()) {
+        _taintedContents.set(static_cast<unsigned>(root->id()));
+      }
+      continue;
+    }
+
+    ObjectSet pointees;
+    auto unmodeledAccess = false;
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      pointees.set(static_cast<unsigned>(GetRootNode(pointee->node())->id()));
+      unmodeledAccess |= !GetFirstScalarPointer(pointee);
+    }
+
+    if (root->isNormalValue()) {
+      if (node->isRoot()) {
+        _objects[node->value()] = std::move(pointees);
+        if (unmodeledAccess) {
+          _unmodeledAccesses.insert(node->value());
+        }
+      }
+    } else if (!root->isFunctionReturnValue()) {
+      _contents[static_cast<unsigned>(root->id())] |= pointees;
+    }
+  }
+
+  EscapeObjects(externalObjects);
+  do {
+    _changed = false;
+    for (const auto &function : module) {
+      for (const auto &bb : function) {
+        for (const auto &inst : bb) {
+          Visit(inst);
+        }
+      }
+    }
+  } while (_changed);
+}
+
+bool TaintAnalysis::isTainted(const llvm::Value *value) const noexcept {
+  if (llvm::isa<llvm::ConstantPointerNull>(value) || llvm::isa<llvm::UndefValue>(value)) {
+    return false;
+  }
+  if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+    if (!HasOnlyModeledCallers(*arg->getParent(), _valueTree)) {
+      return true;
+    }
+  }
+  auto pointees = GetObjects(value);
+  return !pointees || pointees->empty() || _taintedValues.count(value);
+}
+
+void TaintAnalysis::Taint(const llvm::Value *value) noexcept {
+  if (_taintedValues.insert(value).second) {
+    _changed = true;
+  }
+}
+
+void TaintAnalysis::EscapeObjects(const ObjectSet &escaping) noexcept {
+  llvm::SmallVector<unsigned, 8> stack;
+  for (auto object : escaping) {
+    if (_escaped.test_and_set(object)) {
+      stack.push_back(object);
+    }
+  }
+  _changed |= !stack.empty();
+  while (!stack.empty()) {
+    auto object = stack.pop_back_val();
+    auto it = _contents.find(object);
+    if (it == _contents.end()) {
+      continue;
+    }
+    for (auto content : it->second) {
+      if (_escaped.test_and_set(content)) {
+        stack.push_back(content);
+      }
+    }
+  }
+}
+
+void TaintAnalysis::Escape(const llvm::Value *value) noexcept {
+  if (auto pointees = GetObjects(value)) {
+    EscapeObjects(*pointees);
+  }
+}
+
+void TaintAnalysis::EscapeContents(const llvm::Value *pointer) noexcept {
+  auto pointees = GetObjects(pointer);
+  if (!pointees) {
+    return;
+  }
+  for (auto object : *pointees) {
+    auto it = _contents.find(object);
+    if (it != _contents.end()) {
+      EscapeObjects(it->second);
+    }
+  }
+}
+
+void TaintAnalysis::TaintContents(const llvm::Value *pointer) noexcept {
+  if (auto pointees = GetObjects(pointer)) {
+    _changed |= (_taintedContents |= *pointees);
+  }
+}
+
+bool TaintAnalysis::MayHoldTaintedContents(const llvm::Value *pointer) const noexcept {
+  auto pointees = GetObjects(pointer);
+  return !pointees || pointees->intersects(_taintedContents) || pointees->intersects(_escaped);
+}
+
+void TaintAnalysis::Load(const llvm::Value *loaded, const llvm::Value *pointer) noexcept {
+  if (isTainted(pointer) || MayHoldTaintedContents(pointer) || _unmodeledAccesses.count(pointer)) {
+    Taint(loaded);
+  }
+}
+
+void TaintAnalysis::Store(const llvm::Value *stored, const llvm::Value *pointer) noexcept {
+  auto unmodeledAccess = _unmodeledAccesses.count(pointer) != 0;
+  if (unmodeledAccess || isTainted(pointer)) {
+    Escape(stored);
+  }
+  if (unmodeledAccess || isTainted(stored)) {
+    TaintContents(pointer);
+  }
+}
+
+void TaintAnalysis::Copy(const llvm::Value *target, const llvm::Value *source) noexcept {
+  // A copy loads every pointer held by the source and stores it into the target.
+  auto unmodeledAccess = _unmodeledAccesses.count(target) != 0;
+  if (unmodeledAccess || isTainted(target)) {
+    EscapeContents(source);
+  }
+  if (unmodeledAccess || isTainted(source) || MayHoldTaintedContents(source)) {
+    TaintContents(target);
+  }
+}
+
+void TaintAnalysis::Visit(const llvm::Instruction &inst) noexcept {
+  if (llvm::isa<llvm::DbgInfoIntrinsic>(inst) || inst.isLifetimeStartOrEnd()) {
+    return;
+  }
+
+  // Values that are not loaded or stored as pointers, but are wide enough to carry one, may smuggle pointers through
+  // memory.
+  const auto &dataLayout = inst.getModule()->getDataLayout();
+
+  if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+    auto pointer = load->getPointerOperand();
+    if (load->getType()->isPointerTy()) {
+      Load(load, pointer);
+    } else if (MayCarryPointer(load->getType(), dataLayout)) {
+      EscapeContents(pointer);
+    }
+    return;
+  }
+
+  if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+    auto value = store->getValueOperand();
+    auto pointer = store->getPointerOperand();
+    if (value->getType()->isPointerTy()) {
+      Store(value, pointer);
+    } else if (MayCarryPointer(value->getType(), dataLayout)) {
+      TaintContents(pointer);
+    }
+    return;
+  }
+
+  if (llvm::isa<llvm::GetElementPtrInst>(inst) || llvm::isa<llvm::PHINode>(inst) ||
+      llvm::isa<llvm::SelectInst>(inst) || llvm::isa<llvm::BitCastInst>(inst) ||
+      llvm::isa<llvm::AddrSpaceCastInst>(inst)) {
+    if (!inst.getType()->isPointerTy()) {
+      for (const auto &operand : inst.operands()) {
+        Escape(operand.get());
+      }
+      return;
+    }
+    for (const auto &source : inst.operands()) {
+      if (source->getType()->isPointerTy() && isTainted(source.get())) {
+        Taint(&inst);
+        break;
+      }
+    }
+    return;
+  }
+
+  if (llvm::isa<llvm::AllocaInst>(inst) || llvm::isa<llvm::ICmpInst>(inst)) {
+    return;
+  }
+
+  if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst)) {
+    auto &function = *ret->getFunction();
+    auto returnValue = ret->getReturnValue();
+    if (returnValue && !HasOnlyModeledCallers(function, _valueTree)) {
+      Escape(returnValue);
+    }
+    if (returnValue && returnValue->getType()->isPointerTy() && isTainted(returnValue)) {
+      // Calls that are not modeled are tainted anyway.
+      for (auto user : function.users()) {
+        auto call = llvm::dyn_cast<llvm::CallBase>(user);
+        if (call && call->getCalledOperand() == &function) {
+          Taint(call);
+        }
+      }
+    }
+    return;
+  }
+
+  if (auto call = llvm::dyn_cast<llvm::CallBase>(&inst)) {
+    if (!IsModeledCall(*call, _valueTree)) {
+      if (call->getType()->isPointerTy()) {
+        Taint(call);
+      }
+      for (const auto &operand : call->data_ops()) {
+        if (call->isArgOperand(&operand) && call->doesNotCapture(call->getArgOperandNo(&operand))) {
+          // The callee may still copy pointers into and out of the argument.
+          EscapeContents(operand.get());
+          TaintContents(operand.get());
+        } else {
+          Escape(operand.get());
+        }
+      }
+      return;
+    }
+
+    auto summaries = _valueTree.GetExternalSummaries();
+    auto summary = summaries ? summaries->GetCalleeSummary(*call) : nullptr;
+    if (!summary) {
+      for (const auto &param : call->getCalledFunction()->args()) {
+        if (param.getType()->isPointerTy() && isTainted(call->getArgOperand(param.getArgNo()))) {
+          Taint(&param);
+        }
+      }
+      return;
+    }
+
+    // The effects of a summary are treated like the copies, loads and stores they stand for.
+    for (const auto &effect : summary->effects) {
+      switch (effect.kind) {
+        case ExternalEffect::Kind::ReturnsNew:
+          break;
+        case ExternalEffect::Kind::ReturnsArgument:
+          if (isTainted(call->getArgOperand(effect.source))) {
+            Taint(call);
+          }
+          break;
+        case ExternalEffect::Kind::ReturnsArgumentPointee:
+          Load(call, call->getArgOperand(effect.source));
+          break;
+        case ExternalEffect::Kind::StoresArgument:
+          Store(call->getArgOperand(effect.source), call->getArgOperand(effect.target));
+          break;
+        case ExternalEffect::Kind::CopiesArgumentPointee:
+          Copy(call->getArgOperand(effect.target), call->getArgOperand(effect.source));
+          break;
+      }
+    }
+    return;
+  }
+
+  // Any other use of a pointer, e.g. `ptrtoint` or `insertvalue`, is not modeled.
+  for (const auto &operand : inst.operands()) {
+    Escape(operand.get());
+  }
+  if (inst.getType()->isPointerTy()) {
+    Taint(&inst);
+  }
+}
+
+} // namespace anderson
+
+} // namespace llvm
@@ -0,0 +1,142 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_TAINT_ANALYSIS_H
+#define LLVM_ANDERSON_SRC_TAINT_ANALYSIS_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SparseBitVector.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Type.h>
+#include <llvm/IR/Value.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * Determine whether a value of the specified type may carry a pointer through memory, i.e. whether the type contains a
+ * pointer or is wide enough to hold one, e.g. an integer converted from a pointer.
+ *
+ * @param type the type.
+ * @param dataLayout the data layout of the module.
+ * @return whether a value of the type may carry a pointer.
+ */
+bool MayCarryPointer(const llvm::Type *type, const llvm::DataLayout &dataLayout) noexcept;
+
+/**
+ * Conservative escape analysis that completes the solved points-to relation with the flows of pointers through code
+ * that the constraint generator does not model.
+ *
+ * An object is identified by the node ID of the root of its value tree.
+ *
+ * - An object escapes if its address flows into an operand that the constraint generator does not model, e.g. an
+ *   argument of a call or a `ptrtoint` instruction, or if it is reachable from an escaped object. Global and argument
+ *   memory has always escaped.
+ * - A pointer value is tainted if it may point to an escaped object that is not in its points-to set, e.g. because it
+ *   is loaded from an object that unknown code may have written to.
+ *
+ * A load or a store through a pointer that may point to memory that cannot hold a pointer at the accessed offset, e.g.
+ * an `i64` cast to `i8**`, is not modeled either, since the solver skips such pointees.
+ */
+class TaintAnalysis {
+public:
+  using ObjectSet = llvm::SparseBitVector<>;
+
+  /**
+   * Construct a new TaintAnalysis object and run the analysis to a fixpoint.
+   *
+   * @param module the module.
+   * @param valueTree the solved value tree of the module.
+   */
+  explicit TaintAnalysis(const llvm::Module &module, const ValueTree &valueTree) noexcept;
+
+  /**
+   * Get the objects that the specified pointer value may point into according to the points-to relation.
+   *
+   * @param value the pointer value.
+   * @return the objects, or nullptr if the value has no points-to set.
+   */
+  const ObjectSet* GetObjects(const llvm::Value *value) const noexcept {
+    auto it = _objects.find(value);
+    return it == _objects.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * Get the objects of every pointer value with a points-to set.
+   *
+   * @return the objects of every pointer value.
+   */
+  const llvm::DenseMap<const llvm::Value *, ObjectSet>& GetAllObjects() const noexcept {
+    return _objects;
+  }
+
+  /**
+   * Determine whether the specified pointer value may point to an escaped object that is not in its points-to set.
+   *
+   * Values without a points-to set are tainted, except for null and undefined pointers.
+   *
+   * @param value the pointer value.
+   * @return whether the value is tainted.
+   */
+  bool isTainted(const llvm::Value *value) const noexcept;
+
+  /**
+   * Get the escaped objects.
+   *
+   * @return the escaped objects.
+   */
+  const ObjectSet& GetEscapedObjects() const noexcept {
+    return _escaped;
+  }
+
+  /**
+   * Get the objects that the pointers stored in each object may point into, keyed by the stored-into object.
+   *
+   * @return the contents of every object.
+   */
+  const llvm::DenseMap<unsigned, ObjectSet>& GetContents() const noexcept {
+    return _contents;
+  }
+
+private:
+  const ValueTree &_valueTree;
+  llvm::DenseMap<const llvm::Value *, ObjectSet> _objects;
+  llvm::DenseSet<const llvm::Value *> _unmodeledAccesses;
+  llvm::DenseMap<unsigned, ObjectSet> _contents;
+  llvm::DenseSet<const llvm::Value *> _taintedValues;
+  ObjectSet _taintedContents;
+  ObjectSet _escaped;
+  bool _changed;
+
+  void Taint(const llvm::Value *value) noexcept;
+
+  void EscapeObjects(const ObjectSet &escaping) noexcept;
+
+  void Escape(const llvm::Value *value) noexcept;
+
+  void EscapeContents(const llvm::Value *pointer) noexcept;
+
+  void TaintContents(const llvm::Value *pointer) noexcept;
+
+  bool MayHoldTaintedContents(const llvm::Value *pointer) const noexcept;
+
+  void Load(const llvm::Value *loaded, const llvm::Value *pointer) noexcept;
+
+  void Store(const llvm::Value *stored, const llvm::Value *pointer) noexcept;
+
+  void Copy(const llvm::Value *target, const llvm::Value *source) noexcept;
+
+  void Visit(const llvm::Instruction &inst) noexcept;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_TAINT_ANALYSIS_H
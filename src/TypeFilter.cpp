@@ -0,0 +1,132 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "TypeFilter.h"
+
+#include <llvm/IR/DerivedTypes.h>
+
+namespace llvm {
+
+namespace anderson {
+
+namespace {
+
+/**
+ * Determine whether the specified type is, or starts with, the specified prefix type at offset zero.
+ */
+bool StartsWith(const llvm::Type *type, const llvm::Type *prefix) noexcept {
+  while (true) {
+    if (type == prefix) {
+      return true;
+    }
+    auto structType = llvm::dyn_cast<llvm::StructType>(type);
+    auto prefixStructType = llvm::dyn_cast<llvm::StructType>(prefix);
+    if (structType && prefixStructType && !structType->isOpaque() && !prefixStructType->isOpaque() &&
+        structType->isLayoutIdentical(const_cast<llvm::StructType *>(prefixStructType))) {
+      // Linking renames identical struct types, e.g. to `struct.S.0`.
+      return true;
+    }
+
+    if (structType && !structType->isOpaque() && structType->getNumElements() != 0) {
+      type = structType->getElementType(0);
+    } else if (auto arrayType = llvm::dyn_cast<llvm::ArrayType>(type)) {
+      type = arrayType->getElementType();
+    } else {
+      return false;
+    }
+  }
+}
+
+/**
+ * Get the node accessed at offset zero of the specified node.
+ */
+const ValueTreeNode* GetFirstScalar(const ValueTreeNode *node) noexcept {
+  while (!node->isPointer() && node->GetNumChildren() != 0) {
+    node = node->GetChild(0);
+  }
+  return node;
+}
+
+} // namespace <anonymous>
+
+Pointer* GetFirstScalarPointer(const Pointee *pointee) noexcept {
+  auto slot = GetFirstScalar(pointee->node());
+  return slot->isPointer() ? slot->pointer() : nullptr;
+}
+
+constexpr size_t TypeFilter::MaxMatrixTypes;
+constexpr uint32_t TypeFilter::NotPointer;
+
+TypeFilter::TypeFilter(const ValueTree &valueTree) noexcept
+  : _types(),
+    _typeIds(),
+    _nodeTypes(),
+    _compatible()
+{
+  _nodeTypes.resize(valueTree.GetNumNodes(), NotPointer);
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    auto inserted = _typeIds.insert(std::make_pair(node->type(), static_cast<uint32_t>(_types.size())));
+    if (inserted.second) {
+      _types.push_back(node->type());
+    }
+    _nodeTypes[id] = inserted.first->second;
+  }
+
+  if (_types.size() > MaxMatrixTypes) {
+    return;
+  }
+  _compatible.resize(_types.size() * _types.size());
+  for (size_t slot = 0; slot < _types.size(); ++slot) {
+    for (size_t access = 0; access < _types.size(); ++access) {
+      if (AreCompatible(_types[slot], _types[access])) {
+        _compatible.set(slot * _types.size() + access);
+      }
+    }
+  }
+}
+
+Pointer* TypeFilter::GetAccessedPointer(Pointee *pointee, const Pointer *access) const noexcept {
+  auto slot = GetFirstScalarPointer(pointee);
+  if (!slot || !IsCompatible(*slot->node(), *access->node())) {
+    return nullptr;
+  }
+  return slot;
+}
+
+bool TypeFilter::IsCompatible(const ValueTreeNode &slot, const ValueTreeNode &access) const noexcept {
+  if (!_compatible.empty() && slot.id() < _nodeTypes.size() && access.id() < _nodeTypes.size()) {
+    return _compatible.test(_nodeTypes[slot.id()] * _types.size() + _nodeTypes[access.id()]);
+  }
+  return AreCompatible(slot.type(), access.type());
+}
+
+bool TypeFilter::AreCompatible(const llvm::Type *slot, const llvm::Type *access) noexcept {
+  if (slot == access) {
+    return true;
+  }
+
+  auto slotPointerType = llvm::cast<llvm::PointerType>(slot);
+  auto accessPointerType = llvm::cast<llvm::PointerType>(access);
+  if (slotPointerType->isOpaque() || accessPointerType->isOpaque()) {
+    return true;
+  }
+
+  auto slotElementType = slotPointerType->getPointerElementType();
+  auto accessElementType = accessPointerType->getPointerElementType();
+  if (slotElementType->isIntegerTy(8) || accessElementType->isIntegerTy(8)) {
+    return true;
+  }
+  if (slotElementType->isFunctionTy() && accessElementType->isFunctionTy()) {
+    return true;
+  }
+  return StartsWith(slotElementType, accessElementType) || StartsWith(accessElementType, slotElementType);
+}
+
+} // namespace anderson
+
+} // namespace llvm
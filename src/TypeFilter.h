@@ -0,0 +1,159 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef LLVM_ANDERSON_SRC_TYPE_FILTER_H
+#define LLVM_ANDERSON_SRC_TYPE_FILTER_H
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Type.h>
+
+namespace llvm {
+
+namespace anderson {
+
+/**
+ * How strictly the solver filters the pointees of the pointer a load or a store goes through.
+ *
+ * In every mode, a pointee is accessed at its first scalar element, which is what a load or a store through a cast
+ * pointer reaches, and a pointee that cannot hold a pointer there, e.g. an `i64` cast to `i8**`, is skipped. The
+ * clients of the solution treat such accesses as unmodeled, so skipping them is sound.
+ */
+enum class TypeFilterMode {
+  /**
+   * Do not filter the pointees by type.
+   */
+  None,
+
+  /**
+   * Reject the pointees whose pointer type is incompatible with the type of the loaded or stored value. This is only
+   * sound for programs that do not access a pointer through a pointer of an unrelated type.
+   */
+  Strict,
+};
+
+/**
+ * Get the pointer at offset zero of the specified pointee, which is what a load or a store through a pointer to the
+ * pointee reaches. An aggregate pointee is accessed at its first scalar element, e.g. when a pointer to a struct is cast
+ * to a pointer to a pointer.
+ *
+ * @param pointee the pointee.
+ * @return the pointer at offset zero, or nullptr if the pointee cannot hold a pointer there, e.g. if it is an integer.
+ */
+Pointer* GetFirstScalarPointer(const Pointee *pointee) noexcept;
+
+namespace details {
+
+template <typename Visitor>
+void ForEachCopiedPointerInNode(ValueTreeNode &target, ValueTreeNode &source, Visitor &visitor) noexcept {
+  if (source.isPointer()) {
+    auto copied = target.isPointer() ? target.pointer() : GetFirstScalarPointer(target.pointee());
+    if (copied) {
+      visitor(copied, source.pointer());
+    }
+    return;
+  }
+  for (size_t i = 0; i < source.GetNumChildren(); ++i) {
+    auto targetChild = i < target.GetNumChildren() ? target.GetChild(i) : &target;
+    ForEachCopiedPointerInNode(*targetChild, *source.GetChild(i), visitor);
+  }
+}
+
+} // namespace details
+
+/**
+ * Visit the pointers that a copy of the memory at the specified source node into the memory at the specified target
+ * node, e.g. a `memcpy`, assigns.
+ *
+ * Every pointer in the source is paired with the pointer at the same position in the target, or with the first scalar
+ * pointer of the innermost target node covering that position if the layouts differ. A source that is an array element
+ * stands for the rest of its array, since the copy may span several elements.
+ *
+ * @tparam Visitor type of the visitor, which takes the assigned target pointer and the copied source pointer, both of
+ * type `Pointer *`.
+ * @param target the node copied into.
+ * @param source the node copied from.
+ * @param visitor the visitor.
+ */
+template <typename Visitor>
+void ForEachCopiedPointer(ValueTreeNode &target, ValueTreeNode &source, Visitor &&visitor) noexcept {
+  auto sourceArray = source.parent();
+  if (!sourceArray || !sourceArray->type()->isArrayTy()) {
+    details::ForEachCopiedPointerInNode(target, source, visitor);
+    return;
+  }
+
+  auto targetArray = target.parent();
+  auto targetIsElement = targetArray && targetArray->type()->isArrayTy();
+  for (auto i = source.offset(); i < sourceArray->GetNumChildren(); ++i) {
+    auto targetIndex = target.offset() + (i - source.offset());
+    auto targetElement = targetIsElement && targetIndex < targetArray->GetNumChildren()
+                         ? targetArray->GetChild(targetIndex)
+                         : &target;
+    details::ForEachCopiedPointerInNode(*targetElement, *sourceArray->GetChild(i), visitor);
+  }
+}
+
+/**
+ * Decides which pointee a load or a store reaches, according to the types of the value tree nodes.
+ *
+ * The compatibility of every pair of pointer types found in the value tree is precomputed. Two pointer
+ * types are compatible if they are equal, if either points to `i8` or is opaque, if both point to functions, or if the
+ * type pointed to by one starts with the type pointed to by the other.
+ */
+class TypeFilter {
+public:
+  /**
+   * Precompute the types of the pointers in the specified value tree.
+   *
+   * @param valueTree the value tree. Nodes added later are handled, but more slowly.
+   */
+  explicit TypeFilter(const ValueTree &valueTree) noexcept;
+
+  /**
+   * Get the pointer that a load or a store of the specified pointer reaches through the specified pointee.
+   *
+   * @param pointee the pointee of the pointer operand of the load or the store.
+   * @param access the loaded or the stored pointer.
+   * @return the pointer reached, or nullptr if the pointee is rejected.
+   */
+  Pointer* GetAccessedPointer(Pointee *pointee, const Pointer *access) const noexcept;
+
+  /**
+   * Get the number of distinct pointer types in the value tree.
+   *
+   * @return the number of distinct pointer types.
+   */
+  size_t GetNumTypes() const noexcept {
+    return _types.size();
+  }
+
+private:
+  /**
+   * Maximal number of distinct pointer types whose compatibility is precomputed, which bounds the matrix to 2 MiB.
+   */
+  constexpr static size_t MaxMatrixTypes = 4096;
+
+  constexpr static uint32_t NotPointer = UINT32_MAX;
+
+  std::vector<const llvm::Type *> _types;
+  llvm::DenseMap<const llvm::Type *, uint32_t> _typeIds;
+  std::vector<uint32_t> _nodeTypes;
+  llvm::BitVector _compatible;
+
+  bool IsCompatible(const ValueTreeNode &slot, const ValueTreeNode &access) const noexcept;
+
+  static bool AreCompatible(const llvm::Type *slot, const llvm::Type *access) noexcept;
+};
+
+} // namespace anderson
+
+} // namespace llvm
+
+#endif // LLVM_ANDERSON_SRC_TYPE_FILTER_H
@@ -4,51 +4,303 @@
 
 #include "llvm-anderson/AndersonPointsToAnalysis.h"
 
+#include <algorithm>
+
+#include <llvm/Support/TimeProfiler.h>
+
+#include "ExternalSummaries.h"
+
 namespace llvm {
 
 namespace anderson {
 
+namespace {
+
+/**
+ * Determine whether the specified type holds a pointer at offset zero, i.e. at its first scalar element.
+ */
+bool StartsWithPointer(const llvm::Type *type) noexcept {
+  while (type->isStructTy() || type->isArrayTy()) {
+    if (type->isStructTy() && (llvm::cast<llvm::StructType>(type)->isOpaque() || type->getStructNumElements() == 0)) {
+      return false;
+    }
+    type = type->isStructTy() ? type->getStructElementType(0) : type->getArrayElementType();
+  }
+  return type->isPointerTy();
+}
+
+/**
+ * Get the type of the object allocated by the specified call, which is the type that the returned pointer is cast to,
+ * if any. Casts to types that hold a pointer at offset zero are preferred, so that the pointers stored through them are
+ * not lost when the result is also cast to an integer type.
+ */
+const llvm::Type* GetAllocatedType(const llvm::CallInst &call) noexcept {
+  const llvm::Type *allocatedType = nullptr;
+  for (auto user : call.users()) {
+    auto cast = llvm::dyn_cast<llvm::BitCastInst>(user);
+    if (!cast || !cast->getType()->isPointerTy() || !cast->getType()->getPointerElementType()->isSized()) {
+      continue;
+    }
+    auto castType = cast->getType()->getPointerElementType();
+    if (StartsWithPointer(castType)) {
+      return castType;
+    }
+    if (!allocatedType) {
+      allocatedType = castType;
+    }
+  }
+  return allocatedType ? allocatedType : call.getType()->getPointerElementType();
+}
+
+} // namespace <anonymous>
+
 template <typename ...Args>
-static std::unique_ptr<ValueTreeNode> CreateNode(size_t &numPointees, size_t &numPointers, Args&&... args) noexcept {
+std::unique_ptr<ValueTreeNode> ValueTree::CreateRoot(Args&&... args) noexcept {
   auto node = std::make_unique<ValueTreeNode>(std::forward<Args>(args)...);
-  numPointees += node->GetNumPointees();
-  numPointers += node->GetNumPointers();
+  DropReverseIndex();
+  _numPointees += node->GetNumPointees();
+  _numPointers += node->GetNumPointers();
+
+  node->Visit([this](ValueTreeNode &n) noexcept -> bool {
+    n._id = _nodes.size();
+    _nodes.push_back(&n);
+    return true;
+  });
+
   return node;
 }
 
-ValueTree::ValueTree(const llvm::Module &module) noexcept
-  : _module(module),
+void ValueTree::UnregisterNodes(ValueTreeNode &root) noexcept {
+  DropReverseIndex();
+  _numPointees -= root.GetNumPointees();
+  _numPointers -= root.GetNumPointers();
+
+  root.Visit([this](ValueTreeNode &n) noexcept -> bool {
+    _nodes[n._id] = nullptr;
+    return true;
+  });
+}
+
+ValueTree::ValueTree(const llvm::Module &module,
+                     const std::unordered_set<const llvm::GlobalValue *> *reachable,
+                     const ExternalSummaries *summaries) noexcept
+  : _module(&module),
     _roots(),
     _allocaMemoryRoots(),
     _globalMemoryRoots(),
     _argumentMemoryRoots(),
     _returnValueRoots(),
+    _heapMemoryRoots(),
+    _functionRoots(),
+    _detachedRoots(),
+    _nodes(),
+    _reverseIndexOffsets(),
+    _reverseIndexPointers(),
     _numPointees(0),
-    _numPointers(0)
+    _numPointers(0),
+    _degraded(false),
+    _approximate(false),
+    _summaries(summaries)
 {
+  llvm::TimeTraceScope timeScope { "AndersonValueTree" };
+
   for (const auto &globalVariable : module.globals()) {
-    _roots[&globalVariable] = CreateNode(_numPointees, _numPointers, &globalVariable);
-    _globalMemoryRoots[&globalVariable] = CreateNode(_numPointees, _numPointers, GlobalMemoryValueTag { }, &globalVariable);
+    if (reachable && !reachable->count(&globalVariable)) {
+      continue;
+    }
+    _roots[&globalVariable] = CreateRoot(&globalVariable);
+    _globalMemoryRoots[&globalVariable] = CreateRoot(GlobalMemoryValueTag { }, &globalVariable);
   }
 
   for (const auto &func : module) {
-    _roots[&func] = CreateNode(_numPointees, _numPointers, &func);
-    _returnValueRoots[&func] = CreateNode(_numPointees, _numPointers, FunctionReturnValueTag { }, &func);
-    for (const auto &arg : func.args()) {
-      _roots[&arg] = CreateNode(_numPointees, _numPointers, ArgumentMemoryValueTag { }, &arg);
-    }
-    for (const auto &bb : func) {
-      for (const auto &inst : bb) {
-        _roots[&inst] = CreateNode(_numPointees, _numPointers, &inst);
-        auto allocaInst = llvm::dyn_cast<llvm::AllocaInst>(&inst);
-        if (allocaInst) {
-          _allocaMemoryRoots[allocaInst] = CreateNode(_numPointees, _numPointers, StackMemoryValueTag { }, allocaInst);
+    if (reachable && !reachable->count(&func)) {
+      continue;
+    }
+    AddFunction(func);
+  }
+}
+
+ValueTree::ValueTree() noexcept
+  : _module(nullptr),
+    _roots(),
+    _allocaMemoryRoots(),
+    _globalMemoryRoots(),
+    _argumentMemoryRoots(),
+    _returnValueRoots(),
+    _heapMemoryRoots(),
+    _functionRoots(),
+    _detachedRoots(),
+    _nodes(),
+    _reverseIndexOffsets(),
+    _reverseIndexPointers(),
+    _numPointees(0),
+    _numPointers(0),
+    _degraded(false),
+    _approximate(false),
+    _summaries(nullptr)
+{ }
+
+void ValueTree::AddFunction(const llvm::Function &function) noexcept {
+  auto &functionRoots = _functionRoots[&function];
+  assert(functionRoots.empty() && "function has already been added");
+
+  auto addRoot = [&functionRoots](std::unique_ptr<ValueTreeNode> &slot, std::unique_ptr<ValueTreeNode> root) {
+    functionRoots.push_back(root.get());
+    slot = std::move(root);
+  };
+
+  addRoot(_roots[&function], CreateRoot(&function));
+  addRoot(_returnValueRoots[&function], CreateRoot(FunctionReturnValueTag { }, &function));
+  for (const auto &arg : function.args()) {
+    addRoot(_roots[&arg], CreateRoot(&arg));
+    if (arg.getType()->isPointerTy()) {
+      addRoot(_argumentMemoryRoots[&arg], CreateRoot(ArgumentMemoryValueTag { }, &arg));
+    }
+  }
+
+  AddFunctionBody(function);
+}
+
+void ValueTree::AddFunctionBody(const llvm::Function &function) noexcept {
+  auto &functionRoots = _functionRoots[&function];
+  auto addRoot = [&functionRoots](std::unique_ptr<ValueTreeNode> &slot, std::unique_ptr<ValueTreeNode> root) {
+    functionRoots.push_back(root.get());
+    slot = std::move(root);
+  };
+
+  for (const auto &bb : function) {
+    for (const auto &inst : bb) {
+      addRoot(_roots[&inst], CreateRoot(&inst));
+      auto allocaInst = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+      if (allocaInst) {
+        addRoot(_allocaMemoryRoots[allocaInst], CreateRoot(StackMemoryValueTag { }, allocaInst));
+      }
+
+      auto callInst = llvm::dyn_cast<llvm::CallInst>(&inst);
+      if (callInst && _summaries) {
+        auto summary = _summaries->GetCalleeSummary(*callInst);
+        if (summary && summary->returnsNew()) {
+          addRoot(_heapMemoryRoots[callInst],
+                  CreateRoot(HeapMemoryValueTag { }, callInst, GetAllocatedType(*callInst)));
         }
       }
     }
   }
 }
 
+void ValueTree::DetachFunctionBody(const llvm::Function &function) noexcept {
+  auto it = _functionRoots.find(&function);
+  if (it == _functionRoots.end()) {
+    return;
+  }
+
+  auto &functionRoots = it->second;
+  auto keptRootsEnd = std::partition(functionRoots.begin(), functionRoots.end(), [](ValueTreeNode *root) noexcept {
+    return !root->isStackMemory() && !root->isHeapMemory() && !llvm::isa<llvm::Instruction>(root->value());
+  });
+
+  for (auto rootIt = keptRootsEnd; rootIt != functionRoots.end(); ++rootIt) {
+    auto root = *rootIt;
+    std::unique_ptr<ValueTreeNode> detachedRoot;
+    if (root->isStackMemory()) {
+      auto slot = _allocaMemoryRoots.find(root->GetStackMemoryAllocator());
+      detachedRoot = std::move(slot->second);
+      _allocaMemoryRoots.erase(slot);
+    } else if (root->isHeapMemory()) {
+      auto slot = _heapMemoryRoots.find(root->GetHeapMemoryAllocator());
+      detachedRoot = std::move(slot->second);
+      _heapMemoryRoots.erase(slot);
+    } else {
+      auto slot = _roots.find(root->value());
+      detachedRoot = std::move(slot->second);
+      _roots.erase(slot);
+    }
+
+    detachedRoot->_value = nullptr;
+    _detachedRoots.push_back(std::move(detachedRoot));
+  }
+
+  functionRoots.erase(keptRootsEnd, functionRoots.end());
+}
+
+void ValueTree::RemoveFunction(const llvm::Function *function) noexcept {
+  auto it = _functionRoots.find(function);
+  if (it == _functionRoots.end()) {
+    return;
+  }
+
+  for (auto root : it->second) {
+    UnregisterNodes(*root);
+
+    // The value might have been deleted, so only the address of the value is used to identify the root.
+    auto value = root->value();
+    switch (root->kind()) {
+      case ValueKind::Normal:
+        _roots.erase(value);
+        break;
+      case ValueKind::StackMemory:
+        _allocaMemoryRoots.erase(static_cast<const llvm::AllocaInst *>(value));
+        break;
+      case ValueKind::ArgumentMemory:
+        _argumentMemoryRoots.erase(static_cast<const llvm::Argument *>(value));
+        break;
+      case ValueKind::FunctionReturnValue:
+        _returnValueRoots.erase(static_cast<const llvm::Function *>(value));
+        break;
+      case ValueKind::HeapMemory:
+        _heapMemoryRoots.erase(static_cast<const llvm::CallInst *>(value));
+        break;
+      default:
+        llvm_unreachable("unexpected root kind of function value tree");
+    }
+  }
+
+  _functionRoots.erase(it);
+}
+
+ValueTreeNode* ValueTree::AddDetachedRoot(ValueKind kind, const llvm::Type *type) noexcept {
+  _detachedRoots.push_back(CreateRoot(kind, type));
+  return _detachedRoots.back().get();
+}
+
+void ValueTree::BuildReverseIndex() noexcept {
+  assert(_nodes.size() <= UINT32_MAX && "too many nodes for the reverse index");
+
+  // Count the pointers to each pointee into the slot after it, so that the prefix sums are the row offsets.
+  std::vector<size_t> offsets(_nodes.size() + 1, 0);
+  for (auto node : _nodes) {
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      ++offsets[pointee->node()->id() + 1];
+    }
+  }
+  for (size_t i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+
+  // Pointers are visited in increasing ID order, so every row ends up sorted.
+  std::vector<uint32_t> pointers(offsets.back());
+  std::vector<size_t> cursors { offsets.begin(), offsets.end() - 1 };
+  for (auto node : _nodes) {
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      pointers[cursors[pointee->node()->id()]++] = static_cast<uint32_t>(node->id());
+    }
+  }
+
+  _reverseIndexOffsets = std::move(offsets);
+  _reverseIndexPointers = std::move(pointers);
+}
+
+void ValueTree::DropReverseIndex() noexcept {
+  std::vector<size_t>().swap(_reverseIndexOffsets);
+  std::vector<uint32_t>().swap(_reverseIndexPointers);
+}
+
 } // namespace anderson
 
 } // namespace llvm
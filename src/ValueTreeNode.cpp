@@ -11,7 +11,8 @@ namespace llvm {
 namespace anderson {
 
 ValueTreeNode::ValueTreeNode(const llvm::Value *value) noexcept
-  : _type(value->getType()),
+  : _id(InvalidId),
+    _type(value->getType()),
     _value(value),
     _kind(ValueKind::Normal),
     _parent(nullptr),
@@ -25,7 +26,8 @@ ValueTreeNode::ValueTreeNode(const llvm::Value *value) noexcept
 }
 
 ValueTreeNode::ValueTreeNode(StackMemoryValueTag, const llvm::AllocaInst *stackMemoryAllocator) noexcept
-  : _type(stackMemoryAllocator->getAllocatedType()),
+  : _id(InvalidId),
+    _type(stackMemoryAllocator->getAllocatedType()),
     _value(stackMemoryAllocator),
     _kind(ValueKind::StackMemory),
     _parent(nullptr),
@@ -39,7 +41,8 @@ ValueTreeNode::ValueTreeNode(StackMemoryValueTag, const llvm::AllocaInst *stackM
 }
 
 ValueTreeNode::ValueTreeNode(GlobalMemoryValueTag, const llvm::GlobalVariable *globalVariable) noexcept
-  : _type(globalVariable->getValueType()),
+  : _id(InvalidId),
+    _type(globalVariable->getValueType()),
     _value(globalVariable),
     _kind(ValueKind::GlobalMemory),
     _parent(nullptr),
@@ -53,7 +56,8 @@ ValueTreeNode::ValueTreeNode(GlobalMemoryValueTag, const llvm::GlobalVariable *g
 }
 
 ValueTreeNode::ValueTreeNode(ArgumentMemoryValueTag, const llvm::Argument *argument) noexcept
-  : _type(argument->getType()->getPointerElementType()),
+  : _id(InvalidId),
+    _type(argument->getType()->getPointerElementType()),
     _value(argument),
     _kind(ValueKind::ArgumentMemory),
     _parent(nullptr),
@@ -68,7 +72,8 @@ ValueTreeNode::ValueTreeNode(ArgumentMemoryValueTag, const llvm::Argument *argum
 }
 
 ValueTreeNode::ValueTreeNode(FunctionReturnValueTag, const llvm::Function *function) noexcept
-  : _type(function->getReturnType()),
+  : _id(InvalidId),
+    _type(function->getReturnType()),
     _value(function),
     _kind(ValueKind::FunctionReturnValue),
     _parent(nullptr),
@@ -81,8 +86,26 @@ ValueTreeNode::ValueTreeNode(FunctionReturnValueTag, const llvm::Function *funct
   Initialize();
 }
 
+ValueTreeNode::ValueTreeNode(HeapMemoryValueTag, const llvm::CallInst *heapMemoryAllocator,
+                             const llvm::Type *type) noexcept
+  : _id(InvalidId),
+    _type(type),
+    _value(heapMemoryAllocator),
+    _kind(ValueKind::HeapMemory),
+    _parent(nullptr),
+    _offset(0),
+    _children(),
+    _numPointees(0),
+    _numPointers(0)
+{
+  assert(heapMemoryAllocator && "heapMemoryAllocator cannot be null");
+  assert(type && "type cannot be null");
+  Initialize();
+}
+
 ValueTreeNode::ValueTreeNode(const llvm::Type *type, ValueTreeNode *parent, size_t offset) noexcept
-  : _type(type),
+  : _id(InvalidId),
+    _type(type),
     _value(nullptr),
     _kind(parent->_kind),
     _parent(parent),
@@ -96,6 +119,21 @@ ValueTreeNode::ValueTreeNode(const llvm::Type *type, ValueTreeNode *parent, size
   Initialize();
 }
 
+ValueTreeNode::ValueTreeNode(ValueKind kind, const llvm::Type *type) noexcept
+  : _id(InvalidId),
+    _type(type),
+    _value(nullptr),
+    _kind(kind),
+    _parent(nullptr),
+    _offset(0),
+    _children(),
+    _numPointees(0),
+    _numPointers(0)
+{
+  assert(type && "type cannot be null");
+  Initialize();
+}
+
 void ValueTreeNode::InitializeChildren() noexcept {
   size_t numChildren = 0;
   std::function<const llvm::Type *(size_t)> childTypeGetter;
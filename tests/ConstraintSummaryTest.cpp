@@ -0,0 +1,371 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+#include "llvm-anderson/ConstraintSummary.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "PointsToSolver.h"
+#include "SolverVerifier.h"
+
+namespace {
+
+/**
+ * Both modules share a source file name, so that the local symbols of the summaries match the names of the values in
+ * the linked module.
+ */
+constexpr const char SourceFileName[] = "linked";
+
+/**
+ * Defines `@shared` and reads it after passing a stack object to `@put`, which is defined by `SecondModule`.
+ */
+const char FirstModule[] = R"(
+source_filename = "linked"
+
+%pair = type { i32*, i32* }
+
+@shared = global %pair zeroinitializer
+
+declare void @put(i32*)
+
+define i32* @first() {
+  %o = alloca i32
+  call void @put(i32* %o)
+  %field = getelementptr %pair, %pair* @shared, i64 0, i32 1
+  %v = load i32*, i32** %field
+  ret i32* %v
+}
+)";
+
+/**
+ * Stores the argument of `@put` and the result of `@first` into `@shared`, which is defined by `FirstModule`.
+ */
+const char SecondModule[] = R"(
+source_filename = "linked"
+
+%pair = type { i32*, i32* }
+
+@shared = external global %pair
+
+declare i32* @first()
+
+define void @put(i32* %p) {
+  %field = getelementptr %pair, %pair* @shared, i64 0, i32 1
+  store i32* %p, i32** %field
+  ret void
+}
+
+define i32* @second() {
+  %h = alloca i32
+  call void @put(i32* %h)
+  %r = call i32* @first()
+  %field = getelementptr %pair, %pair* @shared, i64 0, i32 0
+  store i32* %r, i32** %field
+  ret i32* %r
+}
+)";
+
+std::unique_ptr<llvm::Module> ParseModule(const char *source, const char *name, llvm::LLVMContext &context,
+                                          size_t &numFailures) noexcept {
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(source, diagnostic, context);
+  if (!module) {
+    diagnostic.print(name, llvm::errs());
+    ++numFailures;
+  }
+  return module;
+}
+
+/**
+ * Build the summary of the specified module the way `-anderson-summary-out` does.
+ */
+std::unique_ptr<llvm::anderson::ConstraintSummary> BuildSummary(const llvm::Module &module) noexcept {
+  llvm::anderson::PointsToSolver solver { module };
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        llvm::anderson::UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+  solver.AddTrivialPointerAssignments();
+  return llvm::anderson::ConstraintSummary::Build(module, *solver.GetValueTree());
+}
+
+std::string WriteSummary(const llvm::anderson::ConstraintSummary &summary) noexcept {
+  std::string buffer;
+  llvm::raw_string_ostream os { buffer };
+  summary.Write(os);
+  return os.str();
+}
+
+/**
+ * Split the output of `SummaryLinker::Print` into its lines, which are in no particular order.
+ */
+std::set<std::string> SplitLines(llvm::StringRef text) noexcept {
+  llvm::SmallVector<llvm::StringRef, 16> lines;
+  text.split(lines, '\n', -1, false);
+  return { lines.begin(), lines.end() };
+}
+
+std::set<std::string> LinkSummaries(const std::vector<const llvm::anderson::ConstraintSummary *> &summaries) noexcept {
+  llvm::anderson::SummaryLinker linker { };
+  for (auto summary : summaries) {
+    linker.Link(*summary);
+  }
+  linker.Solve();
+
+  std::string output;
+  llvm::raw_string_ostream os { output };
+  linker.Print(os);
+  return SplitLines(os.str());
+}
+
+/**
+ * Name the specified node of a value tree of the linked module like `SummaryLinker::Print` names the nodes of the
+ * linked summaries.
+ */
+std::string GetLinkerName(const llvm::anderson::ValueTreeNode &node) noexcept {
+  if (!node.isRoot()) {
+    return GetLinkerName(*node.parent()) + "[" + std::to_string(node.offset()) + "]";
+  }
+
+  std::string name;
+  switch (node.kind()) {
+    case llvm::anderson::ValueKind::Normal:
+      break;
+    case llvm::anderson::ValueKind::StackMemory:
+      name = "stack:";
+      break;
+    case llvm::anderson::ValueKind::GlobalMemory:
+      name = "global:";
+      break;
+    case llvm::anderson::ValueKind::ArgumentMemory:
+      name = "argmem:";
+      break;
+    case llvm::anderson::ValueKind::FunctionReturnValue:
+      name = "ret:";
+      break;
+    case llvm::anderson::ValueKind::HeapMemory:
+      name = "heap:";
+      break;
+  }
+
+  auto value = node.value();
+  if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+    return name + arg->getParent()->getName().str() + "#" + std::to_string(arg->getArgNo());
+  }
+  if (auto inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+    return name + SourceFileName + ":" + inst->getFunction()->getName().str() + "/%" + inst->getName().str();
+  }
+  return name + value->getName().str();
+}
+
+/**
+ * Print the solution of the specified value tree in the format of `SummaryLinker::Print`.
+ */
+std::set<std::string> PrintSolution(const llvm::anderson::ValueTree &valueTree) noexcept {
+  std::set<std::string> lines;
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer() || !node->pointer()->GetPointeeSet().size()) {
+      continue;
+    }
+
+    std::set<std::string> pointees;
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      pointees.insert(GetLinkerName(*pointee->node()));
+    }
+
+    auto line = GetLinkerName(*node) + " ->";
+    for (const auto &pointee : pointees) {
+      line += " " + pointee;
+    }
+    lines.insert(std::move(line));
+  }
+  return lines;
+}
+
+/**
+ * Report the lines that appear in only one of the specified outputs.
+ */
+bool CompareLines(const std::set<std::string> &actual, const std::set<std::string> &expected,
+                  const char *name) noexcept {
+  if (actual == expected) {
+    return true;
+  }
+
+  llvm::errs() << "FAIL " << name << "\n";
+  for (const auto &line : actual) {
+    if (!expected.count(line)) {
+      llvm::errs() << "  extra:   " << line << "\n";
+    }
+  }
+  for (const auto &line : expected) {
+    if (!actual.count(line)) {
+      llvm::errs() << "  missing: " << line << "\n";
+    }
+  }
+  return false;
+}
+
+/**
+ * Write the specified module as bitcode, load it back lazily and check that the summary built one function at a time
+ * links to the same solution as the summary built from the whole module.
+ */
+std::unique_ptr<llvm::anderson::ConstraintSummary> CheckBuildLazily(const llvm::Module &module,
+                                                                   const llvm::anderson::ConstraintSummary &summary,
+                                                                   const char *name, size_t &numRuns,
+                                                                   size_t &numFailures) noexcept {
+  ++numRuns;
+  std::string bitcode;
+  {
+    llvm::raw_string_ostream os { bitcode };
+    llvm::WriteBitcodeToFile(module, os);
+  }
+
+  // The summary refers to no IR, so it outlives the lazily loaded module.
+  llvm::LLVMContext context;
+  auto lazyModule = llvm::getLazyBitcodeModule(llvm::MemoryBufferRef { bitcode, name }, context);
+  if (!lazyModule) {
+    llvm::errs() << "FAIL " << name << "/lazy: " << llvm::toString(lazyModule.takeError()) << "\n";
+    ++numFailures;
+    return nullptr;
+  }
+
+  auto lazySummary = llvm::anderson::ConstraintSummary::BuildLazily(**lazyModule);
+  if (!lazySummary) {
+    llvm::errs() << "FAIL " << name << "/lazy: the module cannot be materialized\n";
+    ++numFailures;
+    return nullptr;
+  }
+  if (!CompareLines(LinkSummaries({ lazySummary.get() }), LinkSummaries({ &summary }),
+                    (std::string { name } + "/lazy").c_str())) {
+    ++numFailures;
+  }
+  return lazySummary;
+}
+
+/**
+ * Check that writing the specified summary, reading it back and writing it again gives the same bytes, and that
+ * truncated and corrupted copies of the written summary are rejected.
+ */
+void CheckReadWrite(const llvm::anderson::ConstraintSummary &summary, const char *name, size_t &numRuns,
+                    size_t &numFailures) noexcept {
+  auto data = WriteSummary(summary);
+  auto read = [](const std::string &bytes) noexcept {
+    return llvm::anderson::ConstraintSummary::Read(llvm::MemoryBufferRef { bytes, "summary" });
+  };
+
+  ++numRuns;
+  auto roundTrip = read(data);
+  if (!roundTrip || WriteSummary(*roundTrip) != data) {
+    llvm::errs() << "FAIL " << name << "/round_trip\n";
+    ++numFailures;
+    return;
+  }
+
+  ++numRuns;
+  for (size_t size = 0; size < data.size(); ++size) {
+    if (read(data.substr(0, size))) {
+      llvm::errs() << "FAIL " << name << "/truncated: a summary truncated to " << size << " bytes is accepted\n";
+      ++numFailures;
+      break;
+    }
+  }
+
+  // The header is an 8 byte magic, a 4 byte version and 4 reserved bytes, followed by the count of the shapes and
+  // the kind of the first shape. The last constraint is a kind byte, the 4 byte root and 8 byte offset of the pointer
+  // and of the operand, and the 4 byte count of its 8 byte indexes.
+  const size_t typeCountOffset = 16;
+  const size_t firstTypeOffset = typeCountOffset + 8;
+  const size_t lastConstraintOffset =
+      data.size() - (1 + 12 + 12 + 4 + 8 * summary.constraints().back().indexSequence.size());
+  struct Corruption {
+    const char *name;
+    size_t offset;
+    std::string bytes;
+  };
+  const Corruption corruptions[] = {
+    { "magic", 0, "X" },
+    { "version", 8, std::string(4, '\xff') },
+    { "type_count", typeCountOffset, std::string(8, '\xff') },
+    { "type_kind", firstTypeOffset, "\xff" },
+    { "constraint_kind", lastConstraintOffset, "\xff" },
+    { "constraint_root", lastConstraintOffset + 1, std::string(4, '\xff') },
+    { "constraint_offset", lastConstraintOffset + 5, std::string(8, '\xff') },
+  };
+  for (const auto &corruption : corruptions) {
+    ++numRuns;
+    auto corrupted = data;
+    corrupted.replace(corruption.offset, corruption.bytes.size(), corruption.bytes);
+    if (read(corrupted)) {
+      llvm::errs() << "FAIL " << name << "/corrupt_" << corruption.name << ": the corrupted summary is accepted\n";
+      ++numFailures;
+    }
+  }
+
+  ++numRuns;
+  if (read(data + '\0')) {
+    llvm::errs() << "FAIL " << name << "/trailing_bytes: the summary with trailing bytes is accepted\n";
+    ++numFailures;
+  }
+}
+
+} // namespace <anonymous>
+
+int main() {
+  size_t numFailures = 0;
+  size_t numRuns = 0;
+
+  llvm::LLVMContext context;
+  auto firstModule = ParseModule(FirstModule, "first", context, numFailures);
+  auto secondModule = ParseModule(SecondModule, "second", context, numFailures);
+  if (firstModule && secondModule) {
+    auto firstSummary = BuildSummary(*firstModule);
+    auto secondSummary = BuildSummary(*secondModule);
+    CheckReadWrite(*firstSummary, "first", numRuns, numFailures);
+    CheckReadWrite(*secondSummary, "second", numRuns, numFailures);
+
+    auto firstLazySummary = CheckBuildLazily(*firstModule, *firstSummary, "first", numRuns, numFailures);
+    auto secondLazySummary = CheckBuildLazily(*secondModule, *secondSummary, "second", numRuns, numFailures);
+
+    // Link the summaries, then link the IR and solve the linked module as a whole.
+    auto linked = LinkSummaries({ firstSummary.get(), secondSummary.get() });
+    if (firstLazySummary && secondLazySummary) {
+      ++numRuns;
+      if (!CompareLines(LinkSummaries({ firstLazySummary.get(), secondLazySummary.get() }), linked, "link_lazy")) {
+        ++numFailures;
+      }
+    }
+    ++numRuns;
+    if (llvm::Linker::linkModules(*firstModule, std::move(secondModule))) {
+      llvm::errs() << "FAIL link: the modules cannot be linked\n";
+      ++numFailures;
+    } else if (!CompareLines(linked, PrintSolution(*llvm::anderson::SolveReference(*firstModule)), "link")) {
+      ++numFailures;
+    }
+  }
+
+  llvm::outs() << numRuns - numFailures << " of " << numRuns << " summary checks pass\n";
+  return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "PointsToSolver.h"
+#include "SolutionCache.h"
+#include "SolverVerifier.h"
+
+namespace {
+
+/**
+ * Pointers stored into a struct and into a heap object, in a function reachable from `@main` and in one that is not.
+ */
+const char CachedModule[] = R"(
+%pair = type { i32*, i32* }
+
+declare i8* @malloc(i64)
+
+define i32* @main() {
+  %o = alloca i32
+  %s = alloca %pair
+  %first = getelementptr %pair, %pair* %s, i64 0, i32 0
+  store i32* %o, i32** %first
+  %h = call i8* @malloc(i64 8)
+  %slot = bitcast i8* %h to i32**
+  store i32* %o, i32** %slot
+  %v = load i32*, i32** %slot
+  ret i32* %v
+}
+
+define i32* @unused(%pair* %p) {
+  %second = getelementptr %pair, %pair* %p, i64 0, i32 1
+  %v = load i32*, i32** %second
+  ret i32* %v
+}
+)";
+
+/**
+ * `CachedModule` with the object stored into the second field of the struct.
+ */
+const char ChangedModule[] = R"(
+%pair = type { i32*, i32* }
+
+declare i8* @malloc(i64)
+
+define i32* @main() {
+  %o = alloca i32
+  %s = alloca %pair
+  %first = getelementptr %pair, %pair* %s, i64 0, i32 1
+  store i32* %o, i32** %first
+  %h = call i8* @malloc(i64 8)
+  %slot = bitcast i8* %h to i32**
+  store i32* %o, i32** %slot
+  %v = load i32*, i32** %slot
+  ret i32* %v
+}
+
+define i32* @unused(%pair* %p) {
+  %second = getelementptr %pair, %pair* %p, i64 0, i32 1
+  %v = load i32*, i32** %second
+  ret i32* %v
+}
+)";
+
+/**
+ * `CachedModule` with a field appended to the struct body, leaving every instruction unchanged.
+ */
+const char ChangedStructModule[] = R"(
+%pair = type { i32*, i32*, i64 }
+
+declare i8* @malloc(i64)
+
+define i32* @main() {
+  %o = alloca i32
+  %s = alloca %pair
+  %first = getelementptr %pair, %pair* %s, i64 0, i32 0
+  store i32* %o, i32** %first
+  %h = call i8* @malloc(i64 8)
+  %slot = bitcast i8* %h to i32**
+  store i32* %o, i32** %slot
+  %v = load i32*, i32** %slot
+  ret i32* %v
+}
+
+define i32* @unused(%pair* %p) {
+  %second = getelementptr %pair, %pair* %p, i64 0, i32 1
+  %v = load i32*, i32** %second
+  ret i32* %v
+}
+)";
+
+/**
+ * Set the options that change the solution as if they were given on the command line.
+ */
+void SetOptions(const std::vector<const char *> &options) noexcept {
+  llvm::cl::ResetAllOptionOccurrences();
+  std::vector<const char *> argv { "llvm-anderson-cache-test" };
+  argv.insert(argv.end(), options.begin(), options.end());
+  llvm::cl::ParseCommandLineOptions(static_cast<int>(argv.size()), argv.data());
+}
+
+std::unique_ptr<llvm::Module> ParseModule(const char *source, const char *name, llvm::LLVMContext &context,
+                                          size_t &numFailures) noexcept {
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(source, diagnostic, context);
+  if (!module) {
+    diagnostic.print(name, llvm::errs());
+    ++numFailures;
+  }
+  return module;
+}
+
+/**
+ * Store the reference solution of the specified module under the key of the requested options, then check that it
+ * is read back into a fresh value tree and agrees with a fresh solve.
+ */
+void CheckRoundTrip(const llvm::anderson::SolutionCache &cache, const llvm::Module &module, const char *name,
+                    size_t &numRuns, size_t &numFailures) noexcept {
+  ++numRuns;
+  auto key = llvm::anderson::SolutionCache::ComputeKey(module, llvm::anderson::GetRequestedConfiguration());
+  cache.Store(key, *llvm::anderson::SolveReference(module));
+
+  auto loaded = llvm::anderson::CreateRequestedValueTree(module);
+  if (!cache.Load(key, *loaded)) {
+    llvm::errs() << "FAIL " << name << ": the stored entry is not found\n";
+    ++numFailures;
+    return;
+  }
+  if (!llvm::anderson::VerifySolution(module, *loaded, *llvm::anderson::SolveReference(module), llvm::errs())) {
+    llvm::errs() << "FAIL " << name << ": the loaded solution differs from a fresh solve\n";
+    ++numFailures;
+  }
+}
+
+/**
+ * Check that the specified module misses the cache under the requested options.
+ */
+void CheckMiss(const llvm::anderson::SolutionCache &cache, const llvm::Module &module, const std::string &cachedKey,
+               const char *name, size_t &numRuns, size_t &numFailures) noexcept {
+  ++numRuns;
+  auto key = llvm::anderson::SolutionCache::ComputeKey(module, llvm::anderson::GetRequestedConfiguration());
+  if (key == cachedKey) {
+    llvm::errs() << "FAIL " << name << ": the key does not change\n";
+    ++numFailures;
+    return;
+  }
+  auto valueTree = llvm::anderson::CreateRequestedValueTree(module);
+  if (cache.Load(key, *valueTree)) {
+    llvm::errs() << "FAIL " << name << ": the cache hits\n";
+    ++numFailures;
+  }
+}
+
+/**
+ * Check that a solution marked by the specified function is not stored.
+ */
+void CheckNotStored(const llvm::anderson::SolutionCache &cache, const llvm::Module &module,
+                    void (*mark)(llvm::anderson::ValueTree &valueTree) noexcept, const char *name,
+                    size_t &numRuns, size_t &numFailures) noexcept {
+  ++numRuns;
+  auto key = llvm::anderson::SolutionCache::ComputeKey(module, llvm::anderson::GetRequestedConfiguration());
+  auto valueTree = llvm::anderson::SolveReference(module);
+  mark(*valueTree);
+  cache.Store(key, *valueTree);
+
+  auto loaded = llvm::anderson::CreateRequestedValueTree(module);
+  if (cache.Load(key, *loaded)) {
+    llvm::errs() << "FAIL " << name << ": the solution is stored\n";
+    ++numFailures;
+  }
+}
+
+void MarkDegraded(llvm::anderson::ValueTree &valueTree) noexcept {
+  valueTree.MarkDegraded();
+}
+
+void MarkApproximate(llvm::anderson::ValueTree &valueTree) noexcept {
+  valueTree.MarkApproximate();
+}
+
+} // namespace <anonymous>
+
+int main() {
+  size_t numFailures = 0;
+  size_t numRuns = 0;
+
+  llvm::SmallString<128> directory;
+  if (auto ec = llvm::sys::fs::createUniqueDirectory("llvm-anderson-cache-test", directory)) {
+    llvm::errs() << "cannot create the cache directory: " << ec.message() << "\n";
+    return 1;
+  }
+  llvm::anderson::SolutionCache cache { std::string { directory.str() }, llvm::CachePruningPolicy { } };
+
+  // Each module gets its own context, so that the struct types keep their names.
+  llvm::LLVMContext context;
+  llvm::LLVMContext changedContext;
+  llvm::LLVMContext changedStructContext;
+  auto module = ParseModule(CachedModule, "cached", context, numFailures);
+  auto changedModule = ParseModule(ChangedModule, "changed", changedContext, numFailures);
+  auto changedStructModule = ParseModule(ChangedStructModule, "changed_struct", changedStructContext, numFailures);
+  if (module && changedModule && changedStructModule) {
+    SetOptions({ });
+    CheckRoundTrip(cache, *module, "round_trip", numRuns, numFailures);
+    auto cachedKey = llvm::anderson::SolutionCache::ComputeKey(*module, llvm::anderson::GetRequestedConfiguration());
+
+    CheckMiss(cache, *changedModule, cachedKey, "changed_module", numRuns, numFailures);
+    CheckMiss(cache, *changedStructModule, cachedKey, "changed_struct", numRuns, numFailures);
+
+    SetOptions({ "-anderson-type-filter=strict" });
+    CheckMiss(cache, *module, cachedKey, "type_filter", numRuns, numFailures);
+    SetOptions({ "-anderson-entry-points=main" });
+    CheckMiss(cache, *module, cachedKey, "entry_points", numRuns, numFailures);
+    CheckRoundTrip(cache, *module, "entry_points_round_trip", numRuns, numFailures);
+    SetOptions({ "-anderson-default-summaries=false" });
+    CheckMiss(cache, *module, cachedKey, "summaries", numRuns, numFailures);
+    CheckRoundTrip(cache, *module, "summaries_round_trip", numRuns, numFailures);
+
+    SetOptions({ });
+    CheckNotStored(cache, *changedModule, MarkDegraded, "degraded", numRuns, numFailures);
+    CheckNotStored(cache, *changedStructModule, MarkApproximate, "approximate", numRuns, numFailures);
+  }
+
+  llvm::sys::fs::remove_directories(directory);
+
+  llvm::outs() << numRuns - numFailures << " of " << numRuns << " cache checks pass\n";
+  return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1066 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonAliasAnalysis.h"
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+#include "llvm-anderson/DemandDrivenAnalysis.h"
+#include "llvm-anderson/PointsToQuery.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/MemoryLocation.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/IR/ValueSymbolTable.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "DependencyIndex.h"
+#include "IncrementalSolver.h"
+#include "PointsToSolver.h"
+#include "Reachability.h"
+#include "SolverVerifier.h"
+#include "SyntheticModules.h"
+
+namespace {
+
+using llvm::anderson::benchmarks::ModuleGenerator;
+
+/**
+ * A way of solving a module other than the reference solver.
+ */
+struct Configuration {
+  const char *name;
+  std::unique_ptr<llvm::anderson::ValueTree> (*solve)(const llvm::Module &module) noexcept;
+};
+
+struct Shape {
+  const char *name;
+  ModuleGenerator generator;
+};
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklist(const llvm::Module &module,
+                                                         llvm::anderson::WorklistOrder order) noexcept {
+  llvm::anderson::PointsToSolver solver { module };
+  solver.SetWorklistOrder(order);
+  solver.AddTrivialPointerAssignments();
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        llvm::anderson::UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+
+  llvm::anderson::DependencyIndex dependencies;
+  dependencies.Build(*solver.GetValueTree());
+  solver.SetDependencyIndex(&dependencies);
+  solver.GetValueTree()->Visit([&solver](llvm::anderson::ValueTreeNode &node) noexcept -> bool {
+    if (node.isPointer()) {
+      solver.Enqueue(node.pointer());
+    }
+    return true;
+  });
+  solver.SolveWorklist();
+  solver.SetDependencyIndex(nullptr);
+  return solver.TakeValueTree();
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklistFifo(const llvm::Module &module) noexcept {
+  return SolveWorklist(module, llvm::anderson::WorklistOrder::Fifo);
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklistLifo(const llvm::Module &module) noexcept {
+  return SolveWorklist(module, llvm::anderson::WorklistOrder::Lifo);
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklistLrf(const llvm::Module &module) noexcept {
+  return SolveWorklist(module, llvm::anderson::WorklistOrder::Lrf);
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklistTopological(const llvm::Module &module) noexcept {
+  return SolveWorklist(module, llvm::anderson::WorklistOrder::Topological);
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolveWorklistTwoPhase(const llvm::Module &module) noexcept {
+  return SolveWorklist(module, llvm::anderson::WorklistOrder::TwoPhase);
+}
+
+std::unique_ptr<llvm::anderson::ValueTree> SolvePartitioned(const llvm::Module &module) noexcept {
+  llvm::anderson::PointsToSolver solver { module };
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        llvm::anderson::UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+  solver.SolvePartitioned();
+  return solver.TakeValueTree();
+}
+
+const Configuration Configurations[] = {
+  { "worklist", SolveWorklistFifo },
+  { "worklist_lifo", SolveWorklistLifo },
+  { "worklist_lrf", SolveWorklistLrf },
+  { "worklist_topological", SolveWorklistTopological },
+  { "worklist_two_phase", SolveWorklistTwoPhase },
+  { "partitioned", SolvePartitioned },
+};
+
+const Shape Shapes[] = {
+  { "copy_chain", llvm::anderson::benchmarks::GenerateCopyChain },
+  { "copy_cycle", llvm::anderson::benchmarks::GenerateCopyCycle },
+  { "deep_struct", llvm::anderson::benchmarks::GenerateDeepStruct },
+  { "dynamic_array", llvm::anderson::benchmarks::GenerateDynamicArray },
+  { "load_store_web", llvm::anderson::benchmarks::GenerateLoadStoreWeb },
+  { "type_punning", llvm::anderson::benchmarks::GenerateTypePunning },
+};
+
+const size_t Sizes[] = { 1, 2, 3, 7, 16, 61, 128 };
+
+/**
+ * Exploration budget of the demand-driven queries that must be answered completely.
+ */
+constexpr size_t UnboundedBudget = std::numeric_limits<size_t>::max();
+
+/**
+ * Exploration budgets of the demand-driven queries that may be answered as incomplete. They run out at different points
+ * of the exploration: before the operands of a pointer, among the stores, or among the operands of the stores.
+ */
+const size_t SmallBudgets[] = { 1, 2, 3, 5, 8 };
+
+/**
+ * Largest module size whose pointers are all queried one at a time, since every query scans the explored region.
+ */
+constexpr size_t MaxDemandDrivenSize = 16;
+
+/**
+ * Largest module size whose alias matrix is checked against the pairwise alias queries, which are quadratic in the
+ * number of pointer values.
+ */
+constexpr size_t MaxAliasMatrixSize = 61;
+
+/**
+ * Smallest module size that is stopped early by the budget and by cancellation, since smaller modules may reach the
+ * fixpoint before the solver first checks the budget.
+ */
+constexpr size_t MinStoppedSolveSize = 128;
+
+/**
+ * Stores through a loaded pointer and through a chain of casts, which the loads from the stored-to memory depend on.
+ */
+const char DemandDrivenModule[] = R"(
+define i32* @f() {
+  %o = alloca i32
+  %x = alloca i32*
+  %px = alloca i32**
+  store i32** %x, i32*** %px
+  %q = load i32**, i32*** %px
+  store i32* %o, i32** %q
+  %y = alloca i32*
+  %c1 = bitcast i32** %y to i8*
+  %c2 = bitcast i8* %c1 to i32**
+  %c3 = bitcast i32** %c2 to i8*
+  %c4 = bitcast i8* %c3 to i32**
+  store i32* %o, i32** %c4
+  %v = load i32*, i32** %x
+  %w = load i32*, i32** %y
+  ret i32* %w
+}
+)";
+/**
+ * Stores through pointers that reach the stored-to object through memory, a call and a return, next to a store to an
+ * object that the load from `%x` does not depend on.
+ */
+const char InterproceduralStoresModule[] = R"(
+define void @set(i32** %p, i32* %v) {
+  store i32* %v, i32** %p
+  ret void
+}
+
+define i32** @id(i32** %p) {
+  ret i32** %p
+}
+
+define i32* @f() {
+  %o = alloca i32
+  %x = alloca i32*
+  %slot = alloca i32**
+  store i32** %x, i32*** %slot
+  %y = load i32**, i32*** %slot
+  %z = call i32** @id(i32** %y)
+  call void @set(i32** %z, i32* %o)
+  %unrelated = alloca i32*
+  %u = getelementptr i32*, i32** %unrelated, i64 0
+  store i32* %o, i32** %u
+  %w = load i32*, i32** %x
+  ret i32* %w
+}
+)";
+
+/**
+ * Pointers copied by `memcpy` into an object whose address reaches the call through a parameter, from an object whose
+ * address is loaded from memory.
+ */
+const char MemoryCopiesModule[] = R"(
+declare i8* @memcpy(i8*, i8*, i64)
+
+define void @copy(i8* %dst, i8* %src) {
+  %r = call i8* @memcpy(i8* %dst, i8* %src, i64 16)
+  ret void
+}
+
+define i32* @f() {
+  %o = alloca i32
+  %src = alloca [2 x i32*]
+  %dst = alloca [2 x i32*]
+  %slot = alloca i8*
+  %e1 = getelementptr [2 x i32*], [2 x i32*]* %src, i64 0, i64 1
+  store i32* %o, i32** %e1
+  %s = bitcast [2 x i32*]* %src to i8*
+  store i8* %s, i8** %slot
+  %l = load i8*, i8** %slot
+  %d = bitcast [2 x i32*]* %dst to i8*
+  call void @copy(i8* %d, i8* %l)
+  %d1 = getelementptr [2 x i32*], [2 x i32*]* %dst, i64 0, i64 1
+  %w = load i32*, i32** %d1
+  ret i32* %w
+}
+)";
+
+/**
+ * Collect the values of the specified module that have nodes in the specified value tree and are pointers.
+ */
+std::vector<const llvm::Value *> CollectPointerValues(const llvm::Module &module,
+                                                      const llvm::anderson::ValueTree &valueTree) noexcept {
+  std::vector<const llvm::Value *> values;
+  auto add = [&values, &valueTree](const llvm::Value *value) noexcept {
+    auto node = valueTree.GetValueNode(value);
+    if (node && node->isPointer()) {
+      values.push_back(value);
+    }
+  };
+
+  for (const auto &globalVariable : module.globals()) {
+    add(&globalVariable);
+  }
+  for (const auto &function : module) {
+    add(&function);
+    for (const auto &arg : function.args()) {
+      add(&arg);
+    }
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        add(&inst);
+      }
+    }
+  }
+  return values;
+}
+
+std::set<std::string> GetPointeeNames(const llvm::anderson::PointeeSet &pointees,
+                                      llvm::ModuleSlotTracker &slotTracker) noexcept {
+  std::set<std::string> names;
+  for (auto pointee : pointees) {
+    names.insert(llvm::anderson::GetNodeName(*pointee->node(), slotTracker));
+  }
+  return names;
+}
+
+/**
+ * Query every pointer value of the specified module, one at a time, with the specified budget, and check that every
+ * answer reported as complete equals the reference solution.
+ *
+ * With an unbounded budget, all queries go to the same analysis, so that later queries reuse the explored region. With
+ * a small budget, every query goes to a fresh analysis, so that the budget runs out at a different point for each.
+ *
+ * @return whether every complete answer equals the reference solution, and every query with an unbounded budget is
+ * answered completely.
+ */
+bool CheckDemandDrivenQueries(const llvm::Module &module, const llvm::anderson::ValueTree &reference,
+                              size_t budget) noexcept {
+  llvm::ModuleSlotTracker slotTracker { &module };
+  std::unique_ptr<llvm::anderson::DemandDrivenAnalysis> analysis;
+  auto agrees = true;
+  for (auto value : CollectPointerValues(module, reference)) {
+    if (!analysis || budget != UnboundedBudget) {
+      analysis = std::make_unique<llvm::anderson::DemandDrivenAnalysis>(module);
+    }
+    auto complete = analysis->Query({ value }, budget);
+    auto pointees = analysis->GetPointeeSet(value);
+    auto name = llvm::anderson::GetNodeName(*reference.GetValueNode(value), slotTracker);
+    if (complete != (pointees != nullptr) || (!complete && budget == UnboundedBudget)) {
+      llvm::errs() << "  " << name << (complete ? " is reported complete without an answer" : " is incomplete")
+                   << "\n";
+      agrees = false;
+      continue;
+    }
+    if (!pointees) {
+      continue;
+    }
+
+    auto expected = GetPointeeNames(reference.GetValueNode(value)->pointer()->GetPointeeSet(), slotTracker);
+    if (GetPointeeNames(*pointees, slotTracker) != expected) {
+      llvm::errs() << "  " << name << " differs from the reference solution\n";
+      agrees = false;
+    }
+  }
+  return agrees;
+}
+
+/**
+ * Check that the last pointer in the specified module that is not an `alloca` cannot be answered completely with the
+ * smallest budget. Modules without such a pointer pass trivially.
+ */
+bool CheckDemandDrivenBudget(const llvm::Module &module, const llvm::anderson::ValueTree &reference) noexcept {
+  const llvm::Value *last = nullptr;
+  for (auto value : CollectPointerValues(module, reference)) {
+    if (llvm::isa<llvm::Instruction>(value) && !llvm::isa<llvm::AllocaInst>(value)) {
+      last = value;
+    }
+  }
+  if (!last) {
+    return true;
+  }
+
+  llvm::anderson::DemandDrivenAnalysis analysis { module };
+  return !analysis.Query({ last }, SmallBudgets[0]) && !analysis.GetPointeeSet(last);
+}
+
+/**
+ * Check that a query of the load from `%x` in `InterproceduralStoresModule` is answered without exploring the pointer
+ * that `%unrelated` is stored to through.
+ */
+bool CheckDemandDrivenStoreScope(const llvm::Module &module) noexcept {
+  auto symbols = module.getFunction("f")->getValueSymbolTable();
+  llvm::anderson::DemandDrivenAnalysis analysis { module };
+  return analysis.Query({ symbols->lookup("w") }, UnboundedBudget) && !analysis.GetPointeeSet(symbols->lookup("u"));
+}
+
+/**
+ * Check the demand-driven analysis of the specified module against the reference solution with every budget, and if
+ * `checkBudget` is set, that the smallest budget leaves some query incomplete.
+ */
+void CheckDemandDriven(const llvm::Module &module, const llvm::anderson::ValueTree &reference, const std::string &name,
+                       bool checkBudget, size_t &numRuns, size_t &numFailures) noexcept {
+  ++numRuns;
+  if (!CheckDemandDrivenQueries(module, reference, UnboundedBudget)) {
+    llvm::errs() << "FAIL demand_driven/unbounded on " << name << "\n";
+    ++numFailures;
+  }
+  for (auto budget : SmallBudgets) {
+    ++numRuns;
+    if (!CheckDemandDrivenQueries(module, reference, budget)) {
+      llvm::errs() << "FAIL demand_driven/" << budget << " on " << name << "\n";
+      ++numFailures;
+    }
+  }
+
+  if (!checkBudget) {
+    return;
+  }
+  ++numRuns;
+  if (!CheckDemandDrivenBudget(module, reference)) {
+    llvm::errs() << "FAIL demand_driven/budget on " << name << ": the smallest budget answers completely\n";
+    ++numFailures;
+  }
+}
+
+/**
+ * A pointer to a struct and a pointer to one of its fields, a pointer to another object, and a pointer converted from an
+ * integer, which has no pointees.
+ */
+const char QueryModule[] = R"(
+define void @f(i64 %n) {
+  %s = alloca { i32, i32 }
+  %o = alloca i32
+  %field = getelementptr { i32, i32 }, { i32, i32 }* %s, i32 0, i32 1
+  store i32 0, i32* %field
+  store i32 0, i32* %o
+  %int = inttoptr i64 %n to i32*
+  store i32 0, i32* %int
+  ret void
+}
+)";
+
+/**
+ * Check the alias queries of a `PointsToQuery` snapshot of `QueryModule`.
+ */
+void CheckPointsToQuery(size_t &numRuns, size_t &numFailures) noexcept {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(QueryModule, diagnostic, context);
+  if (!module) {
+    diagnostic.print("points_to_query", llvm::errs());
+    ++numFailures;
+    return;
+  }
+
+  auto reference = llvm::anderson::SolveReference(*module);
+  auto query = llvm::anderson::PointsToQuery::Build(*reference);
+  auto symbols = module->getFunction("f")->getValueSymbolTable();
+  auto s = symbols->lookup("s");
+  auto o = symbols->lookup("o");
+  auto field = symbols->lookup("field");
+  auto integer = symbols->lookup("int");
+
+  struct Expectation {
+    const char *name;
+    bool actual;
+    bool expected;
+  };
+  const Expectation expectations[] = {
+    { "struct/field", query->MayAlias(s, field), true },
+    { "struct/other", query->MayAlias(s, o), false },
+    { "field/other", query->MayAlias(field, o), false },
+    { "struct/empty", query->MayAlias(s, integer), true },
+  };
+  for (const auto &expectation : expectations) {
+    ++numRuns;
+    if (expectation.actual != expectation.expected) {
+      llvm::errs() << "FAIL points_to_query/" << expectation.name << ": MayAlias returned " << expectation.actual
+                   << "\n";
+      ++numFailures;
+    }
+  }
+}
+
+/**
+ * A pointer stored into and loaded back from cells accessed through casts to `i8**`: an integer, a struct that starts
+ * with a pointer, and a struct that starts with an integer.
+ */
+const char CastCellsModule[] = R"(
+define void @f() {
+  %o = alloca i8
+  %int = alloca i64
+  %intSlot = bitcast i64* %int to i8**
+  store i8* %o, i8** %intSlot
+  %fromInt = load i8*, i8** %intSlot
+  %head = alloca { i8*, i32 }
+  %headSlot = bitcast { i8*, i32 }* %head to i8**
+  store i8* %o, i8** %headSlot
+  %fromHead = load i8*, i8** %headSlot
+  %tail = alloca { i32, i8* }
+  %tailSlot = bitcast { i32, i8* }* %tail to i8**
+  store i8* %o, i8** %tailSlot
+  %fromTail = load i8*, i8** %tailSlot
+  ret void
+}
+)";
+
+/**
+ * Check that every solver accesses the cells of `CastCellsModule` at their first scalar element: the pointer stored
+ * into the struct that starts with a pointer is loaded back, and the cells that cannot hold a pointer there are skipped,
+ * so that the pointer is neither stored into them nor loaded from them.
+ */
+void CheckCastCells(size_t &numRuns, size_t &numFailures) noexcept {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(CastCellsModule, diagnostic, context);
+  if (!module) {
+    diagnostic.print("cast_cells", llvm::errs());
+    ++numFailures;
+    return;
+  }
+
+  struct Expectation {
+    const char *value;
+    std::set<std::string> pointees;
+  };
+  const Expectation expectations[] = {
+    { "intSlot", { "stack:f.%int" } },
+    { "fromInt", { } },
+    { "headSlot", { "stack:f.%head" } },
+    { "fromHead", { "stack:f.%o" } },
+    { "tailSlot", { "stack:f.%tail" } },
+    { "fromTail", { } },
+  };
+
+  llvm::ModuleSlotTracker slotTracker { module.get() };
+  auto symbols = module->getFunction("f")->getValueSymbolTable();
+  auto check = [&](const char *solverName, const llvm::anderson::ValueTree &valueTree) noexcept {
+    ++numRuns;
+    for (const auto &expectation : expectations) {
+      auto node = valueTree.GetValueNode(symbols->lookup(expectation.value));
+      auto pointees = GetPointeeNames(node->pointer()->GetPointeeSet(), slotTracker);
+      if (pointees != expectation.pointees) {
+        llvm::errs() << "FAIL cast_cells/" << solverName << ": unexpected pointees of %" << expectation.value << "\n";
+        ++numFailures;
+        return;
+      }
+    }
+
+    // The pointer lands in the first field of the struct that starts with a pointer, and not in the pointer field of the
+    // struct that starts with an integer.
+    auto head = valueTree.GetAllocaMemoryNode(llvm::cast<llvm::AllocaInst>(symbols->lookup("head")))->GetChild(0);
+    auto tail = valueTree.GetAllocaMemoryNode(llvm::cast<llvm::AllocaInst>(symbols->lookup("tail")))->GetChild(1);
+    if (GetPointeeNames(head->pointer()->GetPointeeSet(), slotTracker) != std::set<std::string> { "stack:f.%o" } ||
+        tail->pointer()->GetPointeeSet().size() != 0) {
+      llvm::errs() << "FAIL cast_cells/" << solverName << ": unexpected pointees of the struct fields\n";
+      ++numFailures;
+    }
+  };
+
+  check("reference", *llvm::anderson::SolveReference(*module));
+  for (const auto &configuration : Configurations) {
+    check(configuration.name, *configuration.solve(*module));
+  }
+}
+
+/**
+ * Records the phases reported by the solver, and cancels a token once solving starts if one is given.
+ */
+class PhaseRecorder : public llvm::anderson::SolverProgressObserver {
+public:
+  explicit PhaseRecorder(llvm::anderson::CancellationToken *cancellation) noexcept
+    : _cancellation(cancellation),
+      _phases()
+  { }
+
+  void OnProgress(const llvm::anderson::SolverProgress &progress) noexcept override {
+    _phases.push_back(progress.phase);
+    if (_cancellation && progress.phase == llvm::anderson::SolverPhase::Solve) {
+      _cancellation->Cancel();
+    }
+  }
+
+  const std::vector<llvm::anderson::SolverPhase>& phases() const noexcept {
+    return _phases;
+  }
+
+private:
+  llvm::anderson::CancellationToken *_cancellation;
+  std::vector<llvm::anderson::SolverPhase> _phases;
+};
+
+/**
+ * Ways of stopping the solver before it reaches the fixpoint.
+ */
+enum class StopReason {
+  MemoryBudget,
+  CancelledBeforeSolving,
+  CancelledWhileSolving,
+};
+
+/**
+ * Stop the solver early on the specified module and check that the solution is degraded, that every pointer whose set
+ * differs from the reference is marked as unknown, and that the observer receives a single `Done` report at the end.
+ */
+void CheckStoppedSolve(const llvm::Module &module, const llvm::anderson::ValueTree &reference, const std::string &name,
+                       size_t &numRuns, size_t &numFailures) noexcept {
+  const std::pair<const char *, llvm::anderson::SolverMode> modes[] = {
+    { "exhaustive", llvm::anderson::SolverMode::Exhaustive },
+    { "worklist", llvm::anderson::SolverMode::Worklist },
+  };
+  const std::pair<const char *, StopReason> reasons[] = {
+    { "memory_budget", StopReason::MemoryBudget },
+    { "cancelled_before_solving", StopReason::CancelledBeforeSolving },
+    { "cancelled_while_solving", StopReason::CancelledWhileSolving },
+  };
+
+  for (const auto &mode : modes) {
+    for (const auto &reason : reasons) {
+      ++numRuns;
+      auto runName = name + "/" + mode.first + "/" + reason.first;
+
+      llvm::anderson::CancellationToken cancellation;
+      PhaseRecorder recorder { reason.second == StopReason::CancelledWhileSolving ? &cancellation : nullptr };
+      llvm::anderson::PointsToSolver solver { module };
+      for (const auto &function : module) {
+        for (const auto &bb : function) {
+          for (const auto &inst : bb) {
+            llvm::anderson::UpdateAndersonSolverOnInst(solver, inst);
+          }
+        }
+      }
+      if (reason.second == StopReason::MemoryBudget) {
+        // Any growth of the heap exceeds the budget at the first check.
+        llvm::anderson::SolverBudget budget;
+        budget.memory = 1;
+        solver.SetBudget(budget);
+      } else {
+        solver.SetCancellationToken(&cancellation);
+      }
+      if (reason.second == StopReason::CancelledBeforeSolving) {
+        cancellation.Cancel();
+      }
+      solver.SetProgressObserver(&recorder);
+      solver.Solve(mode.second);
+      solver.SetProgressObserver(nullptr);
+      auto valueTree = solver.TakeValueTree();
+
+      size_t numUnknown = 0;
+      valueTree->Visit([&numUnknown](llvm::anderson::ValueTreeNode &node) noexcept -> bool {
+        if (node.isPointer() && node.pointer()->isUnknown()) {
+          ++numUnknown;
+        }
+        return true;
+      });
+      const auto &phases = recorder.phases();
+      if (!valueTree->isDegraded() || numUnknown == 0) {
+        llvm::errs() << "FAIL " << runName << ": the solver is not stopped\n";
+        ++numFailures;
+      } else if (!llvm::anderson::VerifySolution(module, *valueTree, reference, llvm::errs())) {
+        llvm::errs() << "FAIL " << runName << ": an incomplete points-to set is not marked as unknown\n";
+        ++numFailures;
+      } else if (phases.empty() || phases.back() != llvm::anderson::SolverPhase::Done ||
+                 std::count(phases.begin(), phases.end(), llvm::anderson::SolverPhase::Done) != 1) {
+        llvm::errs() << "FAIL " << runName << ": the observer does not receive a single final done report\n";
+        ++numFailures;
+      }
+    }
+  }
+}
+
+/**
+ * Check that the alias matrix and the alias classes of the pointer values in the specified module agree with the
+ * pairwise alias queries answered from the same solution.
+ */
+void CheckAliasMatrix(const llvm::Module &module, const llvm::anderson::ValueTree &reference, const std::string &name,
+                      size_t &numRuns, size_t &numFailures) noexcept {
+  std::vector<const llvm::Value *> pointers;
+  for (const auto &globalVariable : module.globals()) {
+    pointers.push_back(&globalVariable);
+  }
+  for (const auto &function : module) {
+    for (const auto &arg : function.args()) {
+      if (arg.getType()->isPointerTy()) {
+        pointers.push_back(&arg);
+      }
+    }
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        if (inst.getType()->isPointerTy()) {
+          pointers.push_back(&inst);
+        }
+      }
+    }
+  }
+
+  llvm::anderson::AndersonAAResult result { module, reference };
+  llvm::SimpleAAQueryInfo queryInfo;
+  std::vector<llvm::BitVector> expected(pointers.size(), llvm::BitVector(pointers.size()));
+  for (size_t i = 0; i < pointers.size(); ++i) {
+    for (size_t j = 0; j < pointers.size(); ++j) {
+      auto alias = result.alias(llvm::MemoryLocation::getBeforeOrAfter(pointers[i]),
+                                llvm::MemoryLocation::getBeforeOrAfter(pointers[j]), queryInfo);
+      if (i == j || alias != llvm::AliasResult::NoAlias) {
+        expected[i].set(j);
+      }
+    }
+  }
+
+  ++numRuns;
+  auto matrix = result.GetAliasMatrix(pointers);
+  if (matrix != expected) {
+    llvm::errs() << "FAIL alias_matrix on " << name << ": the matrix differs from the pairwise queries\n";
+    ++numFailures;
+  }
+
+  // Number the connected components of the pairwise may-alias relation in the order of their first pointers.
+  std::vector<unsigned> expectedClasses(pointers.size(), std::numeric_limits<unsigned>::max());
+  unsigned numClasses = 0;
+  for (size_t first = 0; first < pointers.size(); ++first) {
+    if (expectedClasses[first] != std::numeric_limits<unsigned>::max()) {
+      continue;
+    }
+    std::vector<size_t> stack { first };
+    expectedClasses[first] = numClasses;
+    while (!stack.empty()) {
+      auto i = stack.back();
+      stack.pop_back();
+      for (auto j : expected[i].set_bits()) {
+        if (expectedClasses[j] == std::numeric_limits<unsigned>::max()) {
+          expectedClasses[j] = numClasses;
+          stack.push_back(j);
+        }
+      }
+    }
+    ++numClasses;
+  }
+
+  ++numRuns;
+  if (result.GetAliasClasses(pointers) != expectedClasses) {
+    llvm::errs() << "FAIL alias_classes on " << name << ": the classes differ from the pairwise queries\n";
+    ++numFailures;
+  }
+}
+
+/**
+ * A change to `IncrementalModule` that the incremental solver should handle without solving from scratch.
+ */
+struct Edit {
+  const char *name;
+  void (*apply)(llvm::Module &module) noexcept;
+};
+
+/**
+ * Functions that pass pointers to each other through global variables, a stack slot and the heap. Only `@main`,
+ * `@put` and `@get` are reachable from `@main`.
+ */
+const char IncrementalModule[] = R"(
+@slot = global i32* null
+@slots = global i32** null
+
+declare i8* @malloc(i64)
+
+define void @put(i32* %p) {
+  store i32* %p, i32** @slot
+  ret void
+}
+
+define i32* @get() {
+  %v = load i32*, i32** @slot
+  ret i32* %v
+}
+
+define void @main() {
+  %a = alloca i32
+  %s = alloca i32*
+  call void @put(i32* %a)
+  %v = call i32* @get()
+  store i32* %v, i32** %s
+  store i32** %s, i32*** @slots
+  ret void
+}
+
+define void @keep() {
+  %k = alloca i32
+  store i32* %k, i32** @slot
+  ret void
+}
+
+define void @drop(i32* %p) {
+  store i32* %p, i32** @slot
+  ret void
+}
+
+define void @stale() {
+  %b = alloca i32
+  call void @put(i32* %b)
+  ret void
+}
+)";
+
+/**
+ * Make `@put` store through the slot found in `@slots` rather than into `@slot`.
+ */
+void EditFunction(llvm::Module &module) noexcept {
+  auto function = module.getFunction("put");
+  auto &entry = function->getEntryBlock();
+  std::vector<llvm::Instruction *> staleInstructions;
+  for (auto &inst : entry) {
+    staleInstructions.push_back(&inst);
+  }
+
+  // Build the new body before erasing the old one, so that no new instruction reuses the address of an old one.
+  llvm::IRBuilder<> builder { &entry };
+  auto slots = module.getNamedGlobal("slots");
+  auto slot = builder.CreateLoad(slots->getValueType(), slots);
+  builder.CreateStore(function->getArg(0), slot);
+  builder.CreateRetVoid();
+  for (auto inst : staleInstructions) {
+    inst->eraseFromParent();
+  }
+}
+
+/**
+ * Add a function that passes a heap object to `@put`.
+ */
+void AddFunction(llvm::Module &module) noexcept {
+  auto &context = module.getContext();
+  auto function = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false), llvm::GlobalValue::ExternalLinkage, "fresh",
+      module);
+  llvm::IRBuilder<> builder { llvm::BasicBlock::Create(context, "entry", function) };
+  auto object = builder.CreateCall(module.getFunction("malloc"), { builder.getInt64(4) });
+  auto pointer = builder.CreateBitCast(object, builder.getInt32Ty()->getPointerTo());
+  builder.CreateCall(module.getFunction("put"), { pointer });
+  builder.CreateRetVoid();
+}
+
+/**
+ * Make `@keep` pass its object to `@drop`. Neither is reachable from `@main`.
+ */
+void EditUnreachableFunction(llvm::Module &module) noexcept {
+  auto function = module.getFunction("keep");
+  auto &entry = function->getEntryBlock();
+  llvm::IRBuilder<> builder { entry.getTerminator() };
+  builder.CreateCall(module.getFunction("drop"), { &entry.front() });
+}
+
+/**
+ * Make `@main` call `@keep`, which then becomes reachable from `@main` together with the functions it calls.
+ */
+void ReachFunction(llvm::Module &module) noexcept {
+  auto &entry = module.getFunction("main")->getEntryBlock();
+  llvm::IRBuilder<> builder { entry.getTerminator() };
+  builder.CreateCall(module.getFunction("keep"));
+}
+
+/**
+ * Remove `@stale`, whose object then no longer reaches `@slot`.
+ */
+void RemoveFunction(llvm::Module &module) noexcept {
+  module.getFunction("stale")->eraseFromParent();
+}
+
+const Edit Edits[] = {
+  { "edit_function", EditFunction },
+  { "add_function", AddFunction },
+  { "edit_unreachable_function", EditUnreachableFunction },
+  { "reach_function", ReachFunction },
+  { "remove_function", RemoveFunction },
+};
+
+/**
+ * Check the reverse points-to index of the specified value tree against the points-to sets: the row of each pointee
+ * lists, in increasing order, exactly the pointers whose sets contain it.
+ */
+bool CheckReverseIndex(const llvm::anderson::ValueTree &valueTree) noexcept {
+  size_t numForwardEdges = 0;
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node || !node->isPointer()) {
+      continue;
+    }
+    for (auto pointee : node->pointer()->GetPointeeSet()) {
+      ++numForwardEdges;
+      auto pointers = valueTree.GetPointersTo(*pointee->node());
+      if (!std::binary_search(pointers.begin(), pointers.end(), static_cast<uint32_t>(id))) {
+        llvm::errs() << "node " << id << " points to node " << pointee->node()->id() << " but is not in its row\n";
+        return false;
+      }
+    }
+  }
+
+  size_t numReverseEdges = 0;
+  for (size_t id = 0; id < valueTree.GetNumNodes(); ++id) {
+    auto node = valueTree.GetNode(id);
+    if (!node) {
+      continue;
+    }
+    auto pointers = valueTree.GetPointersTo(*node);
+    if (!std::is_sorted(pointers.begin(), pointers.end())) {
+      llvm::errs() << "the row of node " << id << " is not sorted\n";
+      return false;
+    }
+    numReverseEdges += pointers.size();
+  }
+  if (numReverseEdges != numForwardEdges) {
+    llvm::errs() << "the reverse index has " << numReverseEdges << " entries for " << numForwardEdges
+                 << " points-to edges\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Solve the specified module like `SolveReference`, with the value tree pruned to the specified entry points if there
+ * are any.
+ */
+std::unique_ptr<llvm::anderson::ValueTree> SolveReference(const llvm::Module &module,
+                                                          const std::vector<std::string> &entryPoints) noexcept {
+  if (entryPoints.empty()) {
+    return llvm::anderson::SolveReference(module);
+  }
+
+  auto reachable = llvm::anderson::ComputeReachableGlobals(module, entryPoints);
+  llvm::anderson::PointsToSolver solver {
+    module,
+    std::make_unique<llvm::anderson::ValueTree>(module, &reachable, llvm::anderson::GetRequestedExternalSummaries())
+  };
+  for (const auto &function : module) {
+    for (const auto &bb : function) {
+      for (const auto &inst : bb) {
+        llvm::anderson::UpdateAndersonSolverOnInst(solver, inst);
+      }
+    }
+  }
+  solver.Solve();
+  return solver.TakeValueTree();
+}
+
+/**
+ * Solve `IncrementalModule`, pruned to the specified entry points if there are any, apply the specified edits one after
+ * another, and check the solution updated by the incremental solver after each edit against the reference solver.
+ */
+void CheckIncrementalEdits(const std::vector<const Edit *> &edits, const std::vector<std::string> &entryPoints,
+                           size_t &numRuns, size_t &numFailures) noexcept {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(IncrementalModule, diagnostic, context);
+  if (!module) {
+    diagnostic.print("incremental", llvm::errs());
+    ++numFailures;
+    return;
+  }
+
+  auto name = std::string { entryPoints.empty() ? "incremental/" : "incremental_entry_points/" };
+  auto valueTree = SolveReference(*module, entryPoints);
+  llvm::anderson::IncrementalSolver incrementalSolver;
+  incrementalSolver.Initialize(*module, *valueTree, entryPoints);
+  valueTree->BuildReverseIndex();
+
+  for (auto edit : edits) {
+    ++numRuns;
+    edit->apply(*module);
+    if (llvm::verifyModule(*module, &llvm::errs())) {
+      llvm::errs() << name << edit->name << ": the edited module is broken\n";
+      ++numFailures;
+      return;
+    }
+
+    valueTree = incrementalSolver.Update(*module, std::move(valueTree));
+    if (!valueTree) {
+      llvm::errs() << "FAIL " << name << edit->name << ": the edit is not handled incrementally\n";
+      ++numFailures;
+      return;
+    }
+    auto reference = SolveReference(*module, entryPoints);
+    if (!llvm::anderson::VerifySolution(*module, *valueTree, *reference, llvm::errs())) {
+      llvm::errs() << "FAIL " << name << edit->name << "\n";
+      ++numFailures;
+    }
+
+    // The index built before the update is either dropped or still matches the updated sets.
+    ++numRuns;
+    if (valueTree->hasReverseIndex() && !CheckReverseIndex(*valueTree)) {
+      llvm::errs() << "FAIL " << name << edit->name << "/stale_reverse_index\n";
+      ++numFailures;
+    }
+    ++numRuns;
+    valueTree->BuildReverseIndex();
+    if (!CheckReverseIndex(*valueTree)) {
+      llvm::errs() << "FAIL " << name << edit->name << "/reverse_index\n";
+      ++numFailures;
+    }
+  }
+}
+
+} // namespace <anonymous>
+
+int main() {
+  size_t numFailures = 0;
+  size_t numRuns = 0;
+  for (const auto &shape : Shapes) {
+    for (auto size : Sizes) {
+      llvm::LLVMContext context;
+      auto module = shape.generator(context, size);
+      if (llvm::verifyModule(*module, &llvm::errs())) {
+        llvm::errs() << shape.name << "/" << size << ": the generated module is broken\n";
+        ++numFailures;
+        continue;
+      }
+
+      auto reference = llvm::anderson::SolveReference(*module);
+      for (const auto &configuration : Configurations) {
+        ++numRuns;
+        auto candidate = configuration.solve(*module);
+        if (!llvm::anderson::VerifySolution(*module, *candidate, *reference, llvm::errs())) {
+          llvm::errs() << "FAIL " << configuration.name << " on " << shape.name << "/" << size << "\n";
+          ++numFailures;
+        }
+
+        ++numRuns;
+        candidate->BuildReverseIndex();
+        if (!CheckReverseIndex(*candidate)) {
+          llvm::errs() << "FAIL " << configuration.name << "/reverse_index on " << shape.name << "/" << size << "\n";
+          ++numFailures;
+        }
+      }
+
+      if (size <= MaxAliasMatrixSize) {
+        CheckAliasMatrix(*module, *reference, std::string { shape.name } + "/" + std::to_string(size), numRuns,
+                         numFailures);
+      }
+
+      if (size >= MinStoppedSolveSize) {
+        CheckStoppedSolve(*module, *reference, std::string { shape.name } + "/" + std::to_string(size), numRuns,
+                          numFailures);
+      }
+
+      if (size <= MaxDemandDrivenSize) {
+        // The smallest modules are too shallow to exhaust the smallest budget.
+        CheckDemandDriven(*module, *reference, std::string { shape.name } + "/" + std::to_string(size), size >= 7,
+                          numRuns, numFailures);
+      }
+    }
+  }
+
+  {
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic diagnostic;
+    auto module = llvm::parseAssemblyString(DemandDrivenModule, diagnostic, context);
+    if (module) {
+      CheckDemandDriven(*module, *llvm::anderson::SolveReference(*module), "indirect_stores", true, numRuns,
+                        numFailures);
+    } else {
+      diagnostic.print("demand_driven", llvm::errs());
+      ++numFailures;
+    }
+  }
+
+  {
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic diagnostic;
+    auto module = llvm::parseAssemblyString(InterproceduralStoresModule, diagnostic, context);
+    if (module) {
+      CheckDemandDriven(*module, *llvm::anderson::SolveReference(*module), "interprocedural_stores", true, numRuns,
+                        numFailures);
+      ++numRuns;
+      if (!CheckDemandDrivenStoreScope(*module)) {
+        llvm::errs() << "FAIL demand_driven/store_scope: the query explores unrelated stores\n";
+        ++numFailures;
+      }
+    } else {
+      diagnostic.print("demand_driven", llvm::errs());
+      ++numFailures;
+    }
+  }
+
+  {
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic diagnostic;
+    auto module = llvm::parseAssemblyString(MemoryCopiesModule, diagnostic, context);
+    if (module) {
+      CheckDemandDriven(*module, *llvm::anderson::SolveReference(*module), "memory_copies", true, numRuns,
+                        numFailures);
+    } else {
+      diagnostic.print("demand_driven", llvm::errs());
+      ++numFailures;
+    }
+  }
+
+  CheckPointsToQuery(numRuns, numFailures);
+  CheckCastCells(numRuns, numFailures);
+
+  // Each edit on its own, then all of them in a row on the same module, on the whole module and on the part reachable
+  // from `@main`.
+  for (const auto &entryPoints : { std::vector<std::string> { }, std::vector<std::string> { "main" } }) {
+    std::vector<const Edit *> allEdits;
+    for (const auto &edit : Edits) {
+      CheckIncrementalEdits({ &edit }, entryPoints, numRuns, numFailures);
+      allEdits.push_back(&edit);
+    }
+    CheckIncrementalEdits(allEdits, entryPoints, numRuns, numFailures);
+  }
+
+  llvm::outs() << numRuns - numFailures << " of " << numRuns << " runs agree with the reference solver\n";
+  return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+; A pointer stored into memory that cannot hold a pointer at the accessed offset is not tracked by the solver, so the
+; pointer reloaded from there must still alias the stored one.
+;
+; RUN: %opt -load-pass-plugin %plugin -aa-pipeline=anderson-aa,basic-aa -passes='require<anderson-aa>,function(gvn)' %s -S | %FileCheck %s --check-prefix=GVN
+; RUN: %opt -load-pass-plugin %plugin -aa-pipeline=anderson-aa -passes='require<anderson-aa>,function(aa-eval)' -print-all-alias-modref-info %s -disable-output 2>&1 | %FileCheck %s --check-prefix=EVAL
+
+define internal void @put(i8** %slot, i8* %v) noinline {
+  store i8* %v, i8** %slot
+  ret void
+}
+
+; GVN-LABEL: define i8 @integer_cell(
+; GVN: ret i8 %r
+; EVAL-LABEL: Function: integer_cell:
+; EVAL-DAG: MayAlias: i8* %x, i8* %y
+; EVAL-DAG: NoAlias: i8* %y, i8* %z
+define i8 @integer_cell() {
+  %cell = alloca i64
+  %x = alloca i8
+  %z = alloca i8
+  %slot = bitcast i64* %cell to i8**
+  call void @put(i8** %slot, i8* %x)
+  %y = load i8*, i8** %slot
+  store i8 1, i8* %x
+  store i8 2, i8* %y
+  store i8 3, i8* %z
+  %r = load i8, i8* %x
+  ret i8 %r
+}
+
+; GVN-LABEL: define i8 @byte_buffer(
+; GVN: ret i8 %r
+; EVAL-LABEL: Function: byte_buffer:
+; EVAL-DAG: MayAlias: i8* %x, i8* %y
+; EVAL-DAG: NoAlias: i8* %y, i8* %z
+define i8 @byte_buffer() {
+  %buf = alloca [8 x i8]
+  %x = alloca i8
+  %z = alloca i8
+  %slot = bitcast [8 x i8]* %buf to i8**
+  call void @put(i8** %slot, i8* %x)
+  %y = load i8*, i8** %slot
+  store i8 1, i8* %x
+  store i8 2, i8* %y
+  store i8 3, i8* %z
+  %r = load i8, i8* %x
+  ret i8 %r
+}
+
+; A pointer stored through a cast to a pointer cell is tracked, and the reloaded pointer keeps its precise object set.
+; GVN-LABEL: define i8 @pointer_cell(
+; GVN: ret i8 2
+; EVAL-LABEL: Function: pointer_cell:
+; EVAL-DAG: NoAlias: i8* %y, i8* %z
+define i8 @pointer_cell() {
+  %cell = alloca i32*
+  %x = alloca i8
+  %z = alloca i8
+  %slot = bitcast i32** %cell to i8**
+  store i8* %x, i8** %slot
+  %y = load i8*, i8** %slot
+  store i8 1, i8* %x
+  store i8 2, i8* %y
+  store i8 3, i8* %z
+  %r = load i8, i8* %y
+  ret i8 %r
+}
@@ -0,0 +1,56 @@
+; Stack objects whose addresses leave through flows the solver does not track must not be classified as no-escape.
+;
+; RUN: %opt -load-pass-plugin %plugin -passes='print<anderson-escape>' %s -disable-output 2>&1 | %FileCheck %s
+
+@g = global i64 0
+@gi = global i64 0
+
+; A pointer stored into a global that cannot hold a pointer, through a constant expression or a cast instruction.
+; CHECK-DAG: store_constant_cast.%x: global-escape
+define void @store_constant_cast() {
+  %x = alloca i8
+  store i8* %x, i8** bitcast (i64* @g to i8**)
+  ret void
+}
+
+; CHECK-DAG: store_cast.%x: global-escape
+define void @store_cast() {
+  %x = alloca i8
+  %p = bitcast i64* @g to i8**
+  store i8* %x, i8** %p
+  ret void
+}
+
+; A pointer copied through memory as an integer.
+; CHECK-DAG: copy_as_integer.%x: global-escape
+; CHECK-DAG: copy_as_integer.%holder: no-escape
+define void @copy_as_integer() {
+  %x = alloca i8
+  %holder = alloca i8*
+  store i8* %x, i8** %holder
+  %h = bitcast i8** %holder to i64*
+  %i = load i64, i64* %h
+  store i64 %i, i64* @gi
+  ret void
+}
+
+; A narrow integer cannot carry the pointer.
+; CHECK-DAG: copy_as_byte.%x: no-escape
+define void @copy_as_byte() {
+  %x = alloca i8
+  %holder = alloca i8*
+  store i8* %x, i8** %holder
+  %h = bitcast i8** %holder to i8*
+  %b = load i8, i8* %h
+  store i8 %b, i8* bitcast (i64* @gi to i8*)
+  ret void
+}
+
+; CHECK-DAG: local.%x: no-escape
+; CHECK-DAG: local.%holder: no-escape
+define void @local() {
+  %x = alloca i8
+  %holder = alloca i8*
+  store i8* %x, i8** %holder
+  ret void
+}
@@ -0,0 +1,42 @@
+; Pointers loaded from memory that an external function may have written to may point to any escaped object, so the
+; functions writing through them may write any escaped object.
+;
+; RUN: %opt -load-pass-plugin %plugin -passes='print<anderson-modref>' %s -disable-output 2>&1 | %FileCheck %s
+
+@gb = global i8 0
+
+declare void @ext(i8** %holder)
+
+; CHECK-DAG: w: mod {{.*}}global:@gb{{.*}}; ref stack:f.%holder
+define internal void @w(i8** %holder) noinline {
+  %p = load i8*, i8** %holder
+  store i8 1, i8* %p
+  ret void
+}
+
+; CHECK-DAG: f: mod *; ref *
+define void @f() {
+  %x = alloca i8
+  %holder = alloca i8*
+  store i8* %x, i8** %holder
+  call void @ext(i8** %holder)
+  call void @w(i8** %holder)
+  ret void
+}
+
+; Memory that never reaches unknown code keeps its precise summary.
+; CHECK-DAG: local_write: mod stack:local.%x; ref stack:local.%holder
+define internal void @local_write(i8** %holder) noinline {
+  %p = load i8*, i8** %holder
+  store i8 1, i8* %p
+  ret void
+}
+
+; CHECK-DAG: local: mod stack:local.%holder stack:local.%x; ref stack:local.%holder
+define void @local() {
+  %x = alloca i8
+  %holder = alloca i8*
+  store i8* %x, i8** %holder
+  call void @local_write(i8** %holder)
+  ret void
+}
@@ -0,0 +1,52 @@
+; Calls to `memcpy` and `memmove` copy the pointers held by the source into the target, field by field, and a copy from
+; an array element covers the rest of the array.
+;
+; RUN: %opt -load-pass-plugin %plugin -passes='print<anderson>' %s -disable-output 2>&1 | %FileCheck %s
+; RUN: %opt -load %plugin -load-pass-plugin %plugin -anderson-worklist-order=fifo -passes='print<anderson>' %s -disable-output 2>&1 | %FileCheck %s
+
+%struct.S = type { i32*, i64, i32* }
+
+declare i8* @memcpy(i8*, i8*, i64)
+declare i8* @memmove(i8*, i8*, i64)
+
+; CHECK-DAG: stack:copy_struct.%dst[0] -> stack:copy_struct.%a
+; CHECK-DAG: stack:copy_struct.%dst[2] -> stack:copy_struct.%b
+; CHECK-DAG: copy_struct.%r -> stack:copy_struct.%dst
+; CHECK-DAG: copy_struct.%x -> stack:copy_struct.%b
+define i32* @copy_struct() {
+  %a = alloca i32
+  %b = alloca i32
+  %src = alloca %struct.S
+  %dst = alloca %struct.S
+  %f0 = getelementptr %struct.S, %struct.S* %src, i64 0, i32 0
+  store i32* %a, i32** %f0
+  %f2 = getelementptr %struct.S, %struct.S* %src, i64 0, i32 2
+  store i32* %b, i32** %f2
+  %d = bitcast %struct.S* %dst to i8*
+  %s = bitcast %struct.S* %src to i8*
+  %r = call i8* @memcpy(i8* %d, i8* %s, i64 24)
+  %g2 = getelementptr %struct.S, %struct.S* %dst, i64 0, i32 2
+  %x = load i32*, i32** %g2
+  ret i32* %x
+}
+
+; CHECK-DAG: stack:copy_array.%dst[0] -> stack:copy_array.%b
+; CHECK-DAG: stack:copy_array.%dst[1] -> stack:copy_array.%a
+; CHECK-DAG: copy_array.%x -> stack:copy_array.%a
+define i32* @copy_array() {
+  %a = alloca i32
+  %b = alloca i32
+  %src = alloca [2 x i32*]
+  %dst = alloca [2 x i32*]
+  %e1 = getelementptr [2 x i32*], [2 x i32*]* %src, i64 0, i64 1
+  store i32* %a, i32** %e1
+  %s0 = getelementptr [2 x i32*], [2 x i32*]* %src, i64 0, i64 0
+  store i32* %b, i32** %s0
+  %d0 = getelementptr [2 x i32*], [2 x i32*]* %dst, i64 0, i64 0
+  %d = bitcast i32** %d0 to i8*
+  %s = bitcast i32** %s0 to i8*
+  %r = call i8* @memmove(i8* %d, i8* %s, i64 16)
+  %d1 = getelementptr [2 x i32*], [2 x i32*]* %dst, i64 0, i64 1
+  %x = load i32*, i32** %d1
+  ret i32* %x
+}
@@ -0,0 +1,31 @@
+; A call to `realloc` returns either the original block, together with its contents, or a fresh block, which is the only
+; block it can return for a NULL argument.
+;
+; RUN: %opt -load-pass-plugin %plugin -passes='print<anderson>' %s -disable-output 2>&1 | %FileCheck %s
+
+declare i8* @malloc(i64)
+declare i8* @realloc(i8*, i64)
+
+; CHECK-DAG: realloc_null.%p -> heap:realloc_null.%p
+; CHECK-DAG: realloc_null.%x -> stack:realloc_null.%a
+define i32* @realloc_null() {
+  %a = alloca i32
+  %p = call i8* @realloc(i8* null, i64 8)
+  %slot = bitcast i8* %p to i32**
+  store i32* %a, i32** %slot
+  %x = load i32*, i32** %slot
+  ret i32* %x
+}
+
+; CHECK-DAG: realloc_block.%r -> heap:realloc_block.%m heap:realloc_block.%r
+; CHECK-DAG: realloc_block.%x -> stack:realloc_block.%a
+define i32* @realloc_block() {
+  %a = alloca i32
+  %m = call i8* @malloc(i64 8)
+  %slot = bitcast i8* %m to i32**
+  store i32* %a, i32** %slot
+  %r = call i8* @realloc(i8* %m, i64 16)
+  %rslot = bitcast i8* %r to i32**
+  %x = load i32*, i32** %rslot
+  ret i32* %x
+}
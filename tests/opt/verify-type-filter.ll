@@ -0,0 +1,16 @@
+; The solution checked by `-verify` is compared with a reference solution computed under the same type filter, so the
+; pointees rejected by the strict filter are not reported as mismatches.
+;
+; RUN: %bindir/llvm-anderson -verify %s
+; RUN: %bindir/llvm-anderson -verify -anderson-type-filter=strict %s
+; RUN: %opt -load %plugin -load-pass-plugin %plugin -anderson-verify -anderson-type-filter=strict -passes='print<anderson>' %s -disable-output 2>&1 | %FileCheck %s
+
+; CHECK-NOT: anderson: verify
+define i32* @store_through_cast() {
+  %o = alloca i32
+  %cell = alloca i64*
+  %slot = bitcast i64** %cell to i32**
+  store i32* %o, i32** %slot
+  %x = load i32*, i32** %slot
+  ret i32* %x
+}
@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+#
+# Run the `RUN:` lines of an opt regression test, in the style of lit.
+#
+# Usage: run-opt-test.sh <opt> <FileCheck> <plugin> <tool-dir> <test.ll>
+#
+# In each `RUN:` line, %opt, %FileCheck and %plugin are replaced by the given tools and pass plugin, %bindir by the
+# directory of the llvm-anderson tools, and %s by the test file. The test fails if any command line fails.
+
+set -e -o pipefail
+
+opt="$1"
+filecheck="$2"
+plugin="$3"
+bindir="$4"
+test="$5"
+
+grep '^; RUN: ' "$test" | sed -e 's/^; RUN: //' | while IFS= read -r line; do
+  command="${line//%opt/$opt}"
+  command="${command//%FileCheck/$filecheck}"
+  command="${command//%plugin/$plugin}"
+  command="${command//%bindir/$bindir}"
+  command="${command//%s/$test}"
+  echo "RUN: $command"
+  bash -e -o pipefail -c "$command"
+done
@@ -0,0 +1,78 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/ConstraintSummary.h"
+
+#include <string>
+#include <system_error>
+
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace {
+
+llvm::cl::list<std::string> InputFiles { // NOLINT(cert-err58-cpp)
+  llvm::cl::Positional,
+  llvm::cl::desc("<summary or IR files>"),
+  llvm::cl::OneOrMore
+};
+
+llvm::cl::opt<std::string> OutputFile { // NOLINT(cert-err58-cpp)
+  "o",
+  llvm::cl::desc("Output file of the solved points-to relation"),
+  llvm::cl::value_desc("path"),
+  llvm::cl::init("-")
+};
+
+} // namespace <anonymous>
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM init { argc, argv };
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Link the constraint summaries written by -anderson-summary-out and solve the whole program.\n"
+      "IR files are summarized on the fly, loading one function body at a time.\n");
+
+  llvm::anderson::SummaryLinker linker { };
+  for (const auto &inputFile : InputFiles) {
+    auto buffer = llvm::MemoryBuffer::getFile(inputFile);
+    if (!buffer) {
+      llvm::errs() << argv[0] << ": cannot open " << inputFile << ": " << buffer.getError().message() << "\n";
+      return 1;
+    }
+
+    if (!llvm::anderson::ConstraintSummary::IsSummary((*buffer)->getMemBufferRef())) {
+      buffer->reset();
+      llvm::SMDiagnostic diagnostic;
+      if (!linker.LinkIRFile(inputFile, diagnostic)) {
+        diagnostic.print(argv[0], llvm::errs());
+        return 1;
+      }
+      continue;
+    }
+
+    auto summary = llvm::anderson::ConstraintSummary::Read((*buffer)->getMemBufferRef());
+    if (!summary) {
+      llvm::errs() << argv[0] << ": cannot read constraint summary " << inputFile << "\n";
+      return 1;
+    }
+    linker.Link(*summary);
+  }
+
+  linker.Solve();
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os { OutputFile, ec, llvm::sys::fs::OF_Text };
+  if (ec) {
+    llvm::errs() << argv[0] << ": cannot open " << OutputFile << ": " << ec.message() << "\n";
+    return 1;
+  }
+  linker.Print(os);
+
+  return 0;
+}
@@ -0,0 +1,411 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "llvm-anderson/AndersonPointsToAnalysis.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/Signals.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
+
+#ifdef LLVM_ON_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "PointsToSolver.h"
+#include "SolverVerifier.h"
+
+namespace {
+
+llvm::cl::list<std::string> InputFiles { // NOLINT(cert-err58-cpp)
+  llvm::cl::Positional,
+  llvm::cl::desc("<IR files>"),
+  llvm::cl::OneOrMore
+};
+
+using llvm::anderson::SolverMode;
+
+llvm::cl::opt<SolverMode> Mode { // NOLINT(cert-err58-cpp)
+  "mode",
+  llvm::cl::desc("Solver mode. Defaults to worklist if -anderson-worklist-order is given and to partitioned with "
+                 "-anderson-steensgaard"),
+  llvm::cl::values(
+      clEnumValN(SolverMode::Exhaustive, "exhaustive", "Relax all pointers in rounds until a fixpoint is reached"),
+      clEnumValN(SolverMode::Worklist, "worklist", "Relax the pointers whose operands have changed"),
+      clEnumValN(SolverMode::Partitioned, "partitioned",
+                 "Split the constraints into independent regions by unification and solve each with the worklist")),
+  llvm::cl::init(SolverMode::Exhaustive)
+};
+
+llvm::cl::opt<unsigned> Threads { // NOLINT(cert-err58-cpp)
+  "j",
+  llvm::cl::desc("Number of input files analyzed in parallel; heap deltas are process-wide if more than 1"),
+  llvm::cl::value_desc("threads"),
+  llvm::cl::init(1)
+};
+
+llvm::cl::opt<bool> PrintPointsTo { // NOLINT(cert-err58-cpp)
+  "print-pts",
+  llvm::cl::desc("Print the points-to set of every pointer after solving"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<bool> TimeTrace { // NOLINT(cert-err58-cpp)
+  "time-trace",
+  llvm::cl::desc("Record a Chrome trace of the analysis phases"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<unsigned> TimeTraceGranularity { // NOLINT(cert-err58-cpp)
+  "time-trace-granularity",
+  llvm::cl::desc("Minimum duration in microseconds of the events recorded in the trace"),
+  llvm::cl::init(500)
+};
+
+llvm::cl::opt<std::string> TimeTraceFile { // NOLINT(cert-err58-cpp)
+  "time-trace-file",
+  llvm::cl::desc("Output file of the trace; defaults to llvm-anderson.time-trace"),
+  llvm::cl::value_desc("filename"),
+  llvm::cl::init("")
+};
+
+llvm::cl::opt<bool> Progress { // NOLINT(cert-err58-cpp)
+  "progress",
+  llvm::cl::desc("Report the progress of the analysis on stderr"),
+  llvm::cl::init(false)
+};
+
+llvm::cl::opt<bool> Verify { // NOLINT(cert-err58-cpp)
+  "verify",
+  llvm::cl::desc("Check the solution against the reference solver and report a counterexample on a mismatch"),
+  llvm::cl::init(false)
+};
+
+/**
+ * Set if the solution of any input file differs from the reference solution.
+ */
+std::atomic<bool> VerificationFailed { false }; // NOLINT(cert-err58-cpp)
+
+/**
+ * Cancelled on the first interrupt signal, so that the analyses in flight stop at their next poll and the reports of
+ * the finished ones are still printed.
+ */
+llvm::anderson::CancellationToken Interrupted; // NOLINT(cert-err58-cpp)
+
+std::mutex ProgressMutex; // NOLINT(cert-err58-cpp)
+
+/**
+ * Prints the progress reports of the analysis of a single input file.
+ */
+class ProgressPrinter : public llvm::anderson::SolverProgressObserver {
+public:
+  explicit ProgressPrinter(const std::string &inputFile) noexcept
+    : _inputFile(inputFile)
+  { }
+
+  void OnProgress(const llvm::anderson::SolverProgress &progress) noexcept override {
+    std::lock_guard<std::mutex> lock { ProgressMutex };
+    llvm::errs() << "llvm-anderson: " << _inputFile << ": " << llvm::anderson::GetSolverPhaseName(progress.phase);
+    if (progress.phase == llvm::anderson::SolverPhase::Solve) {
+      llvm::errs() << ", iteration " << progress.iteration << ", worklist " << progress.worklistSize
+                   << ", constraints relaxed " << progress.constraintsProcessed
+                   << ", remaining >= " << progress.estimatedRemaining;
+    }
+    llvm::errs() << "\n";
+  }
+
+private:
+  const std::string &_inputFile;
+};
+
+struct Phase {
+  const char *name;
+  double milliseconds;
+  int64_t heapDelta;
+};
+
+/**
+ * Measures the wall time and the heap growth of the phases of the analysis, as reported by the solver, and forwards the
+ * progress reports to another observer.
+ */
+class PhaseTimer : public llvm::anderson::SolverProgressObserver {
+public:
+  explicit PhaseTimer(llvm::anderson::SolverProgressObserver *next) noexcept
+    : _next(next),
+      _phases(),
+      _phase(llvm::anderson::SolverPhase::BuildValueTree),
+      _start(std::chrono::steady_clock::now()),
+      _heap(static_cast<int64_t>(llvm::sys::Process::GetMallocUsage()))
+  { }
+
+  void OnProgress(const llvm::anderson::SolverProgress &progress) noexcept override {
+    if (_next) {
+      _next->OnProgress(progress);
+    }
+    // The partitioned solver reports a solve and a done phase for every region, so the solve phase only ends when the
+    // analysis returns.
+    if (progress.phase > _phase && progress.phase != llvm::anderson::SolverPhase::Done) {
+      EndPhase(llvm::anderson::GetSolverPhaseName(_phase));
+      _phase = progress.phase;
+    }
+  }
+
+  void EndPhase(const char *name) noexcept {
+    auto now = std::chrono::steady_clock::now();
+    auto heap = static_cast<int64_t>(llvm::sys::Process::GetMallocUsage());
+    _phases.push_back(Phase {
+      name,
+      std::chrono::duration<double, std::milli>(now - _start).count(),
+      heap - _heap
+    });
+    _start = now;
+    _heap = heap;
+  }
+
+  /**
+   * End the phase the analysis is in.
+   */
+  void EndAnalysis() noexcept {
+    EndPhase(llvm::anderson::GetSolverPhaseName(_phase));
+  }
+
+  /**
+   * Get the last phase the analysis has entered.
+   */
+  llvm::anderson::SolverPhase phase() const noexcept {
+    return _phase;
+  }
+
+  const std::vector<Phase>& phases() const noexcept {
+    return _phases;
+  }
+
+private:
+  llvm::anderson::SolverProgressObserver *_next;
+  std::vector<Phase> _phases;
+  llvm::anderson::SolverPhase _phase;
+  std::chrono::steady_clock::time_point _start;
+  int64_t _heap;
+};
+
+void PrintCounts(llvm::raw_ostream &os, const llvm::Module &module, llvm::anderson::ValueTree &valueTree) noexcept {
+  size_t numFunctions = 0;
+  size_t numInstructions = 0;
+  for (const auto &function : module) {
+    if (function.isDeclaration()) {
+      continue;
+    }
+    ++numFunctions;
+    numInstructions += function.getInstructionCount();
+  }
+
+  size_t numAddressOf = 0;
+  size_t numElementPtr = 0;
+  size_t numLoads = 0;
+  size_t numStores = 0;
+  size_t numCopies = 0;
+  size_t numPointsToFacts = 0;
+  size_t numUnknownPointers = 0;
+  valueTree.Visit([&](llvm::anderson::ValueTreeNode &node) noexcept -> bool {
+    if (node.isPointer()) {
+      auto pointer = node.pointer();
+      numAddressOf += pointer->GetNumAssignedAddressOf();
+      numElementPtr += pointer->GetNumAssignedElementPtr();
+      numLoads += pointer->GetNumAssignedPointee();
+      numStores += pointer->GetNumPointeeAssigned();
+      numCopies += pointer->GetNumPointeeCopied();
+      numPointsToFacts += pointer->GetPointeeSet().size();
+      numUnknownPointers += pointer->isUnknown();
+    }
+    return true;
+  });
+
+  os << "  functions " << numFunctions << ", instructions " << numInstructions << "\n";
+  os << "  nodes " << valueTree.GetNumNodes() << ", pointers " << valueTree.GetNumPointers()
+     << ", pointees " << valueTree.GetNumPointees() << "\n";
+  os << "  constraints: address-of " << numAddressOf << ", assign " << numElementPtr << ", load " << numLoads
+     << ", store " << numStores << ", copy " << numCopies << "\n";
+  os << "  points-to facts " << numPointsToFacts << "\n";
+  if (valueTree.isDegraded()) {
+    os << (Interrupted.isCancelled() ? "  cancelled" : "  budget exceeded") << ", unknown pointers "
+       << numUnknownPointers << "\n";
+  } else if (valueTree.isApproximate()) {
+    os << "  budget exceeded, some regions approximated by unification\n";
+  }
+}
+
+/**
+ * Analyze a single input file and return the report.
+ *
+ * @param inputFile path to the input file.
+ * @param errors receives the diagnostics if the input file cannot be read or parsed.
+ * @return the report, or an empty string if the input file cannot be read or parsed.
+ */
+std::string AnalyzeFile(const std::string &inputFile, std::string &errors) noexcept {
+  std::string report;
+  llvm::raw_string_ostream os { report };
+  os << inputFile << "\n";
+  llvm::TimeTraceScope timeScope { "AndersonFile", inputFile };
+
+  ProgressPrinter progress { inputFile };
+  PhaseTimer timer { Progress ? &progress : nullptr };
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseIRFile(inputFile, diagnostic, context);
+  if (!module) {
+    llvm::raw_string_ostream errorStream { errors };
+    diagnostic.print("llvm-anderson", errorStream);
+    return std::string { };
+  }
+  timer.EndPhase("parse");
+
+  auto mode = Mode.getNumOccurrences() ? Mode.getValue() : llvm::anderson::GetRequestedSolverMode();
+  auto valueTree = llvm::anderson::SolveRequestedModule(*module, mode, false, &timer, &Interrupted);
+  timer.EndAnalysis();
+
+  os << llvm::format("  %-12s %12s %14s\n", static_cast<const char *>("phase"),
+                     static_cast<const char *>("time (ms)"), static_cast<const char *>("heap (KiB)"));
+  double totalMilliseconds = 0;
+  int64_t totalHeapDelta = 0;
+  for (const auto &phase : timer.phases()) {
+    os << llvm::format("  %-12s %12.3f %+14lld\n", phase.name, phase.milliseconds,
+                       static_cast<long long>(phase.heapDelta / 1024));
+    totalMilliseconds += phase.milliseconds;
+    totalHeapDelta += phase.heapDelta;
+  }
+  os << llvm::format("  %-12s %12.3f %+14lld\n", static_cast<const char *>("total"), totalMilliseconds,
+                     static_cast<long long>(totalHeapDelta / 1024));
+
+  if (timer.phase() == llvm::anderson::SolverPhase::BuildValueTree && !Interrupted.isCancelled()) {
+    os << "  solution loaded from the cache\n";
+  }
+  PrintCounts(os, *module, *valueTree);
+
+  if (Verify) {
+    auto reference = llvm::anderson::SolveReference(*module);
+    if (llvm::anderson::VerifySolution(*module, *valueTree, *reference, os)) {
+      os << "  verified against the reference solver\n";
+    } else {
+      VerificationFailed = true;
+    }
+  }
+
+  if (PrintPointsTo) {
+    llvm::anderson::AndersonPointsToResult result { std::move(valueTree) };
+    result.print(os, *module);
+  }
+
+  return os.str();
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM init { argc, argv };
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Run the Anderson points-to analysis on IR files and report the time and memory spent in each phase.\n");
+
+  if (llvm::anderson::IsProfileRequested() && InputFiles.size() > 1) {
+    llvm::errs() << "llvm-anderson: a profile can only be written for a single input file\n";
+    return 1;
+  }
+  if (Mode.getNumOccurrences() && Mode == SolverMode::Exhaustive && llvm::anderson::IsWorklistOrderRequested()) {
+    llvm::errs() << "llvm-anderson: the exhaustive solver has no worklist, -anderson-worklist-order has no effect\n";
+    return 1;
+  }
+
+  if (TimeTrace) {
+    llvm::timeTraceProfilerInitialize(TimeTraceGranularity, argv[0]);
+  }
+
+  llvm::sys::SetInterruptFunction([]() {
+    Interrupted.Cancel();
+  });
+
+  std::vector<std::string> reports(InputFiles.size());
+  std::vector<std::string> errors(InputFiles.size());
+  std::atomic<size_t> nextFile { 0 };
+  auto worker = [&reports, &errors, &nextFile]() noexcept {
+    for (auto i = nextFile++; i < InputFiles.size(); i = nextFile++) {
+      if (Interrupted.isCancelled()) {
+        reports[i] = InputFiles[i] + "\n  cancelled\n";
+        continue;
+      }
+      reports[i] = AnalyzeFile(InputFiles[i], errors[i]);
+    }
+  };
+
+  auto numThreads = std::max(1U, std::min(Threads.getValue(), static_cast<unsigned>(InputFiles.size())));
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads; ++i) {
+    threads.emplace_back([&worker, argv]() noexcept {
+      // The profiler records the events of every thread separately, and merges them when the thread finishes.
+      if (TimeTrace) {
+        llvm::timeTraceProfilerInitialize(TimeTraceGranularity, argv[0]);
+      }
+      worker();
+      if (TimeTrace) {
+        llvm::timeTraceProfilerFinishThread();
+      }
+    });
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (TimeTrace) {
+    if (auto error = llvm::timeTraceProfilerWrite(TimeTraceFile, "llvm-anderson")) {
+      llvm::errs() << "llvm-anderson: cannot write time trace: " << llvm::toString(std::move(error)) << "\n";
+    }
+    llvm::timeTraceProfilerCleanup();
+  }
+
+  auto inputFailed = false;
+  for (const auto &error : errors) {
+    llvm::errs() << error;
+    inputFailed |= !error.empty();
+  }
+  for (const auto &report : reports) {
+    llvm::outs() << report;
+  }
+
+  if (llvm::AreStatisticsEnabled()) {
+    // LLVM only prints the statistics on exit if it has been built with assertions, so print them here and reset them.
+    llvm::outs() << "statistics\n";
+    for (const auto &statistic : llvm::GetStatistics()) {
+      llvm::outs() << llvm::format("  %-28s %12llu\n", statistic.first.str().c_str(),
+                                   static_cast<unsigned long long>(statistic.second));
+    }
+    llvm::ResetStatistics();
+  }
+
+#ifdef LLVM_ON_UNIX
+  struct rusage usage { };
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    llvm::outs() << "peak RSS " << usage.ru_maxrss << " KiB\n";
+  }
+#endif
+
+  return inputFailed || Interrupted.isCancelled() || VerificationFailed ? 1 : 0;
+}